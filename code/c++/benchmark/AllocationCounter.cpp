@@ -0,0 +1,80 @@
+#include "AllocationCounter.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// The replacements of the global operator new and delete live in their own translation unit, so
+// that the compiler does not pair the calls of the others with std::malloc() and std::free().
+
+/**
+ * @brief Number of heap allocations performed by the process so far.
+ */
+static std::atomic<std::uint64_t> processAllocations{0};
+
+/**
+ * @brief Number of heap allocations performed by the calling thread so far.
+ */
+static thread_local std::uint64_t threadAllocations = 0;
+
+/**
+ * @brief Count an allocation, of the process and of the calling thread.
+ */
+static void
+countAllocation() {
+    processAllocations.fetch_add(1, std::memory_order_relaxed);
+    threadAllocations++;
+}
+
+std::uint64_t
+heapAllocations() {
+    return processAllocations.load(std::memory_order_relaxed);
+}
+
+std::uint64_t
+threadHeapAllocations() {
+    return threadAllocations;
+}
+
+void *
+operator new(std::size_t size) {
+    countAllocation();
+        if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+            return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *
+operator new(std::size_t size, std::align_val_t alignment) {
+    countAllocation();
+    const std::size_t align  = static_cast<std::size_t>(alignment);
+    // std::aligned_alloc() requires a size multiple of the alignment.
+    const std::size_t padded = (std::max<std::size_t>(size, 1) + align - 1) / align * align;
+        if (void *ptr = std::aligned_alloc(align, padded)) {
+            return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void
+operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void
+operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void
+operator delete(void *ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void
+operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
@@ -0,0 +1,21 @@
+#ifndef ALLOCATION_COUNTER_HPP
+#define ALLOCATION_COUNTER_HPP
+
+#include <cstdint>
+
+/**
+ * @brief Get the number of heap allocations performed by the process so far, counted by the
+ * replacements of the global operator new in AllocationCounter.cpp, which every executable that
+ * calls it links.
+ */
+std::uint64_t
+heapAllocations();
+
+/**
+ * @brief Get the number of heap allocations performed by the calling thread so far, see
+ * heapAllocations().
+ */
+std::uint64_t
+threadHeapAllocations();
+
+#endif
@@ -0,0 +1,275 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Keep the compiler from optimizing away the computation of value, or the writes to the
+ * memory it points to.
+ */
+template <typename T>
+inline void
+doNotOptimize(const T &value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+/**
+ * @brief Timer of a benchmark, handed to the benchmarked function.
+ * @details The function performs getIterations() repetitions of the measured operation, and
+ * brackets with resumeTiming() and pauseTiming() the parts to be measured, so that the setup of
+ * every repetition can be excluded.
+ */
+class BenchmarkState {
+  public:
+    /**
+     * @brief Construct a paused timer for the given number of repetitions.
+     */
+    explicit BenchmarkState(const std::uint64_t &iterations_) : iterations(iterations_) {}
+
+    /**
+     * @brief Get the number of repetitions of the measured operation to perform.
+     */
+    std::uint64_t
+    getIterations() const {
+        return iterations;
+    }
+
+    /**
+     * @brief Start measuring.
+     */
+    void
+    resumeTiming() {
+        start = clock::now();
+    }
+
+    /**
+     * @brief Stop measuring, and add the time since resumeTiming() to the elapsed time.
+     */
+    void
+    pauseTiming() {
+        elapsed += clock::now() - start;
+    }
+
+    /**
+     * @brief Get the measured time, in nanoseconds.
+     */
+    double
+    getElapsed() const {
+        return std::chrono::duration<double, std::nano>(elapsed).count();
+    }
+
+  private:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Number of repetitions of the measured operation.
+     */
+    std::uint64_t iterations;
+
+    /**
+     * @brief Time of the last resumeTiming().
+     */
+    clock::time_point start;
+
+    /**
+     * @brief Time measured so far.
+     */
+    clock::duration elapsed{0};
+};
+
+/**
+ * @brief A benchmark: a function to measure, and the work it does at every repetition.
+ */
+struct Benchmark {
+    /**
+     * @brief Name of the benchmark, e.g. "run/double/rosenbrock/1000/10".
+     */
+    std::string name;
+
+    /**
+     * @brief Function to measure, see BenchmarkState.
+     */
+    std::function<void(BenchmarkState &)> function;
+
+    /**
+     * @brief Number of velocity and position updates of a particle (along all the dimensions) at
+     * every repetition, or 0 if the benchmark does not update particles.
+     */
+    double particleUpdates = 0;
+
+    /**
+     * @brief Number of evaluations of the function to minimize at every repetition, or 0 if the
+     * benchmark does not evaluate it.
+     */
+    double evaluations = 0;
+};
+
+/**
+ * @brief Measurements of a benchmark.
+ */
+struct BenchmarkResult {
+    /**
+     * @brief The benchmark measured.
+     */
+    const Benchmark *benchmark;
+
+    /**
+     * @brief Number of repetitions of the measured operation in every run of the benchmark.
+     */
+    std::uint64_t iterations;
+
+    /**
+     * @brief Time of a repetition measured by every run of the benchmark, in nanoseconds.
+     */
+    std::vector<double> times;
+};
+
+/**
+ * @brief Options of runBenchmark().
+ */
+struct BenchmarkOptions {
+    /**
+     * @brief Minimum time, in seconds, measured by every run of a benchmark: the number of
+     * repetitions is increased until it is reached.
+     */
+    double minTime = 0.1;
+
+    /**
+     * @brief Number of runs of every benchmark, whose times are summarized by their median, mean,
+     * minimum and standard deviation.
+     */
+    unsigned int repetitions = 3;
+
+    /**
+     * @brief Only the benchmarks whose name contains filter are run.
+     */
+    std::string filter = "";
+};
+
+/**
+ * @brief Run a benchmark as many times as required by the options.
+ * @details The number of repetitions is first grown, as Google Benchmark does, until a run
+ * measures at least minTime (which also warms up the caches and the branch predictors), and then
+ * every run performs that number of repetitions.
+ */
+inline BenchmarkResult
+runBenchmark(const Benchmark &benchmark, const BenchmarkOptions &options) {
+    const double  minTime    = options.minTime * 1e9;
+    std::uint64_t iterations = 1;
+        while (true) {
+            BenchmarkState state(iterations);
+            benchmark.function(state);
+            const double elapsed = state.getElapsed();
+                if (elapsed >= minTime || iterations >= 1000000000) {
+                    break;
+            }
+            // Aim 40% above the minimum, growing at most 10 times per step.
+            const double target =
+                elapsed > 0 ? std::ceil(iterations * minTime * 1.4 / elapsed) : 10.0 * iterations;
+            iterations = std::max(iterations + 1,
+                                  static_cast<std::uint64_t>(std::min(target, 10.0 * iterations)));
+        }
+
+    BenchmarkResult result{&benchmark, iterations, {}};
+        for (unsigned int r = 0; r < std::max(options.repetitions, 1u); r++) {
+            BenchmarkState state(iterations);
+            benchmark.function(state);
+            result.times.push_back(state.getElapsed() / iterations);
+        }
+    return result;
+}
+
+/**
+ * @brief Summary of the times of a benchmark.
+ */
+struct BenchmarkSummary {
+    /**
+     * @brief Median of the times.
+     */
+    double median;
+    /**
+     * @brief Mean of the times.
+     */
+    double mean;
+    /**
+     * @brief Smallest of the times.
+     */
+    double min;
+    /**
+     * @brief Sample standard deviation of the times.
+     */
+    double stddev;
+
+    /**
+     * @brief Summarize the given times.
+     */
+    explicit BenchmarkSummary(std::vector<double> times) {
+        std::sort(times.begin(), times.end());
+        const std::size_t n = times.size();
+        median = n % 2 ? times[n / 2] : (times[n / 2 - 1] + times[n / 2]) / 2;
+        mean   = 0;
+            for (const double &t : times) {
+                mean += t / n;
+            }
+        min    = times.front();
+        stddev = 0;
+            for (const double &t : times) {
+                stddev += (t - mean) * (t - mean);
+            }
+        stddev = n > 1 ? std::sqrt(stddev / (n - 1)) : 0;
+    }
+};
+
+/**
+ * @brief Write the results as JSON, in the layout of Google Benchmark: a "context" object with
+ * the given key-value pairs, and a "benchmarks" array with one object per benchmark.
+ * @details Times are per repetition of the measured operation, in nanoseconds; the derived rates
+ * are computed from the median time.
+ */
+inline void
+writeBenchmarksJSON(std::ostream                                           &out,
+                    const std::vector<std::pair<std::string, std::string>> &context,
+                    const std::vector<BenchmarkResult>                     &results) {
+    out << std::setprecision(6) << "{\n  \"context\": {";
+        for (std::size_t i = 0; i < context.size(); i++) {
+            out << (i ? "," : "") << "\n    \"" << context[i].first << "\": \"" << context[i].second
+                << "\"";
+        }
+    out << "\n  },\n  \"benchmarks\": [";
+        for (std::size_t i = 0; i < results.size(); i++) {
+            const Benchmark       &benchmark = *results[i].benchmark;
+            const BenchmarkSummary summary(results[i].times);
+            out << (i ? "," : "") << "\n    {\n";
+            out << "      \"name\": \"" << benchmark.name << "\",\n";
+            out << "      \"iterations\": " << results[i].iterations << ",\n";
+            out << "      \"repetitions\": " << results[i].times.size() << ",\n";
+            out << "      \"time_unit\": \"ns\",\n";
+            out << "      \"real_time\": " << summary.median << ",\n";
+            out << "      \"real_time_mean\": " << summary.mean << ",\n";
+            out << "      \"real_time_min\": " << summary.min << ",\n";
+            out << "      \"real_time_stddev\": " << summary.stddev;
+                if (benchmark.particleUpdates > 0) {
+                    out << ",\n      \"ns_per_particle_update\": "
+                        << summary.median / benchmark.particleUpdates;
+            }
+                if (benchmark.evaluations > 0) {
+                    out << ",\n      \"evaluations_per_second\": "
+                        << benchmark.evaluations * 1e9 / summary.median;
+            }
+            out << "\n    }";
+        }
+    out << "\n  ]\n}\n";
+}
+
+#endif
@@ -0,0 +1,312 @@
+#include "AllocationCounter.hpp"
+#include "BatchSolver.hpp"
+#include "FixedFunctions.hpp"
+#include "FixedPoint.hpp"
+#include "Functions.hpp"
+#include "Islands.hpp"
+#include "PSO.hpp"
+#include "Trajectory.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Number of iterations of every checked run.
+ */
+constexpr unsigned int runIterations = 100;
+
+/**
+ * @brief Inertia weight, cognitive and social coefficients of every checked run, as in main.cpp.
+ */
+constexpr double runW = 0.75, runC = 1.0, runS = 1.0;
+
+/**
+ * @brief Lowest and highest number of heap allocations of the process seen by the evaluations of a
+ * run, whose difference is the number of allocations performed by its iterations.
+ */
+class AllocationWindow {
+  public:
+    /**
+     * @brief Start recording the evaluations.
+     */
+    void
+    arm() {
+        armed.store(true, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Stop recording the evaluations.
+     */
+    void
+    disarm() {
+        armed.store(false, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Record the number of heap allocations of the process at the beginning of an
+     * evaluation, from any thread.
+     */
+    void
+    record() {
+            if (!armed.load(std::memory_order_relaxed)) {
+                return;
+        }
+        const std::uint64_t count   = heapAllocations();
+        std::uint64_t       lowest  = first.load(std::memory_order_relaxed);
+        std::uint64_t       highest = last.load(std::memory_order_relaxed);
+            while (count < lowest &&
+                   !first.compare_exchange_weak(lowest, count, std::memory_order_relaxed)) {
+            }
+            while (count > highest &&
+                   !last.compare_exchange_weak(highest, count, std::memory_order_relaxed)) {
+            }
+    }
+
+    /**
+     * @brief Get the number of heap allocations between the first and the last recorded
+     * evaluation.
+     */
+    std::uint64_t
+    getAllocations() const {
+        const std::uint64_t lowest  = first.load(std::memory_order_relaxed);
+        const std::uint64_t highest = last.load(std::memory_order_relaxed);
+        return highest > lowest ? highest - lowest : 0;
+    }
+
+  private:
+    /**
+     * @brief Whether the evaluations are recorded.
+     */
+    std::atomic<bool> armed{false};
+    /**
+     * @brief Lowest count seen.
+     */
+    std::atomic<std::uint64_t> first{std::numeric_limits<std::uint64_t>::max()};
+    /**
+     * @brief Highest count seen.
+     */
+    std::atomic<std::uint64_t> last{0};
+};
+
+/**
+ * @brief Batch function to minimize that records every call in an AllocationWindow, and then
+ * evaluates func.
+ */
+template <typename Objective>
+struct Watched {
+    /**
+     * @brief Function to minimize.
+     */
+    Objective func;
+    /**
+     * @brief Window recording the calls.
+     */
+    AllocationWindow *window;
+
+    template <typename View, typename Scalar>
+    void
+    operator()(const View &x, Scalar *out, const SimdLevel &level) const {
+        window->record();
+            if constexpr (std::is_invocable_v<const Objective &,
+                                              const View &,
+                                              Scalar *,
+                                              const SimdLevel &>) {
+                func(x, out, level);
+            } else {
+                func(x, out);
+            }
+    }
+};
+
+/**
+ * @brief Count the heap allocations performed by the iterations of a run of 1000 particles in 10
+ * dimensions, between its first and its last evaluation, once configure(pso) selected the
+ * features to check.
+ */
+template <typename Scalar, typename Objective, typename Configure>
+std::uint64_t
+countRunAllocations(const Objective     &func,
+                    const ExecutionMode &mode,
+                    const unsigned int  &numThreads,
+                    const Configure     &configure) {
+    AllocationWindow                                   window;
+    PSO<Scalar, dynamicDimensions, Watched<Objective>> pso(1000,
+                                                           10,
+                                                           Watched<Objective>{func, &window},
+                                                           Scalar{5.0},
+                                                           Scalar{-5.0},
+                                                           Scalar{runW},
+                                                           Scalar{runC},
+                                                           Scalar{runS},
+                                                           runIterations,
+                                                           numThreads);
+    pso.setExecutionMode(mode);
+    configure(pso);
+    pso.initializeParticles();
+    window.arm();
+    pso.run();
+    window.disarm();
+    return window.getAllocations();
+}
+
+/**
+ * @brief Count the heap allocations performed by the iterations of 100 problems of 100 particles
+ * in 2 dimensions solved by a BatchSolver, between the first and the last evaluation of solve().
+ */
+template <typename Scalar, typename Objective>
+std::uint64_t
+countBatchAllocations(const Objective &func, const unsigned int &numThreads) {
+    AllocationWindow                           window;
+    const std::vector<BatchProblem<Scalar>>    problems(100,
+                                                        BatchProblem<Scalar>{Scalar{-5.0},
+                                                                             Scalar{5.0},
+                                                                             Scalar{runW},
+                                                                             Scalar{runC},
+                                                                             Scalar{runS}});
+    BatchSolver<Scalar, 2, Watched<Objective>> solver(
+        problems, 100, 2, Watched<Objective>{func, &window}, runIterations, numThreads);
+    window.arm();
+    solver.solve();
+    window.disarm();
+    return window.getAllocations();
+}
+
+/**
+ * @brief Count the heap allocations performed by the iterations of 4 islands of 250 particles in
+ * 10 dimensions, each one on its own thread, between the progress callbacks of the iterations of
+ * the same epoch: the migrations between the epochs are not checked.
+ */
+template <typename Scalar, typename Objective>
+std::uint64_t
+countIslandAllocations(const Objective &func) {
+    const unsigned int                            interval = 10;
+    Islands<Scalar, dynamicDimensions, Objective> islands(4,
+                                                          250,
+                                                          10,
+                                                          func,
+                                                          Scalar{5.0},
+                                                          Scalar{-5.0},
+                                                          Scalar{runW},
+                                                          Scalar{runC},
+                                                          Scalar{runS},
+                                                          runIterations);
+    islands.setMigration(interval, 2);
+    std::atomic<std::uint64_t> allocations{0};
+        for (unsigned int i = 0; i < islands.getNumIslands(); i++) {
+            // Every island calls its callback on its own thread.
+            std::uint64_t last = 0;
+            islands.getIsland(i).setProgressCallback(
+                [&allocations, interval, last](const auto &progress) mutable {
+                    const std::uint64_t count = threadHeapAllocations();
+                        if (progress.iteration % interval != 0) {
+                            allocations.fetch_add(count - last, std::memory_order_relaxed);
+                    }
+                    last = count;
+                },
+                1);
+        }
+    islands.initializeParticles();
+    islands.run();
+    return allocations.load();
+}
+
+/**
+ * @brief Number of checks that failed.
+ */
+int failures = 0;
+
+/**
+ * @brief Print the number of allocations of the check name, which fails unless it is 0.
+ */
+void
+check(const std::string &name, const std::uint64_t &allocations) {
+    std::cout << name << ": " << allocations << " allocations" << std::endl;
+        if (allocations != 0) {
+            failures++;
+    }
+}
+
+/**
+ * @brief Check the runs of the arithmetic type Scalar, minimizing func, with every feature that
+ * run() may use.
+ */
+template <typename Scalar, typename Objective>
+void
+checkRuns(const std::string &type, const Objective &func) {
+    using Swarm = PSO<Scalar, dynamicDimensions, Watched<Objective>>;
+        for (const unsigned int numThreads : {1u, 3u}) {
+            const std::string suffix = type + "/" + std::to_string(numThreads) + " threads";
+                for (const Topology topology :
+                     {Topology::Global, Topology::Ring, Topology::VonNeumann, Topology::RandomK}) {
+                    check("sync/" + std::string(topologyName(topology)) + "/" + suffix,
+                          countRunAllocations<Scalar>(
+                              func, ExecutionMode::Synchronous, numThreads, [&](Swarm &pso) {
+                                  pso.setTopology(topology);
+                              }));
+                }
+            check("async/" + suffix,
+                  countRunAllocations<Scalar>(
+                      func, ExecutionMode::Asynchronous, numThreads, [](Swarm &) {}));
+                for (const ExecutionMode mode :
+                     {ExecutionMode::Synchronous, ExecutionMode::Asynchronous}) {
+                    const std::string prefix =
+                        mode == ExecutionMode::Synchronous ? "sync/" : "async/";
+                        // The cache is refused by the types that trap on overflow.
+                        if constexpr (OverflowTraits<Scalar>::policy != OverflowPolicy::Trap) {
+                            check(prefix + "cache/" + suffix,
+                                  countRunAllocations<Scalar>(
+                                      func, mode, numThreads, [](Swarm &pso) {
+                                          pso.setEvaluationCache(1 << 14);
+                                      }));
+                    }
+                        for (const BoundaryPolicy policy : {BoundaryPolicy::Clamp,
+                                                            BoundaryPolicy::Reflect,
+                                                            BoundaryPolicy::Wrap,
+                                                            BoundaryPolicy::Reinitialize,
+                                                            BoundaryPolicy::Absorb}) {
+                            check(prefix + "bounded/" + boundaryPolicyName(policy) + "/" + suffix,
+                                  countRunAllocations<Scalar>(
+                                      func, mode, numThreads, [&](Swarm &pso) {
+                                          pso.setBoundaryHandling(policy, Scalar{1.0});
+                                      }));
+                        }
+                }
+                for (const bool delta : {false, true}) {
+                    const std::string path = "allocations_trajectory.bin";
+                    TrajectoryWriter<Scalar> writer(
+                        path, 10, 1000, runIterations, -5.0, 5.0, "f1", 1, delta);
+                    check(std::string("sync/trajectory/") + (delta ? "delta/" : "") + suffix,
+                          countRunAllocations<Scalar>(
+                              func, ExecutionMode::Synchronous, numThreads, [&](Swarm &pso) {
+                                  pso.setTrajectoryWriter(&writer);
+                              }));
+                    writer.close();
+                    std::remove(path.c_str());
+                }
+            check("batch/" + suffix, countBatchAllocations<Scalar>(func, numThreads));
+        }
+    check("islands/" + type, countIslandAllocations<Scalar>(func));
+}
+
+/**
+ * @brief Check that the iterations of the optimizers perform no heap allocation, whatever the
+ * type, the number of threads, the execution mode and the features they use. Exits with 1 if any
+ * of them does.
+ */
+int
+main() {
+    checkRuns<double>("double", F1{});
+    checkRuns<fixed_double>("fixed", FixedF1{});
+        if (failures > 0) {
+            std::cerr << failures << " checks performed heap allocations in the iterations"
+                      << std::endl;
+            return 1;
+    }
+    return 0;
+}
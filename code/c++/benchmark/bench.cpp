@@ -0,0 +1,490 @@
+#include "BatchSolver.hpp"
+#include "Benchmark.hpp"
+#include "FixedFunctions.hpp"
+#include "FixedPoint.hpp"
+#include "Functions.hpp"
+#include "PSO.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+/**
+ * @brief Number of iterations of the whole runs measured by the "run" benchmarks.
+ */
+constexpr unsigned int runIterations = 100;
+
+/**
+ * @brief Inertia weight, cognitive and social coefficients of every benchmark, as in main.cpp.
+ */
+constexpr double benchW = 0.75, benchC = 1.0, benchS = 1.0;
+
+/**
+ * @brief Fill storage with positions drawn uniformly between lowerBound and upperBound, as
+ * PSO::initializeParticles() does.
+ */
+template <typename Scalar, unsigned int Dims>
+void
+fillUniform(SwarmStorage<Scalar, Dims> &storage,
+            const unsigned int         &numParticles,
+            const double               &lowerBound,
+            const double               &upperBound) {
+    const Philox        random;
+    std::vector<Scalar> a(numParticles), b(numParticles);
+        for (unsigned int d = 0; d < storage.getDimensions(); d++) {
+            random.fill(0, d, Philox::initializationStream, 0, numParticles, a.data(), b.data());
+                for (unsigned int j = 0; j < numParticles; j++) {
+                    storage(d, j) = Scalar{lowerBound} + Scalar{upperBound - lowerBound} * a[j];
+                }
+        }
+}
+
+/**
+ * @brief Add the benchmark of the velocity and position update kernel selected for Scalar on this
+ * CPU, applied to numParticles particles along every dimension.
+ */
+template <typename Scalar>
+void
+addKernelBenchmark(std::vector<Benchmark> &benchmarks,
+                   const std::string      &type,
+                   const unsigned int     &numParticles,
+                   const unsigned int     &dimensions) {
+    const auto function = [=](BenchmarkState &state) {
+        SwarmStorage<Scalar> positions(numParticles, dimensions);
+        SwarmStorage<Scalar> velocities(numParticles, dimensions);
+        SwarmStorage<Scalar> bestPositions(numParticles, dimensions);
+        fillUniform(positions, numParticles, -5.0, 5.0);
+        fillUniform(bestPositions, numParticles, -5.0, 5.0);
+        std::vector<Scalar> cognitiveFactors(numParticles), socialFactors(numParticles);
+        Philox{}.fill(0,
+                      0,
+                      Philox::updateStream,
+                      0,
+                      numParticles,
+                      cognitiveFactors.data(),
+                      socialFactors.data());
+        const auto   kernel = UpdateKernel<Scalar>::select(detectSimdLevel());
+        const Scalar w{benchW}, c{benchC}, s{benchS}, g{0.0};
+        state.resumeTiming();
+            for (std::uint64_t k = 0; k < state.getIterations(); k++) {
+                    for (unsigned int d = 0; d < dimensions; d++) {
+                        kernel(numParticles,
+                               w,
+                               c,
+                               s,
+                               g,
+                               positions.row(d),
+                               velocities.row(d),
+                               bestPositions.row(d),
+                               cognitiveFactors.data(),
+                               socialFactors.data());
+                    }
+                doNotOptimize(positions.row(0));
+            }
+        state.pauseTiming();
+    };
+    benchmarks.push_back({"kernel/" + type + "/" + std::to_string(numParticles) + "/" +
+                              std::to_string(dimensions),
+                          function,
+                          static_cast<double>(numParticles),
+                          0});
+}
+
+/**
+ * @brief Add the benchmarks of the initialization, of the evaluation of the function to minimize
+ * and of whole runs of a PSO whose number of dimensions is fixed to Dims.
+ */
+template <typename Scalar, unsigned int Dims, typename Objective>
+void
+addProblemBenchmarks(std::vector<Benchmark> &benchmarks,
+                     const std::string      &prefix,
+                     const Objective        &func,
+                     const unsigned int     &numParticles,
+                     const unsigned int     &dimensions,
+                     const double           &bound,
+                     const unsigned int     &numThreads) {
+    const auto makePSO = [=]() {
+        return PSO<Scalar, Dims, Objective>(numParticles,
+                                            dimensions,
+                                            func,
+                                            Scalar{bound},
+                                            Scalar{-bound},
+                                            Scalar{benchW},
+                                            Scalar{benchC},
+                                            Scalar{benchS},
+                                            runIterations,
+                                            numThreads);
+    };
+    const double particles = numParticles;
+
+    const auto initialize = [=](BenchmarkState &state) {
+        auto pso = makePSO();
+            for (std::uint64_t k = 0; k < state.getIterations(); k++) {
+                state.resumeTiming();
+                pso.initializeParticles();
+                state.pauseTiming();
+            }
+    };
+    benchmarks.push_back({"init/" + prefix, initialize, 0, particles});
+
+    const auto evaluate = [=](BenchmarkState &state) {
+        SwarmStorage<Scalar, Dims> positions(numParticles, dimensions);
+        fillUniform(positions, numParticles, -bound, bound);
+        std::vector<Scalar> scores(numParticles);
+        state.resumeTiming();
+            for (std::uint64_t k = 0; k < state.getIterations(); k++) {
+                func(positions.view(), scores.data());
+                doNotOptimize(scores.data());
+            }
+        state.pauseTiming();
+    };
+    benchmarks.push_back({"eval/" + prefix, evaluate, 0, particles});
+
+    const auto run = [=](BenchmarkState &state) {
+        auto pso = makePSO();
+            for (std::uint64_t k = 0; k < state.getIterations(); k++) {
+                pso.initializeParticles();
+                state.resumeTiming();
+                pso.run();
+                state.pauseTiming();
+            }
+    };
+    benchmarks.push_back(
+        {"run/" + prefix, run, particles * runIterations, particles * runIterations});
+}
+
+/**
+ * @brief Add the benchmarks of the initialization, of the evaluation of func and of whole runs,
+ * with the same choice of PSO as main.cpp: fixed to 2 dimensions for 2-D problems, dynamic
+ * otherwise.
+ */
+template <typename Scalar, typename Objective>
+void
+addProblemBenchmarks(std::vector<Benchmark> &benchmarks,
+                     const std::string      &type,
+                     const std::string      &function,
+                     const Objective        &func,
+                     const unsigned int     &numParticles,
+                     const unsigned int     &dimensions,
+                     const double           &bound,
+                     const unsigned int     &numThreads) {
+    const std::string prefix = type + "/" + function + "/" + std::to_string(numParticles) + "/" +
+                               std::to_string(dimensions);
+        if (dimensions == 2) {
+            addProblemBenchmarks<Scalar, 2>(
+                benchmarks, prefix, func, numParticles, dimensions, bound, numThreads);
+        } else {
+            addProblemBenchmarks<Scalar, dynamicDimensions>(
+                benchmarks, prefix, func, numParticles, dimensions, bound, numThreads);
+        }
+}
+
+/**
+ * @brief Add the benchmarks of numProblems 2-D problems of numParticles particles, minimizing
+ * func for runIterations iterations: solved together by a BatchSolver, and one PSO at a time,
+ * construction included.
+ */
+template <typename Scalar, typename Objective>
+void
+addBatchBenchmarks(std::vector<Benchmark> &benchmarks,
+                   const std::string      &type,
+                   const std::string      &function,
+                   const Objective        &func,
+                   const unsigned int     &numProblems,
+                   const unsigned int     &numParticles,
+                   const double           &bound,
+                   const unsigned int     &numThreads) {
+    const std::string suffix = type + "/" + function + "/" + std::to_string(numProblems) + "x" +
+                               std::to_string(numParticles);
+    const double      particles = static_cast<double>(numProblems) * numParticles;
+
+    const auto batch = [=](BenchmarkState &state) {
+        const std::vector<BatchProblem<Scalar>> problems(
+            numProblems,
+            BatchProblem<Scalar>{
+                Scalar{-bound}, Scalar{bound}, Scalar{benchW}, Scalar{benchC}, Scalar{benchS}});
+        BatchSolver<Scalar, 2, Objective> solver(
+            problems, numParticles, 2, func, runIterations, numThreads);
+        state.resumeTiming();
+            for (std::uint64_t k = 0; k < state.getIterations(); k++) {
+                doNotOptimize(solver.solve().data());
+            }
+        state.pauseTiming();
+    };
+    benchmarks.push_back(
+        {"batch/" + suffix, batch, particles * runIterations, particles * (runIterations + 1)});
+
+    const auto separate = [=](BenchmarkState &state) {
+        state.resumeTiming();
+            for (std::uint64_t k = 0; k < state.getIterations(); k++) {
+                    for (unsigned int p = 0; p < numProblems; p++) {
+                        PSO<Scalar, 2, Objective> pso(numParticles,
+                                                      2,
+                                                      func,
+                                                      Scalar{bound},
+                                                      Scalar{-bound},
+                                                      Scalar{benchW},
+                                                      Scalar{benchC},
+                                                      Scalar{benchS},
+                                                      runIterations,
+                                                      numThreads,
+                                                      42 + p);
+                        pso.initializeParticles();
+                        doNotOptimize(pso.run().bestScore);
+                    }
+            }
+        state.pauseTiming();
+    };
+    benchmarks.push_back({"separate/" + suffix,
+                          separate,
+                          particles * runIterations,
+                          particles * (runIterations + 1)});
+}
+
+/**
+ * @brief Function to minimize that evaluates func repeats times, standing for an expensive one.
+ */
+template <typename Objective>
+struct Repeated {
+    /**
+     * @brief Function to minimize.
+     */
+    Objective func;
+    /**
+     * @brief Number of evaluations of func per evaluation.
+     */
+    unsigned int repeats;
+
+    template <typename View, typename Scalar>
+    void
+    operator()(const View &x, Scalar *out) const {
+            for (unsigned int k = 0; k < repeats; k++) {
+                func(x, out);
+                doNotOptimize(out);
+            }
+    }
+};
+
+/**
+ * @brief Add the benchmarks of long 2-D runs of numParticles particles, minimizing func made
+ * 1000 times more expensive, with and without an evaluation cache of 2^14 positions.
+ */
+template <typename Scalar, typename Objective>
+void
+addCacheBenchmarks(std::vector<Benchmark> &benchmarks,
+                   const std::string      &type,
+                   const std::string      &function,
+                   const Objective        &func,
+                   const unsigned int     &numParticles,
+                   const double           &bound,
+                   const unsigned int     &numThreads) {
+    // The particles only land on positions they already visited once they have converged.
+    constexpr unsigned int iterations = 20 * runIterations;
+    const std::string      suffix =
+        type + "/" + function + "/" + std::to_string(numParticles) + "/2";
+    const double particles = numParticles;
+
+        for (const std::size_t capacity : {std::size_t{0}, std::size_t{1} << 14}) {
+            const auto run = [=](BenchmarkState &state) {
+                PSO<Scalar, 2, Repeated<Objective>> pso(numParticles,
+                                                        2,
+                                                        Repeated<Objective>{func, 1000},
+                                                        Scalar{bound},
+                                                        Scalar{-bound},
+                                                        Scalar{benchW},
+                                                        Scalar{benchC},
+                                                        Scalar{benchS},
+                                                        iterations,
+                                                        numThreads);
+                pso.setEvaluationCache(capacity);
+                    for (std::uint64_t k = 0; k < state.getIterations(); k++) {
+                        pso.initializeParticles();
+                        state.resumeTiming();
+                        pso.run();
+                        state.pauseTiming();
+                    }
+            };
+            benchmarks.push_back({(capacity > 0 ? "cached/" : "uncached/") + suffix,
+                                  run,
+                                  particles * iterations,
+                                  particles * iterations});
+        }
+}
+
+/**
+ * @brief Add the benchmarks of runs of numParticles particles minimizing func in the given number
+ * of dimensions, with every boundary policy and velocities clamped to the width of the search
+ * space, to compare with the unbounded run/ benchmarks.
+ */
+template <typename Scalar, typename Objective>
+void
+addBoundaryBenchmarks(std::vector<Benchmark> &benchmarks,
+                      const std::string      &type,
+                      const std::string      &function,
+                      const Objective        &func,
+                      const unsigned int     &numParticles,
+                      const unsigned int     &dimensions,
+                      const double           &bound,
+                      const unsigned int     &numThreads) {
+    const std::string suffix = type + "/" + function + "/" + std::to_string(numParticles) + "/" +
+                               std::to_string(dimensions);
+    const double particles = numParticles;
+
+        for (const BoundaryPolicy policy : {BoundaryPolicy::None,
+                                            BoundaryPolicy::Clamp,
+                                            BoundaryPolicy::Reflect,
+                                            BoundaryPolicy::Wrap,
+                                            BoundaryPolicy::Reinitialize,
+                                            BoundaryPolicy::Absorb}) {
+            const auto run = [=](BenchmarkState &state) {
+                PSO<Scalar, dynamicDimensions, Objective> pso(numParticles,
+                                                              dimensions,
+                                                              func,
+                                                              Scalar{bound},
+                                                              Scalar{-bound},
+                                                              Scalar{benchW},
+                                                              Scalar{benchC},
+                                                              Scalar{benchS},
+                                                              runIterations,
+                                                              numThreads);
+                pso.setBoundaryHandling(policy, Scalar{2 * bound});
+                    for (std::uint64_t k = 0; k < state.getIterations(); k++) {
+                        pso.initializeParticles();
+                        state.resumeTiming();
+                        pso.run();
+                        state.pauseTiming();
+                    }
+            };
+            benchmarks.push_back({"bounded/" + std::string(boundaryPolicyName(policy)) + "/" +
+                                      suffix,
+                                  run,
+                                  particles * runIterations,
+                                  particles * runIterations});
+        }
+}
+
+/**
+ * @brief Add every benchmark of the arithmetic type Scalar, with the implementations F1, F2 and
+ * Rosenbrock of the functions to minimize.
+ */
+template <typename Scalar, typename F1, typename F2, typename Rosenbrock>
+void
+addBenchmarks(std::vector<Benchmark> &benchmarks,
+              const std::string      &type,
+              const unsigned int     &numThreads) {
+        for (const unsigned int numParticles : {100u, 1000u, 10000u}) {
+                for (const unsigned int dimensions : {2u, 10u}) {
+                    addKernelBenchmark<Scalar>(benchmarks, type, numParticles, dimensions);
+                }
+                for (const unsigned int dimensions : {2u, 10u}) {
+                    addProblemBenchmarks<Scalar>(
+                        benchmarks, type, "f1", F1{}, numParticles, dimensions, 5.0, numThreads);
+                }
+            // Function 2 is only defined in 2 dimensions, and searched in a wider box.
+            addProblemBenchmarks<Scalar>(
+                benchmarks, type, "f2", F2{}, numParticles, 2, 10.0, numThreads);
+                for (const unsigned int dimensions : {2u, 10u}) {
+                    addProblemBenchmarks<Scalar>(benchmarks,
+                                                 type,
+                                                 "rosenbrock",
+                                                 Rosenbrock{},
+                                                 numParticles,
+                                                 dimensions,
+                                                 5.0,
+                                                 numThreads);
+                }
+        }
+    addBatchBenchmarks<Scalar>(benchmarks, type, "f1", F1{}, 1000, 100, 5.0, numThreads);
+        // The cache is refused by the types that trap on overflow.
+        if constexpr (OverflowTraits<Scalar>::policy != OverflowPolicy::Trap) {
+            addCacheBenchmarks<Scalar>(benchmarks, type, "f1", F1{}, 100, 5.0, numThreads);
+    }
+    addBoundaryBenchmarks<Scalar>(
+        benchmarks, type, "rosenbrock", Rosenbrock{}, 1000, 10, 5.0, numThreads);
+}
+
+int
+main(int argc, char **argv) {
+    BenchmarkOptions options;
+    unsigned int     numThreads = 1;
+    std::string      outPath    = "";
+    bool             list       = false;
+
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            const std::string key = arg.substr(0, arg.find('='));
+            const std::string value =
+                arg.find('=') == std::string::npos ? "" : arg.substr(arg.find('=') + 1);
+                if (key == "--filter") {
+                    options.filter = value;
+                } else if (key == "--min_time") {
+                    options.minTime = std::stod(value);
+                } else if (key == "--repetitions") {
+                    options.repetitions = std::stoi(value);
+                } else if (key == "--threads") {
+                    numThreads = std::stoi(value);
+                } else if (key == "--out") {
+                    outPath = value;
+                } else if (key == "--list") {
+                    list = true;
+                } else {
+                    std::cerr << "Usage: " << argv[0]
+                              << " [--filter=<substring>] [--min_time=<seconds>]"
+                                 " [--repetitions=<n>] [--threads=<n>] [--out=<file.json>] [--list]"
+                              << std::endl;
+                    return 1;
+                }
+        }
+
+    std::vector<Benchmark> benchmarks;
+    addBenchmarks<double, F1, F2, Rosenbrock>(benchmarks, "double", numThreads);
+    addBenchmarks<fixed_double, FixedF1, FixedF2, FixedRosenbrock>(
+        benchmarks, "fixed", numThreads);
+
+    std::vector<BenchmarkResult> results;
+        for (const Benchmark &benchmark : benchmarks) {
+                if (benchmark.name.find(options.filter) == std::string::npos) {
+                    continue;
+            }
+                if (list) {
+                    std::cout << benchmark.name << std::endl;
+                    continue;
+            }
+            results.push_back(runBenchmark(benchmark, options));
+            // Progress goes to std::cerr, so that std::cout can be redirected to a JSON file.
+            std::cerr << std::left << std::setw(40) << benchmark.name << std::right
+                      << std::setw(14) << std::fixed << std::setprecision(0)
+                      << BenchmarkSummary(results.back().times).median << " ns" << std::endl;
+        }
+        if (list) {
+            return 0;
+    }
+
+    std::ostringstream compiler;
+#if defined(__clang__)
+    compiler << "clang " << __clang_version__;
+#elif defined(__GNUC__)
+    compiler << "gcc " << __VERSION__;
+#endif
+    const std::vector<std::pair<std::string, std::string>> context = {
+        {"executable", argv[0]},
+        {"simd_level", simdLevelName(detectSimdLevel())},
+        {"threads", std::to_string(numThreads)},
+        {"run_iterations", std::to_string(runIterations)},
+        {"fixed_point_overflow_policy", overflowPolicyName(OverflowTraits<fixed_double>::policy)},
+        {"instrumentation", instrumentationEnabled ? "enabled" : "disabled"},
+        {"compiler", compiler.str()},
+#ifdef NDEBUG
+        {"library_build_type", "release"},
+#else
+        {"library_build_type", "debug"},
+#endif
+    };
+        if (outPath.empty()) {
+            writeBenchmarksJSON(std::cout, context, results);
+        } else {
+            std::ofstream out(outPath);
+            writeBenchmarksJSON(out, context, results);
+        }
+    return 0;
+}
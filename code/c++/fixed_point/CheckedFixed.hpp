@@ -0,0 +1,420 @@
+#ifndef CHECKED_FIXED_HPP
+#define CHECKED_FIXED_HPP
+
+#include "fpm/include/fpm/fixed.hpp"
+#include "fpm/include/fpm/ios.hpp"
+
+#include "Overflow.hpp"
+#include "Philox.hpp"
+#include "Trajectory.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+
+/**
+ * @brief Fixed-point type with the arithmetic of Fixed, whose operations apply Policy when their
+ * result does not fit in it.
+ * @details Every operation computes its exact result in the intermediate type of Fixed, exactly as
+ * fpm does, and checks it against the range of the base type before storing it. Overflows are
+ * counted per thread, in a counter shared by all the values of the type (see OverflowTraits). With
+ * the Wrap policy, nothing is checked and the type behaves as Fixed.
+ */
+template <typename Fixed, OverflowPolicy Policy>
+class CheckedFixed;
+
+template <typename BaseType,
+          typename IntermediateType,
+          unsigned int   FractionBits,
+          bool           Rounding,
+          OverflowPolicy Policy>
+class CheckedFixed<fpm::fixed<BaseType, IntermediateType, FractionBits, Rounding>, Policy> {
+  public:
+    /**
+     * @brief Unchecked fixed-point type with the same representation.
+     */
+    using Fixed = fpm::fixed<BaseType, IntermediateType, FractionBits, Rounding>;
+
+    CheckedFixed() noexcept = default;
+
+    /**
+     * @brief Construct a value from an unchecked one with the same representation.
+     */
+    constexpr explicit CheckedFixed(const Fixed &value_) noexcept : value(value_) {}
+
+    /**
+     * @brief Construct a value from an integer.
+     */
+    template <typename T, typename std::enable_if_t<std::is_integral_v<T>> * = nullptr>
+    constexpr explicit CheckedFixed(T x) noexcept :
+        value(Fixed::from_raw_value(narrow(static_cast<IntermediateType>(x) * fractionMult))) {}
+
+    /**
+     * @brief Construct a value from a floating-point number, rounded as fpm does.
+     * @details A number out of the range of the type, or NaN, has no bits to wrap around: it is
+     * clamped to the closest value whatever the policy, and counted as an overflow unless the policy
+     * is Wrap.
+     */
+    template <typename T, typename std::enable_if_t<std::is_floating_point_v<T>> * = nullptr>
+    constexpr explicit CheckedFixed(T x) noexcept : value(Fixed::from_raw_value(roundRaw(x))) {}
+
+    /**
+     * @brief Convert the value to a floating-point number or, truncating it, to an integer.
+     */
+    template <typename T, typename std::enable_if_t<std::is_arithmetic_v<T>> * = nullptr>
+    constexpr explicit
+    operator T() const noexcept {
+        return static_cast<T>(value);
+    }
+
+    /**
+     * @brief Get the raw value, i.e. the value multiplied by 2^FractionBits.
+     */
+    constexpr BaseType
+    raw_value() const noexcept {
+        return value.raw_value();
+    }
+
+    /**
+     * @brief Construct a value from its raw value.
+     */
+    static constexpr CheckedFixed
+    from_raw_value(const BaseType &raw) noexcept {
+        return CheckedFixed(Fixed::from_raw_value(raw));
+    }
+
+    /**
+     * @brief Get the number of operations of the type that overflowed in the calling thread since
+     * the last resetOverflows() in it.
+     */
+    static std::uint64_t
+    getOverflows() noexcept {
+        return overflows;
+    }
+
+    /**
+     * @brief Add count overflows to the counter of the calling thread. Used by the vectorized
+     * kernels, which check the overflows of the operations they compute in bulk.
+     */
+    static void
+    addOverflows(const std::uint64_t &count) noexcept {
+        overflows += count;
+    }
+
+    /**
+     * @brief Reset the counter of the operations that overflowed in the calling thread.
+     */
+    static void
+    resetOverflows() noexcept {
+        overflows = 0;
+    }
+
+    constexpr CheckedFixed
+    operator-() const noexcept {
+        return from_raw_value(narrow(-static_cast<IntermediateType>(raw_value())));
+    }
+
+    CheckedFixed &
+    operator+=(const CheckedFixed &y) noexcept {
+        value = Fixed::from_raw_value(
+            narrow(static_cast<IntermediateType>(raw_value()) + y.raw_value()));
+        return *this;
+    }
+
+    CheckedFixed &
+    operator-=(const CheckedFixed &y) noexcept {
+        value = Fixed::from_raw_value(
+            narrow(static_cast<IntermediateType>(raw_value()) - y.raw_value()));
+        return *this;
+    }
+
+    CheckedFixed &
+    operator*=(const CheckedFixed &y) noexcept {
+        const IntermediateType product = static_cast<IntermediateType>(raw_value()) * y.raw_value();
+            if constexpr (Rounding) {
+                const IntermediateType half = product / (fractionMult / 2);
+                value                       = Fixed::from_raw_value(narrow(half / 2 + half % 2));
+            } else {
+                value = Fixed::from_raw_value(narrow(product / fractionMult));
+            }
+        return *this;
+    }
+
+    CheckedFixed &
+    operator/=(const CheckedFixed &y) noexcept {
+        const IntermediateType dividend = static_cast<IntermediateType>(raw_value()) * fractionMult;
+            if constexpr (Rounding) {
+                const IntermediateType twice = dividend * 2 / y.raw_value();
+                value                        = Fixed::from_raw_value(narrow(twice / 2 + twice % 2));
+            } else {
+                value = Fixed::from_raw_value(narrow(dividend / y.raw_value()));
+            }
+        return *this;
+    }
+
+    /**
+     * @brief Add an integer.
+     */
+    template <typename T, typename std::enable_if_t<std::is_integral_v<T>> * = nullptr>
+    CheckedFixed &
+    operator+=(T y) noexcept {
+        return *this += CheckedFixed(y);
+    }
+
+    /**
+     * @brief Subtract an integer.
+     */
+    template <typename T, typename std::enable_if_t<std::is_integral_v<T>> * = nullptr>
+    CheckedFixed &
+    operator-=(T y) noexcept {
+        return *this -= CheckedFixed(y);
+    }
+
+    /**
+     * @brief Multiply by an integer, which is a plain integer multiplication of the raw value.
+     */
+    template <typename T, typename std::enable_if_t<std::is_integral_v<T>> * = nullptr>
+    CheckedFixed &
+    operator*=(T y) noexcept {
+        value = Fixed::from_raw_value(narrow(static_cast<IntermediateType>(raw_value()) * y));
+        return *this;
+    }
+
+    /**
+     * @brief Divide by an integer, which is a plain integer division of the raw value.
+     */
+    template <typename T, typename std::enable_if_t<std::is_integral_v<T>> * = nullptr>
+    CheckedFixed &
+    operator/=(T y) noexcept {
+        value = Fixed::from_raw_value(narrow(static_cast<IntermediateType>(raw_value()) / y));
+        return *this;
+    }
+
+  private:
+    /**
+     * @brief 2^FractionBits, i.e. the raw value of 1.
+     */
+    static constexpr IntermediateType fractionMult = IntermediateType{1} << FractionBits;
+
+    /**
+     * @brief Largest raw value.
+     */
+    static constexpr BaseType maxRaw = std::numeric_limits<BaseType>::max();
+
+    /**
+     * @brief Smallest raw value.
+     */
+    static constexpr BaseType minRaw = std::numeric_limits<BaseType>::min();
+
+    /**
+     * @brief Number of operations that overflowed in the thread, shared by all the values of the
+     * type. Every thread has its own, so that counting needs no synchronization and the optimizers
+     * can tell their overflows apart (see PSO::getOverflows()).
+     */
+    static inline thread_local std::uint64_t overflows = 0;
+
+    /**
+     * @brief Count an overflow.
+     */
+    static void
+    overflow() noexcept {
+        overflows++;
+    }
+
+    /**
+     * @brief Convert a floating-point number to the raw value of the closest value of the type,
+     * checking its range before converting it, see CheckedFixed(T).
+     */
+    template <typename T>
+    static constexpr BaseType
+    roundRaw(const T &x) noexcept {
+        const T scaled  = x * static_cast<T>(fractionMult);
+        const T rounded = Rounding ? (x >= 0 ? scaled + T{0.5} : scaled - T{0.5}) : scaled;
+            if (rounded < -static_cast<T>(minRaw) && rounded > static_cast<T>(minRaw) - 1) {
+                return static_cast<BaseType>(rounded);
+        }
+            if constexpr (Policy != OverflowPolicy::Wrap) {
+                overflow();
+        }
+        return x > 0 ? maxRaw : minRaw;
+    }
+
+    /**
+     * @brief Convert the exact raw result of an operation to the base type, applying Policy.
+     */
+    static constexpr BaseType
+    narrow(const IntermediateType &raw) noexcept {
+            if constexpr (Policy != OverflowPolicy::Wrap) {
+                    if (raw > maxRaw || raw < minRaw) {
+                        overflow();
+                            if constexpr (Policy == OverflowPolicy::Saturate) {
+                                return raw > 0 ? maxRaw : minRaw;
+                        }
+                }
+        }
+        return static_cast<BaseType>(raw);
+    }
+
+    /**
+     * @brief Value, with the representation of Fixed.
+     */
+    Fixed value;
+};
+
+/**
+ * @brief Arithmetic operators of CheckedFixed, with the semantics of fpm: an integer operand is
+ * converted to the fixed-point type, except that multiplications and divisions of a fixed-point
+ * value by an integer are plain integer operations on its raw value.
+ */
+#define CHECKED_FIXED_OPERATOR(op, assignment)                                                     \
+    template <typename Fixed, OverflowPolicy Policy>                                               \
+    inline CheckedFixed<Fixed, Policy> operator op(const CheckedFixed<Fixed, Policy> &x,           \
+                                                   const CheckedFixed<Fixed, Policy> &y) {         \
+        return CheckedFixed<Fixed, Policy>(x) assignment y;                                        \
+    }                                                                                              \
+    template <typename Fixed,                                                                      \
+              OverflowPolicy Policy,                                                               \
+              typename T,                                                                          \
+              typename std::enable_if_t<std::is_integral_v<T>> * = nullptr>                        \
+    inline CheckedFixed<Fixed, Policy> operator op(const CheckedFixed<Fixed, Policy> &x, T y) {    \
+        return CheckedFixed<Fixed, Policy>(x) assignment y;                                        \
+    }                                                                                              \
+    template <typename Fixed,                                                                      \
+              OverflowPolicy Policy,                                                               \
+              typename T,                                                                          \
+              typename std::enable_if_t<std::is_integral_v<T>> * = nullptr>                        \
+    inline CheckedFixed<Fixed, Policy> operator op(T x, const CheckedFixed<Fixed, Policy> &y) {    \
+        return CheckedFixed<Fixed, Policy>(x) assignment y;                                        \
+    }
+
+CHECKED_FIXED_OPERATOR(+, +=)
+CHECKED_FIXED_OPERATOR(-, -=)
+CHECKED_FIXED_OPERATOR(*, *=)
+CHECKED_FIXED_OPERATOR(/, /=)
+#undef CHECKED_FIXED_OPERATOR
+
+/**
+ * @brief Comparison operators of CheckedFixed.
+ */
+#define CHECKED_FIXED_COMPARISON(op)                                                               \
+    template <typename Fixed, OverflowPolicy Policy>                                               \
+    constexpr bool operator op(const CheckedFixed<Fixed, Policy> &x,                               \
+                               const CheckedFixed<Fixed, Policy> &y) noexcept {                    \
+        return x.raw_value() op y.raw_value();                                                     \
+    }
+
+CHECKED_FIXED_COMPARISON(==)
+CHECKED_FIXED_COMPARISON(!=)
+CHECKED_FIXED_COMPARISON(<)
+CHECKED_FIXED_COMPARISON(>)
+CHECKED_FIXED_COMPARISON(<=)
+CHECKED_FIXED_COMPARISON(>=)
+#undef CHECKED_FIXED_COMPARISON
+
+template <typename CharT, typename Fixed, OverflowPolicy Policy>
+inline std::basic_ostream<CharT> &
+operator<<(std::basic_ostream<CharT> &os, const CheckedFixed<Fixed, Policy> &x) {
+    return os << Fixed::from_raw_value(x.raw_value());
+}
+
+namespace std {
+/**
+ * @brief Limits of CheckedFixed, which are the ones of the unchecked type.
+ */
+template <typename Fixed, OverflowPolicy Policy>
+struct numeric_limits<CheckedFixed<Fixed, Policy>> : numeric_limits<Fixed> {
+    static constexpr CheckedFixed<Fixed, Policy>
+    min() noexcept {
+        return CheckedFixed<Fixed, Policy>(numeric_limits<Fixed>::min());
+    }
+
+    static constexpr CheckedFixed<Fixed, Policy>
+    lowest() noexcept {
+        return CheckedFixed<Fixed, Policy>(numeric_limits<Fixed>::lowest());
+    }
+
+    static constexpr CheckedFixed<Fixed, Policy>
+    max() noexcept {
+        return CheckedFixed<Fixed, Policy>(numeric_limits<Fixed>::max());
+    }
+
+    static constexpr CheckedFixed<Fixed, Policy>
+    epsilon() noexcept {
+        return CheckedFixed<Fixed, Policy>(numeric_limits<Fixed>::epsilon());
+    }
+};
+} // namespace std
+
+/**
+ * @brief Random CheckedFixed values are generated as the ones of the unchecked type.
+ */
+template <typename Fixed, OverflowPolicy Policy>
+struct UniformFromBits<CheckedFixed<Fixed, Policy>> {
+    static constexpr unsigned int bits = UniformFromBits<Fixed>::bits;
+
+    static CheckedFixed<Fixed, Policy>
+    convert(const std::uint32_t &hi, const std::uint32_t &lo) {
+        return CheckedFixed<Fixed, Policy>(UniformFromBits<Fixed>::convert(hi, lo));
+    }
+};
+
+/**
+ * @brief CheckedFixed values stored on 32 bits are written to trajectory files as their raw
+ * values, which are exact; the others are written as floats.
+ */
+template <typename BaseType,
+          typename IntermediateType,
+          unsigned int   FractionBits,
+          bool           Rounding,
+          OverflowPolicy Policy>
+struct TrajectoryTraits<
+    CheckedFixed<fpm::fixed<BaseType, IntermediateType, FractionBits, Rounding>, Policy>> {
+    static constexpr bool raw = sizeof(BaseType) == sizeof(std::int32_t);
+
+    using Value = std::conditional_t<raw, std::int32_t, float>;
+
+    static constexpr TrajectoryEncoding encoding =
+        raw ? TrajectoryEncoding::Fixed32 : TrajectoryEncoding::Float32;
+
+    static constexpr std::uint32_t fractionBits = raw ? FractionBits : 0;
+
+    static Value
+    encode(const CheckedFixed<fpm::fixed<BaseType, IntermediateType, FractionBits, Rounding>,
+                              Policy> &x) {
+            if constexpr (raw) {
+                return x.raw_value();
+            } else {
+                return static_cast<float>(static_cast<double>(x));
+            }
+    }
+};
+
+/**
+ * @brief Overflow policy and counters of CheckedFixed.
+ */
+template <typename Fixed, OverflowPolicy Policy>
+struct OverflowTraits<CheckedFixed<Fixed, Policy>> {
+    static constexpr OverflowPolicy policy = Policy;
+
+    static constexpr bool counted = Policy != OverflowPolicy::Wrap;
+
+    static std::uint64_t
+    count() {
+        return CheckedFixed<Fixed, Policy>::getOverflows();
+    }
+
+    static void
+    reset() {
+        CheckedFixed<Fixed, Policy>::resetOverflows();
+    }
+
+    static std::uint64_t
+    take() {
+        const std::uint64_t count = CheckedFixed<Fixed, Policy>::getOverflows();
+        CheckedFixed<Fixed, Policy>::resetOverflows();
+        return count;
+    }
+};
+
+#endif
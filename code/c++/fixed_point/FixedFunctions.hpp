@@ -0,0 +1,52 @@
+#ifndef FIXED_FUNCTIONS_HPP
+#define FIXED_FUNCTIONS_HPP
+
+#include "FixedKernels.hpp"
+
+#include <algorithm>
+
+/**
+ * @brief Rosenbrock function, evaluated on a batch of particles.
+ * @details Generic on the arithmetic type, so that the same function runs in every fixed-point
+ * format and in the double-precision calibration pass. The PSO passes its instruction set level
+ * (see PSO::setSimdLevel()); other callers get the widest one supported by the CPU.
+ */
+struct FixedRosenbrock {
+    template <typename View, typename Scalar>
+    void
+    operator()(const View &x, Scalar *out, const SimdLevel &level = detectSimdLevel()) const {
+        std::fill_n(out, x.getNumParticles(), Scalar{0});
+            for (unsigned int i = 0; i + 1 < x.getDimensions(); i++) {
+                fixedAddRosenbrock(level, x.getNumParticles(), x.row(i), x.row(i + 1), out);
+            }
+    }
+};
+
+/**
+ * @brief Function 1 (sum of the squares), evaluated on a batch of particles.
+ */
+struct FixedF1 {
+    template <typename View, typename Scalar>
+    void
+    operator()(const View &x, Scalar *out, const SimdLevel &level = detectSimdLevel()) const {
+        std::fill_n(out, x.getNumParticles(), Scalar{0});
+            for (unsigned int i = 0; i < x.getDimensions(); i++) {
+                fixedAddSquares(level, x.getNumParticles(), x.row(i), out);
+            }
+    }
+};
+
+/**
+ * @brief Function 2, evaluated on a batch of 2-D particles.
+ */
+struct FixedF2 {
+    template <typename View, typename Scalar>
+    void
+    operator()(const View &x, Scalar *out, const SimdLevel &level = detectSimdLevel()) const {
+        Scalar c1{0.26};
+        Scalar c2{0.48};
+        fixedQuadraticForm(level, x.getNumParticles(), c1, c2, x.row(0), x.row(1), out);
+    }
+};
+
+#endif
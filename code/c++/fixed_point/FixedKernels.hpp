@@ -0,0 +1,785 @@
+#ifndef FIXED_KERNELS_HPP
+#define FIXED_KERNELS_HPP
+
+#include "Boundary.hpp"
+#include "CheckedFixed.hpp"
+#include "FixedPoint.hpp"
+#include "UpdateKernels.hpp"
+
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @brief Fixed-point type stored on 32 bits, with FractionBits fractional bits, whose arithmetic
+ * is vectorized by the kernels of this file.
+ */
+template <unsigned int FractionBits, bool Rounding>
+using Fixed32 = fpm::fixed<std::int32_t, std::int64_t, FractionBits, Rounding>;
+
+/**
+ * @brief Arithmetic of the types vectorized by the kernels of this file: Fixed32, which wraps
+ * around on overflow, and CheckedFixed of Fixed32, which applies its overflow policy.
+ * @details Other types, such as fixed-point types stored on 16 or 64 bits, or double, are not
+ * vectorized: the objective kernels process them with their scalar loops.
+ */
+template <typename Fixed>
+struct FixedKernelTraits {
+    static constexpr bool vectorized = false;
+};
+
+template <unsigned int FractionBits, bool Rounding>
+struct FixedKernelTraits<Fixed32<FractionBits, Rounding>> {
+    static constexpr bool           vectorized   = true;
+    static constexpr unsigned int   fractionBits = FractionBits;
+    static constexpr bool           rounding     = Rounding;
+    static constexpr OverflowPolicy policy       = OverflowPolicy::Wrap;
+};
+
+template <unsigned int FractionBits, bool Rounding, OverflowPolicy Policy>
+struct FixedKernelTraits<CheckedFixed<Fixed32<FractionBits, Rounding>, Policy>> {
+    static constexpr bool           vectorized   = true;
+    static constexpr unsigned int   fractionBits = FractionBits;
+    static constexpr bool           rounding     = Rounding;
+    static constexpr OverflowPolicy policy       = Policy;
+};
+
+/**
+ * @brief Reinterpret an array of fixed-point values as the array of their raw values.
+ * @details fpm::fixed and CheckedFixed are standard-layout classes whose only member is the raw
+ * value.
+ */
+template <typename Fixed>
+inline std::int32_t *
+rawValues(Fixed *x) {
+    static_assert(std::is_standard_layout_v<Fixed> && sizeof(Fixed) == sizeof(std::int32_t),
+                  "the fixed-point type must be laid out as its raw value");
+    return reinterpret_cast<std::int32_t *>(x);
+}
+
+template <typename Fixed>
+inline const std::int32_t *
+rawValues(const Fixed *x) {
+    static_assert(std::is_standard_layout_v<Fixed> && sizeof(Fixed) == sizeof(std::int32_t),
+                  "the fixed-point type must be laid out as its raw value");
+    return reinterpret_cast<const std::int32_t *>(x);
+}
+
+#ifdef PSO_X86_KERNELS
+// The kernels hold 32-bit raw values sign-extended in 64-bit lanes, so that products are computed
+// exactly by a single instruction. With the Wrap policy, additions and subtractions are only
+// correct on the low 32 bits of the lanes, which is all that the multiplications (which ignore the
+// high bits) and the stores (which truncate) read: this gives the same wrap-around as fpm on
+// overflow. With the other policies, the exact result of every operation is checked, as
+// CheckedFixed does, which keeps the lanes sign-extended; the overflows are counted per lane and
+// added to the counter of the type once per call.
+
+/**
+ * @brief Load 4 raw values, sign-extended to 64 bits.
+ */
+__attribute__((target("avx2"))) inline __m256i
+fixedLoadAVX2(const std::int32_t *x) {
+    return _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(x)));
+}
+
+/**
+ * @brief Store the low 32 bits of the 4 lanes of v.
+ */
+__attribute__((target("avx2"))) inline void
+fixedStoreAVX2(std::int32_t *x, const __m256i &v) {
+    const __m256i packed =
+        _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(x), _mm256_castsi256_si128(packed));
+}
+
+/**
+ * @brief Apply the overflow policy of Fixed to the exact results of 4 operations, and count in
+ * overflows the lanes that do not fit in 32 bits.
+ */
+template <typename Fixed>
+__attribute__((target("avx2"))) inline __m256i
+fixedCheckAVX2(const __m256i &v, __m256i &overflows) {
+    constexpr OverflowPolicy policy = FixedKernelTraits<Fixed>::policy;
+        if constexpr (policy == OverflowPolicy::Wrap) {
+            return v;
+        } else {
+            // Sign-extend the low 32 bits of the lanes: a lane fits if this leaves it unchanged.
+            const __m256i signs   = _mm256_srai_epi32(v, 31);
+            const __m256i wrapped = _mm256_blend_epi32(
+                v, _mm256_shuffle_epi32(signs, _MM_SHUFFLE(2, 2, 0, 0)), 0xAA);
+            const __m256i fits = _mm256_cmpeq_epi64(v, wrapped);
+            overflows = _mm256_sub_epi64(overflows, _mm256_xor_si256(fits, _mm256_set1_epi64x(-1)));
+                if constexpr (policy == OverflowPolicy::Saturate) {
+                    // The largest raw value, or its complement (the smallest one) if v is negative.
+                    const __m256i limit =
+                        _mm256_xor_si256(_mm256_set1_epi64x(INT32_MAX),
+                                         _mm256_cmpgt_epi64(_mm256_setzero_si256(), v));
+                    return _mm256_blendv_epi8(limit, v, fits);
+                } else {
+                    return wrapped;
+                }
+        }
+}
+
+/**
+ * @brief Add the overflows counted in the 4 lanes of overflows to the counter of Fixed.
+ */
+template <typename Fixed>
+__attribute__((target("avx2"))) inline void
+fixedFlushAVX2(const __m256i &overflows) {
+        if constexpr (FixedKernelTraits<Fixed>::policy != OverflowPolicy::Wrap) {
+            alignas(32) std::uint64_t lanes[4];
+            _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), overflows);
+            Fixed::addOverflows(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    }
+}
+
+/**
+ * @brief Add 4 pairs of fixed-point values.
+ */
+template <typename Fixed>
+__attribute__((target("avx2"))) inline __m256i
+fixedAddAVX2(const __m256i &a, const __m256i &b, __m256i &overflows) {
+    return fixedCheckAVX2<Fixed>(_mm256_add_epi64(a, b), overflows);
+}
+
+/**
+ * @brief Subtract 4 pairs of fixed-point values.
+ */
+template <typename Fixed>
+__attribute__((target("avx2"))) inline __m256i
+fixedSubAVX2(const __m256i &a, const __m256i &b, __m256i &overflows) {
+    return fixedCheckAVX2<Fixed>(_mm256_sub_epi64(a, b), overflows);
+}
+
+/**
+ * @brief Multiply 4 pairs of fixed-point values as fpm does, without checking the results.
+ * @details The exact 64-bit product is divided by 2^FractionBits truncating towards zero, after
+ * adding half of the last bit to its magnitude if rounding is enabled (i.e. rounding half away
+ * from zero), which is what the two truncating divisions of fpm compute. Used directly when one
+ * of the factors is in [0, 1), since the product cannot overflow then.
+ */
+template <typename Fixed>
+__attribute__((target("avx2"))) inline __m256i
+fixedProductAVX2(const __m256i &a, const __m256i &b) {
+    using Traits            = FixedKernelTraits<Fixed>;
+    const __m256i product   = _mm256_mul_epi32(a, b);
+    const __m256i sign      = _mm256_cmpgt_epi64(_mm256_setzero_si256(), product);
+    __m256i       magnitude = _mm256_sub_epi64(_mm256_xor_si256(product, sign), sign);
+        if constexpr (Traits::rounding) {
+            magnitude =
+                _mm256_add_epi64(magnitude, _mm256_set1_epi64x(1ll << (Traits::fractionBits - 1)));
+    }
+    magnitude = _mm256_srli_epi64(magnitude, Traits::fractionBits);
+    return _mm256_sub_epi64(_mm256_xor_si256(magnitude, sign), sign);
+}
+
+/**
+ * @brief Multiply 4 pairs of fixed-point values as fpm does.
+ */
+template <typename Fixed>
+__attribute__((target("avx2"))) inline __m256i
+fixedMulAVX2(const __m256i &a, const __m256i &b, __m256i &overflows) {
+    return fixedCheckAVX2<Fixed>(fixedProductAVX2<Fixed>(a, b), overflows);
+}
+
+/**
+ * @brief Multiply 4 fixed-point values by the integer factor, which is a plain integer
+ * multiplication in fpm.
+ */
+template <typename Fixed>
+__attribute__((target("avx2"))) inline __m256i
+fixedMulIntAVX2(const __m256i &a, const __m256i &factor, __m256i &overflows) {
+    return fixedCheckAVX2<Fixed>(_mm256_mul_epi32(a, factor), overflows);
+}
+
+// The AVX-512 intrinsics of GCC 12 initialize their unused operands with themselves, which
+// triggers false -Wmaybe-uninitialized warnings once inlined.
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+/**
+ * @brief Load 8 raw values, sign-extended to 64 bits.
+ */
+__attribute__((target("avx512f"))) inline __m512i
+fixedLoadAVX512(const std::int32_t *x) {
+    return _mm512_cvtepi32_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(x)));
+}
+
+/**
+ * @brief Store the low 32 bits of the 8 lanes of v.
+ */
+__attribute__((target("avx512f"))) inline void
+fixedStoreAVX512(std::int32_t *x, const __m512i &v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(x), _mm512_cvtepi64_epi32(v));
+}
+
+/**
+ * @brief Apply the overflow policy of Fixed to the exact results of 8 operations, see
+ * fixedCheckAVX2().
+ */
+template <typename Fixed>
+__attribute__((target("avx512f"))) inline __m512i
+fixedCheckAVX512(const __m512i &v, __m512i &overflows) {
+    constexpr OverflowPolicy policy = FixedKernelTraits<Fixed>::policy;
+        if constexpr (policy == OverflowPolicy::Wrap) {
+            return v;
+        } else {
+            __m512i checked;
+                if constexpr (policy == OverflowPolicy::Saturate) {
+                    checked = _mm512_min_epi64(_mm512_max_epi64(v, _mm512_set1_epi64(INT32_MIN)),
+                                               _mm512_set1_epi64(INT32_MAX));
+                } else {
+                    checked = _mm512_cvtepi32_epi64(_mm512_cvtepi64_epi32(v));
+                }
+            const __mmask8 overflowed = _mm512_cmpneq_epi64_mask(v, checked);
+            overflows =
+                _mm512_mask_add_epi64(overflows, overflowed, overflows, _mm512_set1_epi64(1));
+            return checked;
+        }
+}
+
+/**
+ * @brief Add the overflows counted in the 8 lanes of overflows to the counter of Fixed.
+ */
+template <typename Fixed>
+__attribute__((target("avx512f"))) inline void
+fixedFlushAVX512(const __m512i &overflows) {
+        if constexpr (FixedKernelTraits<Fixed>::policy != OverflowPolicy::Wrap) {
+            alignas(64) std::uint64_t lanes[8];
+            _mm512_store_si512(lanes, overflows);
+            std::uint64_t sum = 0;
+                for (const std::uint64_t &lane : lanes) {
+                    sum += lane;
+                }
+            Fixed::addOverflows(sum);
+    }
+}
+
+/**
+ * @brief Add 8 pairs of fixed-point values.
+ */
+template <typename Fixed>
+__attribute__((target("avx512f"))) inline __m512i
+fixedAddAVX512(const __m512i &a, const __m512i &b, __m512i &overflows) {
+    return fixedCheckAVX512<Fixed>(_mm512_add_epi64(a, b), overflows);
+}
+
+/**
+ * @brief Subtract 8 pairs of fixed-point values.
+ */
+template <typename Fixed>
+__attribute__((target("avx512f"))) inline __m512i
+fixedSubAVX512(const __m512i &a, const __m512i &b, __m512i &overflows) {
+    return fixedCheckAVX512<Fixed>(_mm512_sub_epi64(a, b), overflows);
+}
+
+/**
+ * @brief Multiply 8 pairs of fixed-point values as fpm does, without checking the results, see
+ * fixedProductAVX2().
+ */
+template <typename Fixed>
+__attribute__((target("avx512f"))) inline __m512i
+fixedProductAVX512(const __m512i &a, const __m512i &b) {
+    using Traits              = FixedKernelTraits<Fixed>;
+    const __m512i   product   = _mm512_mul_epi32(a, b);
+    const __mmask8  negative  = _mm512_cmplt_epi64_mask(product, _mm512_setzero_si512());
+    __m512i         magnitude = _mm512_abs_epi64(product);
+        if constexpr (Traits::rounding) {
+            magnitude =
+                _mm512_add_epi64(magnitude, _mm512_set1_epi64(1ll << (Traits::fractionBits - 1)));
+    }
+    magnitude = _mm512_srli_epi64(magnitude, Traits::fractionBits);
+    return _mm512_mask_sub_epi64(magnitude, negative, _mm512_setzero_si512(), magnitude);
+}
+
+/**
+ * @brief Multiply 8 pairs of fixed-point values as fpm does.
+ */
+template <typename Fixed>
+__attribute__((target("avx512f"))) inline __m512i
+fixedMulAVX512(const __m512i &a, const __m512i &b, __m512i &overflows) {
+    return fixedCheckAVX512<Fixed>(fixedProductAVX512<Fixed>(a, b), overflows);
+}
+
+/**
+ * @brief Multiply 8 fixed-point values by the integer factor, see fixedMulIntAVX2().
+ */
+template <typename Fixed>
+__attribute__((target("avx512f"))) inline __m512i
+fixedMulIntAVX512(const __m512i &a, const __m512i &factor, __m512i &overflows) {
+    return fixedCheckAVX512<Fixed>(_mm512_mul_epi32(a, factor), overflows);
+}
+#    pragma GCC diagnostic pop
+
+/**
+ * @brief AVX2 version of updateParticlesScalar() for the fixed-point types, processing 4
+ * particles at once.
+ * @details The random factors are in [0, 1), so their products are not checked.
+ */
+template <typename Fixed>
+__attribute__((target("avx2"))) inline void
+updateParticlesFixedAVX2(const unsigned int &n,
+                         const Fixed        &w,
+                         const Fixed        &c,
+                         const Fixed        &s,
+                         const Fixed        &g,
+                         Fixed *__restrict x,
+                         Fixed *__restrict v,
+                         const Fixed *__restrict p,
+                         const Fixed *__restrict rc,
+                         const Fixed *__restrict rs) {
+    const __m256i vw        = _mm256_set1_epi64x(w.raw_value());
+    const __m256i vc        = _mm256_set1_epi64x(c.raw_value());
+    const __m256i vs        = _mm256_set1_epi64x(s.raw_value());
+    const __m256i vg        = _mm256_set1_epi64x(g.raw_value());
+    std::int32_t *xr        = rawValues(x);
+    std::int32_t *vr        = rawValues(v);
+    __m256i       overflows = _mm256_setzero_si256();
+    unsigned int  j         = 0;
+        for (; j + 4 <= n; j += 4) {
+            const __m256i xj        = fixedLoadAVX2(xr + j);
+            const __m256i inertia   = fixedMulAVX2<Fixed>(vw, fixedLoadAVX2(vr + j), overflows);
+            const __m256i cognitive = fixedMulAVX2<Fixed>(
+                fixedProductAVX2<Fixed>(vc, fixedLoadAVX2(rawValues(rc + j))),
+                fixedSubAVX2<Fixed>(fixedLoadAVX2(rawValues(p + j)), xj, overflows),
+                overflows);
+            const __m256i social = fixedMulAVX2<Fixed>(
+                fixedProductAVX2<Fixed>(vs, fixedLoadAVX2(rawValues(rs + j))),
+                fixedSubAVX2<Fixed>(vg, xj, overflows),
+                overflows);
+            const __m256i vj = fixedAddAVX2<Fixed>(
+                fixedAddAVX2<Fixed>(inertia, cognitive, overflows), social, overflows);
+            fixedStoreAVX2(vr + j, vj);
+            fixedStoreAVX2(xr + j, fixedAddAVX2<Fixed>(xj, vj, overflows));
+        }
+    fixedFlushAVX2<Fixed>(overflows);
+    updateParticlesScalar(n - j, w, c, s, g, x + j, v + j, p + j, rc + j, rs + j);
+}
+
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+/**
+ * @brief AVX-512 version of updateParticlesScalar() for the fixed-point types, processing 8
+ * particles at once.
+ */
+template <typename Fixed>
+__attribute__((target("avx512f"))) inline void
+updateParticlesFixedAVX512(const unsigned int &n,
+                           const Fixed        &w,
+                           const Fixed        &c,
+                           const Fixed        &s,
+                           const Fixed        &g,
+                           Fixed *__restrict x,
+                           Fixed *__restrict v,
+                           const Fixed *__restrict p,
+                           const Fixed *__restrict rc,
+                           const Fixed *__restrict rs) {
+    const __m512i vw        = _mm512_set1_epi64(w.raw_value());
+    const __m512i vc        = _mm512_set1_epi64(c.raw_value());
+    const __m512i vs        = _mm512_set1_epi64(s.raw_value());
+    const __m512i vg        = _mm512_set1_epi64(g.raw_value());
+    std::int32_t *xr        = rawValues(x);
+    std::int32_t *vr        = rawValues(v);
+    __m512i       overflows = _mm512_setzero_si512();
+    unsigned int  j         = 0;
+        for (; j + 8 <= n; j += 8) {
+            const __m512i xj      = fixedLoadAVX512(xr + j);
+            const __m512i inertia = fixedMulAVX512<Fixed>(vw, fixedLoadAVX512(vr + j), overflows);
+            const __m512i cognitive = fixedMulAVX512<Fixed>(
+                fixedProductAVX512<Fixed>(vc, fixedLoadAVX512(rawValues(rc + j))),
+                fixedSubAVX512<Fixed>(fixedLoadAVX512(rawValues(p + j)), xj, overflows),
+                overflows);
+            const __m512i social = fixedMulAVX512<Fixed>(
+                fixedProductAVX512<Fixed>(vs, fixedLoadAVX512(rawValues(rs + j))),
+                fixedSubAVX512<Fixed>(vg, xj, overflows),
+                overflows);
+            const __m512i vj = fixedAddAVX512<Fixed>(
+                fixedAddAVX512<Fixed>(inertia, cognitive, overflows), social, overflows);
+            fixedStoreAVX512(vr + j, vj);
+            fixedStoreAVX512(xr + j, fixedAddAVX512<Fixed>(xj, vj, overflows));
+        }
+    fixedFlushAVX512<Fixed>(overflows);
+    updateParticlesScalar(n - j, w, c, s, g, x + j, v + j, p + j, rc + j, rs + j);
+}
+#    pragma GCC diagnostic pop
+#endif
+
+/**
+ * @brief Velocity and position update kernels for the fixed-point types of FixedKernelTraits.
+ */
+template <typename Fixed>
+struct FixedUpdateKernel {
+    using Function = void (*)(const unsigned int &,
+                              const Fixed &,
+                              const Fixed &,
+                              const Fixed &,
+                              const Fixed &,
+                              Fixed *,
+                              Fixed *,
+                              const Fixed *,
+                              const Fixed *,
+                              const Fixed *);
+
+    static Function
+    select(const SimdLevel &level) {
+#ifdef PSO_X86_KERNELS
+            switch (level) {
+                case SimdLevel::AVX512:
+                    return &updateParticlesFixedAVX512<Fixed>;
+                case SimdLevel::AVX2:
+                    return &updateParticlesFixedAVX2<Fixed>;
+                default:
+                    break;
+            }
+#endif
+        return &updateParticlesScalar<Fixed>;
+    }
+};
+
+template <unsigned int FractionBits, bool Rounding>
+struct UpdateKernel<Fixed32<FractionBits, Rounding>>
+    : FixedUpdateKernel<Fixed32<FractionBits, Rounding>> {};
+
+template <unsigned int FractionBits, bool Rounding, OverflowPolicy Policy>
+struct UpdateKernel<CheckedFixed<Fixed32<FractionBits, Rounding>, Policy>>
+    : FixedUpdateKernel<CheckedFixed<Fixed32<FractionBits, Rounding>, Policy>> {};
+
+/**
+ * @brief Velocity clamping and boundary handling kernels for the fixed-point types of
+ * FixedKernelTraits, which run the generic loops on the raw values with 64-bit intermediates: the
+ * results are exact and then saturated to 32 bits, so they never overflow. The loops compiled for
+ * AVX2 and AVX-512 are vectorized as integer minimums, maximums and blends, the others are not.
+ */
+template <typename Fixed>
+struct FixedBoundaryKernel {
+    static void
+    clampVelocities(const SimdLevel    &level,
+                    const unsigned int &n,
+                    const Fixed        &vmax,
+                    Fixed              *x,
+                    Fixed              *v) {
+        BoundaryLoops<std::int32_t, std::int64_t>::clampVelocities(
+            level, n, vmax.raw_value(), rawValues(x), rawValues(v));
+    }
+
+    static void
+    enforceBounds(const SimdLevel      &level,
+                  const BoundaryPolicy &policy,
+                  const unsigned int   &n,
+                  const Fixed          &lower,
+                  const Fixed          &upper,
+                  Fixed                *x,
+                  Fixed                *v,
+                  const Fixed          *fresh) {
+        BoundaryLoops<std::int32_t, std::int64_t>::enforceBounds(level,
+                                                                 policy,
+                                                                 n,
+                                                                 lower.raw_value(),
+                                                                 upper.raw_value(),
+                                                                 rawValues(x),
+                                                                 rawValues(v),
+                                                                 rawValues(fresh));
+    }
+};
+
+template <unsigned int FractionBits, bool Rounding>
+struct BoundaryKernel<Fixed32<FractionBits, Rounding>>
+    : FixedBoundaryKernel<Fixed32<FractionBits, Rounding>> {};
+
+template <unsigned int FractionBits, bool Rounding, OverflowPolicy Policy>
+struct BoundaryKernel<CheckedFixed<Fixed32<FractionBits, Rounding>, Policy>>
+    : FixedBoundaryKernel<CheckedFixed<Fixed32<FractionBits, Rounding>, Policy>> {};
+
+/**
+ * @brief Scalar versions of the objective kernels, which also process the remainders of the
+ * vectorized ones. pow(x, 2) is computed as x * x, which is what fpm::pow computes.
+ */
+template <typename Fixed>
+inline void
+fixedAddSquaresScalar(const unsigned int &n, const Fixed *x, Fixed *out) {
+        for (unsigned int j = 0; j < n; j++) {
+            out[j] += x[j] * x[j];
+        }
+}
+
+template <typename Fixed>
+inline void
+fixedAddRosenbrockScalar(const unsigned int &n, const Fixed *xi, const Fixed *xi1, Fixed *out) {
+        for (unsigned int j = 0; j < n; j++) {
+            const Fixed a = xi1[j] - xi[j] * xi[j];
+            const Fixed b = 1 - xi[j];
+            out[j] += 100 * (a * a) + b * b;
+        }
+}
+
+template <typename Fixed>
+inline void
+fixedQuadraticFormScalar(const unsigned int &n,
+                         const Fixed        &c1,
+                         const Fixed        &c2,
+                         const Fixed        *x0,
+                         const Fixed        *x1,
+                         Fixed              *out) {
+        for (unsigned int j = 0; j < n; j++) {
+            out[j] = c1 * (x0[j] * x0[j] + x1[j] * x1[j]) - c2 * x0[j] * x1[j];
+        }
+}
+
+#ifdef PSO_X86_KERNELS
+/**
+ * @brief AVX2 version of fixedAddSquaresScalar().
+ */
+template <typename Fixed>
+__attribute__((target("avx2"))) inline void
+fixedAddSquaresAVX2(const unsigned int &n, const Fixed *x, Fixed *out) {
+    const std::int32_t *xr        = rawValues(x);
+    std::int32_t       *o         = rawValues(out);
+    __m256i             overflows = _mm256_setzero_si256();
+    unsigned int        j         = 0;
+        for (; j + 4 <= n; j += 4) {
+            const __m256i xj = fixedLoadAVX2(xr + j);
+            fixedStoreAVX2(o + j,
+                           fixedAddAVX2<Fixed>(fixedLoadAVX2(o + j),
+                                               fixedMulAVX2<Fixed>(xj, xj, overflows),
+                                               overflows));
+        }
+    fixedFlushAVX2<Fixed>(overflows);
+    fixedAddSquaresScalar(n - j, x + j, out + j);
+}
+
+/**
+ * @brief AVX2 version of fixedAddRosenbrockScalar().
+ */
+template <typename Fixed>
+__attribute__((target("avx2"))) inline void
+fixedAddRosenbrockAVX2(const unsigned int &n, const Fixed *xi, const Fixed *xi1, Fixed *out) {
+    const __m256i       one       = _mm256_set1_epi64x(Fixed{1}.raw_value());
+    const __m256i       hundred   = _mm256_set1_epi64x(100);
+    const std::int32_t *xr        = rawValues(xi);
+    const std::int32_t *x1r       = rawValues(xi1);
+    std::int32_t       *o         = rawValues(out);
+    __m256i             overflows = _mm256_setzero_si256();
+    unsigned int        j         = 0;
+        for (; j + 4 <= n; j += 4) {
+            const __m256i x = fixedLoadAVX2(xr + j);
+            const __m256i a = fixedSubAVX2<Fixed>(
+                fixedLoadAVX2(x1r + j), fixedMulAVX2<Fixed>(x, x, overflows), overflows);
+            const __m256i b    = fixedSubAVX2<Fixed>(one, x, overflows);
+            const __m256i term = fixedAddAVX2<Fixed>(
+                fixedMulIntAVX2<Fixed>(fixedMulAVX2<Fixed>(a, a, overflows), hundred, overflows),
+                fixedMulAVX2<Fixed>(b, b, overflows),
+                overflows);
+            fixedStoreAVX2(o + j, fixedAddAVX2<Fixed>(fixedLoadAVX2(o + j), term, overflows));
+        }
+    fixedFlushAVX2<Fixed>(overflows);
+    fixedAddRosenbrockScalar(n - j, xi + j, xi1 + j, out + j);
+}
+
+/**
+ * @brief AVX2 version of fixedQuadraticFormScalar().
+ */
+template <typename Fixed>
+__attribute__((target("avx2"))) inline void
+fixedQuadraticFormAVX2(const unsigned int &n,
+                       const Fixed        &c1,
+                       const Fixed        &c2,
+                       const Fixed        *x0,
+                       const Fixed        *x1,
+                       Fixed              *out) {
+    const __m256i       vc1       = _mm256_set1_epi64x(c1.raw_value());
+    const __m256i       vc2       = _mm256_set1_epi64x(c2.raw_value());
+    const std::int32_t *x0r       = rawValues(x0);
+    const std::int32_t *x1r       = rawValues(x1);
+    std::int32_t       *o         = rawValues(out);
+    __m256i             overflows = _mm256_setzero_si256();
+    unsigned int        j         = 0;
+        for (; j + 4 <= n; j += 4) {
+            const __m256i a       = fixedLoadAVX2(x0r + j);
+            const __m256i b       = fixedLoadAVX2(x1r + j);
+            const __m256i squares = fixedAddAVX2<Fixed>(fixedMulAVX2<Fixed>(a, a, overflows),
+                                                        fixedMulAVX2<Fixed>(b, b, overflows),
+                                                        overflows);
+            fixedStoreAVX2(
+                o + j,
+                fixedSubAVX2<Fixed>(
+                    fixedMulAVX2<Fixed>(vc1, squares, overflows),
+                    fixedMulAVX2<Fixed>(fixedMulAVX2<Fixed>(vc2, a, overflows), b, overflows),
+                    overflows));
+        }
+    fixedFlushAVX2<Fixed>(overflows);
+    fixedQuadraticFormScalar(n - j, c1, c2, x0 + j, x1 + j, out + j);
+}
+
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+/**
+ * @brief AVX-512 version of fixedAddSquaresScalar().
+ */
+template <typename Fixed>
+__attribute__((target("avx512f"))) inline void
+fixedAddSquaresAVX512(const unsigned int &n, const Fixed *x, Fixed *out) {
+    const std::int32_t *xr        = rawValues(x);
+    std::int32_t       *o         = rawValues(out);
+    __m512i             overflows = _mm512_setzero_si512();
+    unsigned int        j         = 0;
+        for (; j + 8 <= n; j += 8) {
+            const __m512i xj = fixedLoadAVX512(xr + j);
+            fixedStoreAVX512(o + j,
+                             fixedAddAVX512<Fixed>(fixedLoadAVX512(o + j),
+                                                   fixedMulAVX512<Fixed>(xj, xj, overflows),
+                                                   overflows));
+        }
+    fixedFlushAVX512<Fixed>(overflows);
+    fixedAddSquaresScalar(n - j, x + j, out + j);
+}
+
+/**
+ * @brief AVX-512 version of fixedAddRosenbrockScalar().
+ */
+template <typename Fixed>
+__attribute__((target("avx512f"))) inline void
+fixedAddRosenbrockAVX512(const unsigned int &n, const Fixed *xi, const Fixed *xi1, Fixed *out) {
+    const __m512i       one       = _mm512_set1_epi64(Fixed{1}.raw_value());
+    const __m512i       hundred   = _mm512_set1_epi64(100);
+    const std::int32_t *xr        = rawValues(xi);
+    const std::int32_t *x1r       = rawValues(xi1);
+    std::int32_t       *o         = rawValues(out);
+    __m512i             overflows = _mm512_setzero_si512();
+    unsigned int        j         = 0;
+        for (; j + 8 <= n; j += 8) {
+            const __m512i x = fixedLoadAVX512(xr + j);
+            const __m512i a = fixedSubAVX512<Fixed>(
+                fixedLoadAVX512(x1r + j), fixedMulAVX512<Fixed>(x, x, overflows), overflows);
+            const __m512i b    = fixedSubAVX512<Fixed>(one, x, overflows);
+            const __m512i term = fixedAddAVX512<Fixed>(
+                fixedMulIntAVX512<Fixed>(
+                    fixedMulAVX512<Fixed>(a, a, overflows), hundred, overflows),
+                fixedMulAVX512<Fixed>(b, b, overflows),
+                overflows);
+            fixedStoreAVX512(o + j, fixedAddAVX512<Fixed>(fixedLoadAVX512(o + j), term, overflows));
+        }
+    fixedFlushAVX512<Fixed>(overflows);
+    fixedAddRosenbrockScalar(n - j, xi + j, xi1 + j, out + j);
+}
+
+/**
+ * @brief AVX-512 version of fixedQuadraticFormScalar().
+ */
+template <typename Fixed>
+__attribute__((target("avx512f"))) inline void
+fixedQuadraticFormAVX512(const unsigned int &n,
+                         const Fixed        &c1,
+                         const Fixed        &c2,
+                         const Fixed        *x0,
+                         const Fixed        *x1,
+                         Fixed              *out) {
+    const __m512i       vc1       = _mm512_set1_epi64(c1.raw_value());
+    const __m512i       vc2       = _mm512_set1_epi64(c2.raw_value());
+    const std::int32_t *x0r       = rawValues(x0);
+    const std::int32_t *x1r       = rawValues(x1);
+    std::int32_t       *o         = rawValues(out);
+    __m512i             overflows = _mm512_setzero_si512();
+    unsigned int        j         = 0;
+        for (; j + 8 <= n; j += 8) {
+            const __m512i a       = fixedLoadAVX512(x0r + j);
+            const __m512i b       = fixedLoadAVX512(x1r + j);
+            const __m512i squares = fixedAddAVX512<Fixed>(fixedMulAVX512<Fixed>(a, a, overflows),
+                                                          fixedMulAVX512<Fixed>(b, b, overflows),
+                                                          overflows);
+            fixedStoreAVX512(
+                o + j,
+                fixedSubAVX512<Fixed>(
+                    fixedMulAVX512<Fixed>(vc1, squares, overflows),
+                    fixedMulAVX512<Fixed>(fixedMulAVX512<Fixed>(vc2, a, overflows), b, overflows),
+                    overflows));
+        }
+    fixedFlushAVX512<Fixed>(overflows);
+    fixedQuadraticFormScalar(n - j, c1, c2, x0 + j, x1 + j, out + j);
+}
+#    pragma GCC diagnostic pop
+#endif
+
+/**
+ * @brief Add the square of x[j] to out[j], for j from 0 to n - 1, with the arithmetic of fpm.
+ * @details Vectorized with the instruction set level for the types of FixedKernelTraits, and
+ * computed by a scalar loop for any other arithmetic type. Used by the sum of the squares, i.e.
+ * function 1.
+ */
+template <typename Fixed>
+inline void
+fixedAddSquares(const SimdLevel &level, const unsigned int &n, const Fixed *x, Fixed *out) {
+#ifdef PSO_X86_KERNELS
+        if constexpr (FixedKernelTraits<Fixed>::vectorized) {
+                switch (level) {
+                    case SimdLevel::AVX512:
+                        fixedAddSquaresAVX512(n, x, out);
+                        return;
+                    case SimdLevel::AVX2:
+                        fixedAddSquaresAVX2(n, x, out);
+                        return;
+                    default:
+                        break;
+                }
+    }
+#endif
+    fixedAddSquaresScalar(n, x, out);
+}
+
+/**
+ * @brief Add the Rosenbrock term 100 (xi1[j] - xi[j]^2)^2 + (1 - xi[j])^2 to out[j], for j from 0
+ * to n - 1, with the arithmetic of fpm.
+ */
+template <typename Fixed>
+inline void
+fixedAddRosenbrock(const SimdLevel    &level,
+                   const unsigned int &n,
+                   const Fixed        *xi,
+                   const Fixed        *xi1,
+                   Fixed              *out) {
+#ifdef PSO_X86_KERNELS
+        if constexpr (FixedKernelTraits<Fixed>::vectorized) {
+                switch (level) {
+                    case SimdLevel::AVX512:
+                        fixedAddRosenbrockAVX512(n, xi, xi1, out);
+                        return;
+                    case SimdLevel::AVX2:
+                        fixedAddRosenbrockAVX2(n, xi, xi1, out);
+                        return;
+                    default:
+                        break;
+                }
+    }
+#endif
+    fixedAddRosenbrockScalar(n, xi, xi1, out);
+}
+
+/**
+ * @brief Set out[j] to c1 (x0[j]^2 + x1[j]^2) - c2 x0[j] x1[j], for j from 0 to n - 1, with the
+ * arithmetic of fpm. Used by function 2.
+ */
+template <typename Fixed>
+inline void
+fixedQuadraticForm(const SimdLevel    &level,
+                   const unsigned int &n,
+                   const Fixed        &c1,
+                   const Fixed        &c2,
+                   const Fixed        *x0,
+                   const Fixed        *x1,
+                   Fixed              *out) {
+#ifdef PSO_X86_KERNELS
+        if constexpr (FixedKernelTraits<Fixed>::vectorized) {
+                switch (level) {
+                    case SimdLevel::AVX512:
+                        fixedQuadraticFormAVX512(n, c1, c2, x0, x1, out);
+                        return;
+                    case SimdLevel::AVX2:
+                        fixedQuadraticFormAVX2(n, c1, c2, x0, x1, out);
+                        return;
+                    default:
+                        break;
+                }
+    }
+#endif
+    fixedQuadraticFormScalar(n, c1, c2, x0, x1, out);
+}
+
+#endif
@@ -0,0 +1,248 @@
+#ifndef FIXED_POINT_HPP
+#define FIXED_POINT_HPP
+
+#include "fpm/include/fpm/fixed.hpp"
+#include "fpm/include/fpm/ios.hpp"
+#include "fpm/include/fpm/math.hpp"
+
+#include "CheckedFixed.hpp"
+#include "DynamicRange.hpp"
+#include "Philox.hpp"
+
+#include <cctype>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Number of integer bits to be used.
+ */
+const unsigned int integer_bits = 16;
+/**
+ * @brief Number of fractional bits to be used.
+ */
+const unsigned int fractional_bits = 16;
+
+#ifndef PSO_OVERFLOW_POLICY
+/**
+ * @brief Overflow policy of the fixed-point type, i.e. Wrap, Saturate or Trap (see
+ * OverflowPolicy). Set by the PSO_OVERFLOW_POLICY option of CMake.
+ */
+#    define PSO_OVERFLOW_POLICY Saturate
+#endif
+
+/**
+ * @brief Signed integer type twice as wide as Storage, which holds the exact intermediate results
+ * of the operations of the fixed-point types stored in Storage.
+ */
+template <typename Storage>
+struct FixedIntermediate;
+
+template <>
+struct FixedIntermediate<std::int16_t> {
+    using type = std::int32_t;
+};
+
+template <>
+struct FixedIntermediate<std::int32_t> {
+    using type = std::int64_t;
+};
+
+template <>
+struct FixedIntermediate<std::int64_t> {
+    // GCC and Clang extension.
+    using type = __int128;
+};
+
+/**
+ * @brief Fixed-point type stored in the signed integer type Storage, with FractionBits fractional
+ * bits, i.e. the Q-format Q(8 sizeof(Storage) - FractionBits).(FractionBits).
+ * Results that do not fit are handled according to PSO_OVERFLOW_POLICY.
+ */
+template <typename Storage, unsigned int FractionBits>
+using FixedFormat =
+    CheckedFixed<fpm::fixed<Storage, typename FixedIntermediate<Storage>::type, FractionBits>,
+                 OverflowPolicy::PSO_OVERFLOW_POLICY>;
+
+/**
+ * @brief Q8.8 format, stored on 16 bits: range of about ±128, resolution of 1/256.
+ */
+using Q8_8 = FixedFormat<std::int16_t, 8>;
+/**
+ * @brief Q8.24 format, stored on 32 bits: range of about ±128, resolution of 2^-24.
+ */
+using Q8_24 = FixedFormat<std::int32_t, 24>;
+/**
+ * @brief Q16.16 format, stored on 32 bits: range of about ±32768, resolution of 2^-16.
+ */
+using Q16_16 = FixedFormat<std::int32_t, 16>;
+/**
+ * @brief Q24.8 format, stored on 32 bits: range of about ±8388608, resolution of 1/256.
+ */
+using Q24_8 = FixedFormat<std::int32_t, 8>;
+/**
+ * @brief Q32.32 format, stored on 64 bits: range of about ±2^31, resolution of 2^-32.
+ */
+using Q32_32 = FixedFormat<std::int64_t, 32>;
+
+/**
+ * @brief Fixed-point type to be used by default.
+ * Uses integer_bits bits for the integer part and fractional_bits bits for the fractional part.
+ * Goes from -2^(integer_bits-1)+resolution to 2^(integer_bits-1)-resolution, with resolution of
+ * 1/(2^fractional_bits).
+ */
+using fixed_double = FixedFormat<std::int32_t, fractional_bits>;
+
+/**
+ * @brief Q-formats the fixed-point optimizer can run in, from the narrowest to the widest: by
+ * size of the storage first, and then by number of integer bits.
+ */
+enum class QFormat { Q8_8, Q8_24, Q16_16, Q24_8, Q32_32 };
+
+/**
+ * @brief All the formats, from the narrowest to the widest.
+ */
+constexpr QFormat qFormats[] = {
+    QFormat::Q8_8, QFormat::Q8_24, QFormat::Q16_16, QFormat::Q24_8, QFormat::Q32_32};
+
+/**
+ * @brief Get a printable name of the given format, e.g. "Q16.16".
+ */
+inline const char *
+qFormatName(const QFormat &format) {
+        switch (format) {
+            case QFormat::Q8_8:
+                return "Q8.8";
+            case QFormat::Q8_24:
+                return "Q8.24";
+            case QFormat::Q24_8:
+                return "Q24.8";
+            case QFormat::Q32_32:
+                return "Q32.32";
+            default:
+                return "Q16.16";
+        }
+}
+
+/**
+ * @brief Get the number of integer bits, sign included, of the given format.
+ */
+inline unsigned int
+qFormatIntegerBits(const QFormat &format) {
+        switch (format) {
+            case QFormat::Q8_8:
+            case QFormat::Q8_24:
+                return 8;
+            case QFormat::Q24_8:
+                return 24;
+            case QFormat::Q32_32:
+                return 32;
+            default:
+                return 16;
+        }
+}
+
+/**
+ * @brief Parse the name of a format, case-insensitively and with or without the "Q", e.g.
+ * "q8.24" or "24.8".
+ *
+ * @return bool Whether name is the name of a format.
+ */
+inline bool
+parseQFormat(std::string name, QFormat &format) {
+        for (char &ch : name) {
+            ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+        }
+        if (name.empty() || name.front() != 'Q') {
+            name.insert(name.begin(), 'Q');
+    }
+        for (const QFormat &candidate : qFormats) {
+                if (name == qFormatName(candidate)) {
+                    format = candidate;
+                    return true;
+            }
+        }
+    return false;
+}
+
+/**
+ * @brief Call function with a value of the fixed-point type of the given format, so that a generic
+ * lambda can be instantiated for the format selected at run time.
+ */
+template <typename Function>
+void
+visitQFormat(const QFormat &format, const Function &function) {
+        switch (format) {
+            case QFormat::Q8_8:
+                function(Q8_8{});
+                return;
+            case QFormat::Q8_24:
+                function(Q8_24{});
+                return;
+            case QFormat::Q24_8:
+                function(Q24_8{});
+                return;
+            case QFormat::Q32_32:
+                function(Q32_32{});
+                return;
+            default:
+                function(Q16_16{});
+                return;
+        }
+}
+
+/**
+ * @brief Get the narrowest format that represents the given dynamic range, with the given
+ * headroom (see DynamicRange::integerBits()), or the widest one if none does.
+ */
+inline QFormat
+narrowestQFormat(const DynamicRange &range, const double &headroom = 2.0) {
+    const unsigned int bits = range.integerBits(headroom);
+        for (const QFormat &candidate : qFormats) {
+                if (qFormatIntegerBits(candidate) >= bits) {
+                    return candidate;
+            }
+        }
+    return QFormat::Q32_32;
+}
+
+/**
+ * @brief Resolution of the fixed-point type.
+ */
+const fixed_double resolution{1. / (1 << fractional_bits)};
+
+/**
+ * @brief Maximum value of the fixed-point type.
+ */
+const fixed_double max_fixed{(1 << (integer_bits - 1)) - resolution};
+
+/**
+ * @brief Minimum value of the fixed-point type.
+ */
+const fixed_double min_fixed = -(max_fixed);
+
+/**
+ * @brief Conversion of random words to fixed-point values uniformly distributed in [0, 1).
+ * @details The FractionBits most significant random bits become the fractional part of the raw
+ * value, so that random fixed-point values of any Q-format are generated with integer operations
+ * only.
+ */
+template <typename BaseType, typename IntermediateType, unsigned int FractionBits, bool Rounding>
+struct UniformFromBits<fpm::fixed<BaseType, IntermediateType, FractionBits, Rounding>> {
+    static_assert(FractionBits > 0 && FractionBits < 8 * sizeof(BaseType) && FractionBits <= 64,
+                  "the fixed-point type must be able to represent [0, 1)");
+
+    static constexpr unsigned int bits = FractionBits;
+
+    static fpm::fixed<BaseType, IntermediateType, FractionBits, Rounding>
+    convert(const std::uint32_t &hi, const std::uint32_t &lo) {
+        using Fixed = fpm::fixed<BaseType, IntermediateType, FractionBits, Rounding>;
+            if constexpr (FractionBits <= 32) {
+                return Fixed::from_raw_value(static_cast<BaseType>(hi >> (32 - FractionBits)));
+            } else {
+                const std::uint64_t word = (static_cast<std::uint64_t>(hi) << 32) | lo;
+                return Fixed::from_raw_value(static_cast<BaseType>(word >> (64 - FractionBits)));
+            }
+    }
+};
+
+#endif
@@ -1,6 +1,141 @@
+#include "Calibration.hpp"
+#include "FixedFunctions.hpp"
+#include "FixedPoint.hpp"
 #include "PSO.hpp"
 
 #include <iomanip>
+#include <iostream>
+#include <memory>
+#include <type_traits>
+
+/**
+ * @brief Minimize func with a PSO whose arithmetic is the fixed-point type Fixed and whose number
+ * of dimensions is fixed to Dims, and print the result. If trajectoryPath is not empty, the
+ * trajectory of the swarm is recorded to it.
+ */
+template <typename Fixed, unsigned int Dims, typename Objective>
+void
+solve(const Objective     &func,
+      const unsigned int  &numParticles,
+      const unsigned int  &dimensions,
+      const double        &upperBound,
+      const double        &lowerBound,
+      const double        &w,
+      const double        &c,
+      const double        &s,
+      const unsigned int  &maxIterations,
+      const unsigned int  &numThreads,
+      const ExecutionMode &mode,
+      const std::string   &function,
+      const std::string   &trajectoryPath) {
+    std::cout << "Maximum value of the fixed-point type: " << std::numeric_limits<Fixed>::max()
+              << std::endl;
+    std::cout << "Minimum value of the fixed-point type: " << std::numeric_limits<Fixed>::lowest()
+              << std::endl;
+    std::cout << "Resolution of the fixed-point type: " << std::numeric_limits<Fixed>::epsilon()
+              << std::endl;
+    PSO<Fixed, Dims, Objective> pso(numParticles,
+                                    dimensions,
+                                    func,
+                                    Fixed{upperBound},
+                                    Fixed{lowerBound},
+                                    Fixed{w},
+                                    Fixed{c},
+                                    Fixed{s},
+                                    maxIterations,
+                                    numThreads);
+    pso.setExecutionMode(mode);
+    pso.setProgressCallback([](const auto &progress) { progress.print(std::cout); });
+    std::unique_ptr<TrajectoryWriter<Fixed>> trajectory;
+        if (!trajectoryPath.empty()) {
+            trajectory = std::make_unique<TrajectoryWriter<Fixed>>(trajectoryPath,
+                                                                   dimensions,
+                                                                   numParticles,
+                                                                   maxIterations,
+                                                                   lowerBound,
+                                                                   upperBound,
+                                                                   function);
+            pso.setTrajectoryWriter(trajectory.get());
+    }
+    typename PSO<Fixed, Dims, Objective>::Result result;
+        try {
+            std::cout << "=================================================================="
+                      << std::endl;
+            std::cout << "===== Initializing particles..." << std::endl;
+            pso.initializeParticles();
+            std::cout << "===== Initialization done" << std::endl;
+            std::cout << "=================================================================="
+                      << std::endl;
+            std::cout << "===== Starting the algorithm..." << std::endl;
+            result = pso.run();
+        } catch (const std::overflow_error &e) {
+            std::cout << "===== Stopped by an overflow: " << e.what() << std::endl;
+            return;
+        }
+    // Report a failed write of the trajectory, which the destructor would ignore.
+        if (trajectory) {
+            trajectory->close();
+    }
+    std::cout << "===== Algorithm finished!" << std::endl;
+    result.print(std::cout);
+    std::cout << "Best score: " << result.bestScore << std::endl;
+    std::cout << "Best position: ";
+        for (auto x : result.bestPosition) {
+            std::cout << x << " ";
+        }
+    std::cout << std::endl;
+}
+
+/**
+ * @brief Minimize func in the fixed-point type Fixed and print the result.
+ * @details 2-D problems are solved by a PSO specialized for 2 dimensions, so that the loops over
+ * the dimensions are fully unrolled; any other number of dimensions is handled at run time.
+ */
+template <typename Fixed, typename Objective>
+void
+optimize(const Objective     &func,
+         const unsigned int  &numParticles,
+         const unsigned int  &dimensions,
+         const double        &upperBound,
+         const double        &lowerBound,
+         const double        &w,
+         const double        &c,
+         const double        &s,
+         const unsigned int  &maxIterations,
+         const unsigned int  &numThreads,
+         const ExecutionMode &mode,
+         const std::string   &function,
+         const std::string   &trajectoryPath) {
+        if (dimensions == 2) {
+            solve<Fixed, 2>(func,
+                            numParticles,
+                            dimensions,
+                            upperBound,
+                            lowerBound,
+                            w,
+                            c,
+                            s,
+                            maxIterations,
+                            numThreads,
+                            mode,
+                            function,
+                            trajectoryPath);
+        } else {
+            solve<Fixed, dynamicDimensions>(func,
+                                            numParticles,
+                                            dimensions,
+                                            upperBound,
+                                            lowerBound,
+                                            w,
+                                            c,
+                                            s,
+                                            maxIterations,
+                                            numThreads,
+                                            mode,
+                                            function,
+                                            trajectoryPath);
+        }
+}
 
 int
 main(int argc, char **argv) {
@@ -10,96 +145,136 @@ main(int argc, char **argv) {
     std::cout << "===!!!=== NOTE: " << std::endl
               << "This program uses fixed-point arithmetic to perform the calculations."
               << std::endl;
-    std::cout << "Maximum value of the fixed-point type: " << max_fixed << std::endl;
-    std::cout << "Minimum value of the fixed-point type: " << min_fixed << std::endl;
-    std::cout << "Resolution of the fixed-point type: " << resolution << std::endl;
+    std::cout << "Overflow policy of the fixed-point type: "
+              << overflowPolicyName(OverflowTraits<fixed_double>::policy) << std::endl;
     std::cout << "===!!!=== END of NOTE: " << std::endl << std::endl;
     std::cout << "==================================================================" << std::endl;
 
-    unsigned int                                           numParticles  = 100;
-    unsigned int                                           dimensions    = 2;
-    unsigned int                                           maxIterations = 1000;
-    fixed_double                                           lowerBound{-5.0};
-    fixed_double                                           upperBound{5.0};
-    std::function<fixed_double(std::vector<fixed_double>)> rosenbrock =
-        [](std::vector<fixed_double> x) {
-            fixed_double sum{0.0};
-                for (int i = 0; i < x.size() - 1; i++) {
-                    sum += 100 * fpm::pow(x[i + 1] - fpm::pow(x[i], 2), 2) + fpm::pow(1 - x[i], 2);
-                }
-            return sum;
-        };
-    std::function<fixed_double(std::vector<fixed_double>)> f1 = [](std::vector<fixed_double> x) {
-        fixed_double sum{0.0};
-            for (int i = 0; i < x.size(); i++) {
-                sum += fpm::pow(x[i], 2);
-            }
-        return sum;
-    };
-    std::function<fixed_double(std::vector<fixed_double>)> f2 = [](std::vector<fixed_double> x) {
-        fixed_double sum{0.0};
-        fixed_double c1{0.26};
-        fixed_double c2{0.48};
-        sum += c1 * (fpm::pow(x[0], 2) + fpm::pow(x[1], 2)) - c2 * x[0] * x[1];
-        return sum;
-    };
-    std::function<fixed_double(std::vector<fixed_double>)> f = f1;
+    unsigned int numParticles  = 100;
+    unsigned int dimensions    = 2;
+    unsigned int maxIterations = 1000;
+    unsigned int numThreads    = 1;
+    bool         async         = false;
+    bool         calibration   = false;
+    QFormat      format        = QFormat::Q16_16;
+    double       lowerBound    = -5.0;
+    double       upperBound    = 5.0;
+    std::string  function      = "f1";
+    std::string  trajectory    = "";
 
-        if (argc != 5) {
-            fixed_double lowerBound{-5.0};
-            fixed_double upperBound{5.0};
+        if (argc < 5 || argc > 9) {
             std::cout << "SETTING DEFAULT PARAMETERS:" << std::endl;
             std::cout << "Number of particles: " << numParticles << std::endl;
             std::cout << "Dimensions: " << dimensions << std::endl;
             std::cout << "Function to minimize: function 1" << std::endl;
             std::cout << "Max number of iterations: " << maxIterations << std::endl;
+            std::cout << "Number of threads: " << numThreads << std::endl;
+            std::cout << "Fixed-point format: " << qFormatName(format) << std::endl;
             std::cout << "=====> If you want to change these, please read the correct usage below."
                       << std::endl;
             std::cout << "Usage: " << argv[0]
-                      << " [numParticles] [dimensions] [function] [maxIterations]" << std::endl;
+                      << " [numParticles] [dimensions] [function] [maxIterations] (numThreads)"
+                         " (sync|async) (format|auto) (trajectoryFile)"
+                      << std::endl;
             std::cout << "Available functions: rosenbrock, f1, f2" << std::endl;
+            std::cout << "Available formats: q8.8, q8.24, q16.16, q24.8, q32.32, or auto to pick "
+                         "the narrowest one that does not overflow"
+                      << std::endl;
         } else {
-            numParticles         = std::stoi(argv[1]);
-            dimensions           = std::stoi(argv[2]);
-            std::string function = argv[3];
-            maxIterations        = std::stoi(argv[4]);
+            numParticles  = std::stoi(argv[1]);
+            dimensions    = std::stoi(argv[2]);
+            function      = argv[3];
+            maxIterations = std::stoi(argv[4]);
+                if (argc >= 6) {
+                    numThreads = std::stoi(argv[5]);
+            }
+                if (argc >= 7) {
+                    async = std::string(argv[6]).compare("async") == 0;
+            }
+                if (argc >= 8) {
+                    calibration = std::string(argv[7]).compare("auto") == 0;
+                        if (!calibration && !parseQFormat(argv[7], format)) {
+                            std::cout << "Format not recognized. Using Q16.16." << std::endl;
+                    }
+            }
+                if (argc == 9) {
+                    trajectory = argv[8];
+            }
 
             std::cout << "PARSED PARAMETERS:" << std::endl;
             std::cout << "Number of particles: " << numParticles << std::endl;
             std::cout << "Dimensions: " << dimensions << std::endl;
                 if (function.compare("rosenbrock") == 0) {
-                    f = rosenbrock;
                     std::cout << "Function chosen: Rosenbrock function." << std::endl;
                 } else if (function.compare("f1") == 0) {
-                    f = f1;
                     std::cout << "Function chosen: function 1." << std::endl;
                 } else if (function.compare("f2") == 0) {
-                    f          = f2;
                     dimensions = 2;
-                    lowerBound = fixed_double{-10.0};
-                    upperBound = fixed_double{10.0};
+                    lowerBound = -10.0;
+                    upperBound = 10.0;
                     std::cout << "Function chosen: function 2." << std::endl;
                 } else {
-                    f = f1;
+                    function = "f1";
                     std::cout << "Function not recognized. Using function 1." << std::endl;
                 }
             std::cout << "Max number of iterations: " << maxIterations << std::endl;
+            std::cout << "Number of threads: " << numThreads << std::endl;
+            std::cout << "Execution mode: " << (async ? "asynchronous" : "synchronous")
+                      << std::endl;
+            std::cout << "Fixed-point format: " << (calibration ? "auto" : qFormatName(format))
+                      << std::endl;
+                if (!trajectory.empty()) {
+                    std::cout << "Trajectory file: " << trajectory << std::endl;
+            }
         }
 
-    fixed_double w{0.75};
-    fixed_double c{1.0};
-    fixed_double s{1.0};
+    double w = 0.75;
+    double c = 1.0;
+    double s = 1.0;
 
-    std::cout << "------------------------------------------------------------------" << std::endl;
-    PSO pso = PSO(numParticles, dimensions, f, upperBound, lowerBound, w, c, s, maxIterations);
-    pso.initializeParticles();
-    pso.run();
-    std::cout << "Best score: " << pso.getBestScore() << std::endl;
-    std::cout << "Best position: ";
-        for (auto x : pso.getBestPosition()) {
-            std::cout << x << " ";
+    const ExecutionMode mode = async ? ExecutionMode::Asynchronous : ExecutionMode::Synchronous;
+
+    // Pick the format if requested, then minimize func in it.
+    const auto run = [&](const auto &func) {
+            if (calibration) {
+                format = narrowestQFormat(calibrate(func,
+                                                    numParticles,
+                                                    dimensions,
+                                                    upperBound,
+                                                    lowerBound,
+                                                    w,
+                                                    c,
+                                                    s,
+                                                    maxIterations,
+                                                    numThreads));
+                std::cout << "Fixed-point format chosen: " << qFormatName(format) << std::endl;
+        }
+        std::cout << "------------------------------------------------------------------"
+                  << std::endl;
+        visitQFormat(format, [&](const auto &zero) {
+            optimize<std::decay_t<decltype(zero)>>(func,
+                                                   numParticles,
+                                                   dimensions,
+                                                   upperBound,
+                                                   lowerBound,
+                                                   w,
+                                                   c,
+                                                   s,
+                                                   maxIterations,
+                                                   numThreads,
+                                                   mode,
+                                                   function,
+                                                   trajectory);
+        });
+    };
+
+        if (function.compare("rosenbrock") == 0) {
+            run(FixedRosenbrock{});
+        } else if (function.compare("f2") == 0) {
+            run(FixedF2{});
+        } else {
+            run(FixedF1{});
         }
-    std::cout << std::endl;
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,60 @@
+#ifndef FUNCTIONS_HPP
+#define FUNCTIONS_HPP
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Rosenbrock function, evaluated on a batch of particles.
+ */
+struct Rosenbrock {
+    template <typename View>
+    void
+    operator()(const View &x, double *out) const {
+        std::fill_n(out, x.getNumParticles(), 0.0);
+            for (unsigned int i = 0; i + 1 < x.getDimensions(); i++) {
+                const double *xi  = x.row(i);
+                const double *xi1 = x.row(i + 1);
+                    for (unsigned int j = 0; j < x.getNumParticles(); j++) {
+                        out[j] += 100.0 * std::pow(xi1[j] - std::pow(xi[j], 2), 2) +
+                                  std::pow(1.0 - xi[j], 2);
+                    }
+            }
+    }
+};
+
+/**
+ * @brief Function 1 (sum of the squares), evaluated on a batch of particles.
+ */
+struct F1 {
+    template <typename View>
+    void
+    operator()(const View &x, double *out) const {
+        std::fill_n(out, x.getNumParticles(), 0.0);
+            for (unsigned int i = 0; i < x.getDimensions(); i++) {
+                const double *xi = x.row(i);
+                    for (unsigned int j = 0; j < x.getNumParticles(); j++) {
+                        out[j] += std::pow(xi[j], 2);
+                    }
+            }
+    }
+};
+
+/**
+ * @brief Function 2, evaluated on a batch of 2-D particles.
+ */
+struct F2 {
+    template <typename View>
+    void
+    operator()(const View &x, double *out) const {
+        double        c1 = 0.26;
+        double        c2 = 0.48;
+        const double *x0 = x.row(0);
+        const double *x1 = x.row(1);
+            for (unsigned int j = 0; j < x.getNumParticles(); j++) {
+                out[j] = std::pow(x0[j], 2) + std::pow(x1[j], 2) - c2 * x0[j] * x1[j];
+            }
+    }
+};
+
+#endif
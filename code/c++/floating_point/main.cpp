@@ -1,91 +1,235 @@
+#include "Functions.hpp"
 #include "PSO.hpp"
 
+#include <iostream>
+#include <memory>
+
+/**
+ * @brief Minimize func with a PSO whose number of dimensions is fixed to Dims, and print the
+ * result. If trajectoryPath is not empty, the trajectory of the swarm is recorded to it.
+ */
+template <unsigned int Dims, typename Objective>
+void
+solve(const Objective     &func,
+      const unsigned int  &numParticles,
+      const unsigned int  &dimensions,
+      const double        &upperBound,
+      const double        &lowerBound,
+      const double        &w,
+      const double        &c,
+      const double        &s,
+      const unsigned int  &maxIterations,
+      const unsigned int  &numThreads,
+      const ExecutionMode &mode,
+      const std::string   &function,
+      const std::string   &trajectoryPath) {
+    PSO<double, Dims, Objective> pso(
+        numParticles, dimensions, func, upperBound, lowerBound, w, c, s, maxIterations, numThreads);
+    pso.setExecutionMode(mode);
+    pso.setProgressCallback([](const auto &progress) { progress.print(std::cout); });
+    std::unique_ptr<TrajectoryWriter<double>> trajectory;
+        if (!trajectoryPath.empty()) {
+            trajectory = std::make_unique<TrajectoryWriter<double>>(trajectoryPath,
+                                                                    dimensions,
+                                                                    numParticles,
+                                                                    maxIterations,
+                                                                    lowerBound,
+                                                                    upperBound,
+                                                                    function);
+            pso.setTrajectoryWriter(trajectory.get());
+    }
+    std::cout << "==================================================================" << std::endl;
+    std::cout << "===== Initializing particles..." << std::endl;
+    pso.initializeParticles();
+    std::cout << "===== Initialization done" << std::endl;
+    std::cout << "==================================================================" << std::endl;
+    std::cout << "===== Starting the algorithm..." << std::endl;
+    const auto result = pso.run();
+    // Report a failed write of the trajectory, which the destructor would ignore.
+        if (trajectory) {
+            trajectory->close();
+    }
+    std::cout << "===== Algorithm finished!" << std::endl;
+    result.print(std::cout);
+    std::cout << "Best score: " << result.bestScore << std::endl;
+    std::cout << "Best position: ";
+        for (auto x : result.bestPosition) {
+            std::cout << x << " ";
+        }
+    std::cout << std::endl;
+}
+
+/**
+ * @brief Minimize func and print the result.
+ * @details 2-D problems are solved by a PSO specialized for 2 dimensions, so that the loops over
+ * the dimensions are fully unrolled; any other number of dimensions is handled at run time.
+ */
+template <typename Objective>
+void
+optimize(const Objective     &func,
+         const unsigned int  &numParticles,
+         const unsigned int  &dimensions,
+         const double        &upperBound,
+         const double        &lowerBound,
+         const double        &w,
+         const double        &c,
+         const double        &s,
+         const unsigned int  &maxIterations,
+         const unsigned int  &numThreads,
+         const ExecutionMode &mode,
+         const std::string   &function,
+         const std::string   &trajectoryPath) {
+        if (dimensions == 2) {
+            solve<2>(func,
+                     numParticles,
+                     dimensions,
+                     upperBound,
+                     lowerBound,
+                     w,
+                     c,
+                     s,
+                     maxIterations,
+                     numThreads,
+                     mode,
+                     function,
+                     trajectoryPath);
+        } else {
+            solve<dynamicDimensions>(func,
+                                     numParticles,
+                                     dimensions,
+                                     upperBound,
+                                     lowerBound,
+                                     w,
+                                     c,
+                                     s,
+                                     maxIterations,
+                                     numThreads,
+                                     mode,
+                                     function,
+                                     trajectoryPath);
+        }
+}
+
 int
 main(int argc, char **argv) {
     // Create a PSO object with 2 dimensions, 100 particles, and a function
     // to optimize.
     std::cout << "==================================================================" << std::endl;
 
-    unsigned int                               numParticles  = 100;
-    unsigned int                               dimensions    = 2;
-    unsigned int                               maxIterations = 1000;
-    double                                     lowerBound    = -5.0;
-    double                                     upperBound    = 5.0;
-    std::function<double(std::vector<double>)> rosenbrock    = [](std::vector<double> x) {
-        double sum = 0.0;
-            for (int i = 0; i < x.size() - 1; i++) {
-                sum += 100.0 * std::pow(x[i + 1] - std::pow(x[i], 2), 2) + std::pow(1.0 - x[i], 2);
-            }
-        return sum;
-    };
-    std::function<double(std::vector<double>)> f1 = [](std::vector<double> x) {
-        double sum = 0.0;
-            for (int i = 0; i < x.size(); i++) {
-                sum += std::pow(x[i], 2);
-            }
-        return sum;
-    };
-    std::function<double(std::vector<double>)> f2 = [](std::vector<double> x) {
-        double sum = 0.0;
-        double c1  = 0.26;
-        double c2  = 0.48;
-        sum += std::pow(x[0], 2) + std::pow(x[1], 2) - c2 * x[0] * x[1];
-        return sum;
-    };
-    std::function<double(std::vector<double>)> f = f1;
+    unsigned int numParticles  = 100;
+    unsigned int dimensions    = 2;
+    unsigned int maxIterations = 1000;
+    unsigned int numThreads    = 1;
+    bool         async         = false;
+    double       lowerBound    = -5.0;
+    double       upperBound    = 5.0;
+    std::string  function      = "f1";
+    std::string  trajectory    = "";
 
-        if (argc != 5) {
+        if (argc < 5 || argc > 8) {
             std::cout << "SETTING DEFAULT PARAMETERS:" << std::endl;
             std::cout << "Number of particles: " << numParticles << std::endl;
             std::cout << "Dimensions: " << dimensions << std::endl;
             std::cout << "Function to minimize: function 1" << std::endl;
             std::cout << "Max number of iterations: " << maxIterations << std::endl;
+            std::cout << "Number of threads: " << numThreads << std::endl;
             std::cout << "=====> If you want to change these, please read the correct usage below."
                       << std::endl;
             std::cout << "Usage: " << argv[0]
-                      << " [numParticles] [dimensions] [function] [maxIterations]" << std::endl;
+                      << " [numParticles] [dimensions] [function] [maxIterations] (numThreads)"
+                         " (sync|async) (trajectoryFile)"
+                      << std::endl;
             std::cout << "Available functions: rosenbrock, f1, f2" << std::endl;
         } else {
-            numParticles         = std::stoi(argv[1]);
-            dimensions           = std::stoi(argv[2]);
-            std::string function = argv[3];
-            maxIterations        = std::stoi(argv[4]);
+            numParticles  = std::stoi(argv[1]);
+            dimensions    = std::stoi(argv[2]);
+            function      = argv[3];
+            maxIterations = std::stoi(argv[4]);
+                if (argc >= 6) {
+                    numThreads = std::stoi(argv[5]);
+            }
+                if (argc >= 7) {
+                    async = std::string(argv[6]).compare("async") == 0;
+            }
+                if (argc == 8) {
+                    trajectory = argv[7];
+            }
 
             std::cout << "PARSED PARAMETERS:" << std::endl;
             std::cout << "Number of particles: " << numParticles << std::endl;
             std::cout << "Dimensions: " << dimensions << std::endl;
                 if (function.compare("rosenbrock") == 0) {
-                    f = rosenbrock;
                     std::cout << "Function chosen: Rosenbrock function." << std::endl;
                 } else if (function.compare("f1") == 0) {
-                    f = f1;
                     std::cout << "Function chosen: function 1." << std::endl;
                 } else if (function.compare("f2") == 0) {
-                    f                 = f2;
                     dimensions        = 2;
                     double lowerBound = -10.0;
                     double upperBound = 10.0;
                     std::cout << "Function chosen: function 2." << std::endl;
                 } else {
+                    function = "f1";
                     std::cout << "Function not recognized. Using function 1." << std::endl;
                 }
             std::cout << "Max number of iterations: " << maxIterations << std::endl;
+            std::cout << "Number of threads: " << numThreads << std::endl;
+            std::cout << "Execution mode: " << (async ? "asynchronous" : "synchronous")
+                      << std::endl;
+                if (!trajectory.empty()) {
+                    std::cout << "Trajectory file: " << trajectory << std::endl;
+            }
         }
 
     double w = 0.75;
     double c = 1.0;
     double s = 1.0;
 
+    const ExecutionMode mode = async ? ExecutionMode::Asynchronous : ExecutionMode::Synchronous;
+
     std::cout << "------------------------------------------------------------------" << std::endl;
-    PSO pso = PSO(numParticles, dimensions, f, upperBound, lowerBound, w, c, s, maxIterations);
-    pso.initializeParticles();
-    pso.run();
-    std::cout << "Best score: " << pso.getBestScore() << std::endl;
-    std::cout << "Best position: ";
-        for (auto x : pso.getBestPosition()) {
-            std::cout << x << " ";
+        if (function.compare("rosenbrock") == 0) {
+            optimize(Rosenbrock{},
+                     numParticles,
+                     dimensions,
+                     upperBound,
+                     lowerBound,
+                     w,
+                     c,
+                     s,
+                     maxIterations,
+                     numThreads,
+                     mode,
+                     function,
+                     trajectory);
+        } else if (function.compare("f2") == 0) {
+            optimize(F2{},
+                     numParticles,
+                     dimensions,
+                     upperBound,
+                     lowerBound,
+                     w,
+                     c,
+                     s,
+                     maxIterations,
+                     numThreads,
+                     mode,
+                     function,
+                     trajectory);
+        } else {
+            optimize(F1{},
+                     numParticles,
+                     dimensions,
+                     upperBound,
+                     lowerBound,
+                     w,
+                     c,
+                     s,
+                     maxIterations,
+                     numThreads,
+                     mode,
+                     function,
+                     trajectory);
         }
-    std::cout << std::endl;
 
     return 0;
 }
\ No newline at end of file
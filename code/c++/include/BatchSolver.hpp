@@ -0,0 +1,521 @@
+#ifndef BATCH_SOLVER_HPP
+#define BATCH_SOLVER_HPP
+
+#include "Overflow.hpp"
+#include "Philox.hpp"
+#include "SwarmArena.hpp"
+#include "SwarmStorage.hpp"
+#include "ThreadPool.hpp"
+#include "UpdateKernels.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Definition of one of the problems solved by a BatchSolver: the box it is searched in and
+ * the coefficients of its swarm.
+ */
+template <typename Scalar>
+struct BatchProblem {
+    /**
+     * @brief Lower bound of the search space, along every dimension.
+     */
+    Scalar lowerBound;
+    /**
+     * @brief Upper bound of the search space, along every dimension.
+     */
+    Scalar upperBound;
+    /**
+     * @brief Inertia weight.
+     */
+    Scalar w;
+    /**
+     * @brief Cognitive weight coefficient.
+     */
+    Scalar c{1};
+    /**
+     * @brief Social weight coefficient.
+     */
+    Scalar s{1};
+};
+
+/**
+ * @brief Solution of one of the problems solved by a BatchSolver.
+ */
+template <typename Scalar, typename Point>
+struct BatchSolution {
+    /**
+     * @brief Best score found.
+     */
+    Scalar bestScore;
+    /**
+     * @brief Best position found.
+     */
+    Point bestPosition;
+    /**
+     * @brief Iteration during which the best score was found.
+     */
+    unsigned int bestIteration = 0;
+    /**
+     * @brief Number of arithmetic operations that overflowed while solving the group of problems
+     * this one was solved with, see BatchSolver. Always 0 for types that do not count their
+     * overflows (see OverflowTraits).
+     */
+    std::uint64_t overflows = 0;
+};
+
+/**
+ * @brief Solver of many small problems at once, each one by its own swarm.
+ * @details The problems are split into groups small enough for their swarms to stay in the cache
+ * during all the iterations, and the threads take the groups one after the other. The swarms of a
+ * group are stored one after the other in one storage: the j-th particle of the k-th problem is
+ * the particle k numParticles + j of the group. Every iteration of a group generates the random
+ * factors of all its swarms in bulk, updates every swarm with the vectorized kernel PSO uses,
+ * with the coefficients of its problem, and evaluates all the swarms with one call of the function
+ * to minimize. The storage of every thread is carved by the constructor from one SwarmArena, and
+ * reused by all the groups of every solve(), so there is no allocation, generator setup nor
+ * output per problem, which dominate the cost of solving small problems one PSO at a time.
+ * Every problem evolves as a synchronous PSO would, with its own bounds and coefficients, and the
+ * result is reproducible for a given seed, whatever the number of threads. The overflows of
+ * types that count them are counted per group, since the function is evaluated on the whole
+ * group at once.
+ *
+ * @tparam Scalar Arithmetic type used for positions, velocities and scores, see PSO.
+ * @tparam Dims Number of dimensions of the problems, or dynamicDimensions, see PSO.
+ * @tparam Objective Function minimized by every problem of the batch. It must be a batch
+ * function, callable as `void(const SwarmView<Scalar, Dims> &, Scalar *)`, or with the SimdLevel
+ * of the solver as a third argument (see setSimdLevel()), since it is evaluated on the particles
+ * of all the problems at once; problems with different functions are solved by different
+ * batches.
+ */
+template <typename Scalar,
+          unsigned int Dims = dynamicDimensions,
+          typename Objective =
+              std::function<void(const SwarmView<Scalar, Dims> &, Scalar *)>>
+class BatchSolver {
+  public:
+    static_assert(std::is_invocable_v<Objective &, const SwarmView<Scalar, Dims> &, Scalar *> ||
+                      std::is_invocable_v<Objective &,
+                                          const SwarmView<Scalar, Dims> &,
+                                          Scalar *,
+                                          const SimdLevel &>,
+                  "the function to minimize must be a batch function");
+
+    /**
+     * @brief Position of a single particle.
+     */
+    using Point = SwarmPoint<Scalar, Dims>;
+
+    /**
+     * @brief Solution of a problem, returned by solve().
+     */
+    using Solution = BatchSolution<Scalar, Point>;
+
+    /**
+     * @brief Construct a solver of the given problems.
+     *
+     * @param problems_ Problems to solve.
+     * @param numParticles_ Number of particles of the swarm of every problem.
+     * @param dimensions_ Number of dimensions of the problems. Must be equal to Dims, unless Dims
+     * is dynamicDimensions.
+     * @param func_ Function to minimize.
+     * @param maxIterations_ Number of iterations performed on every problem.
+     * @param numThreads_ Number of threads the particles are partitioned across.
+     * @param seed_ Seed of the random numbers.
+     */
+    BatchSolver(const std::vector<BatchProblem<Scalar>> &problems_,
+                const unsigned int                      &numParticles_,
+                const unsigned int                      &dimensions_,
+                const Objective                         &func_,
+                const unsigned int                      &maxIterations_ = 1000,
+                const unsigned int                      &numThreads_    = 1,
+                const std::uint64_t                     &seed_          = 42) :
+        numProblems(static_cast<unsigned int>(problems_.size())),
+        numParticles(numParticles_), dimensions(dimensions_), func(func_),
+        maxIterations(maxIterations_),
+        groupSize(numParticles_ == 0 ? 0
+                                     : std::min(numProblems,
+                                                std::max(1u, groupParticles / numParticles_))),
+        pool(std::make_unique<ThreadPool>(numThreads_)), random(seed_) {
+            if (Dims != dynamicDimensions && dimensions_ != Dims) {
+                throw std::invalid_argument(
+                    "BatchSolver: dimensions_ does not match the Dims parameter");
+        }
+            for (const BatchProblem<Scalar> &problem : problems_) {
+                lowerBounds.push_back(problem.lowerBound);
+                ranges.push_back(problem.upperBound - problem.lowerBound);
+                inertias.push_back(problem.w);
+                cognitives.push_back(problem.c);
+                socials.push_back(problem.s);
+            }
+        setSimdLevel(detectSimdLevel());
+        // Threads beyond the number of groups would never take one.
+        const unsigned int numGroups =
+            groupSize == 0 ? 0 : (numProblems + groupSize - 1) / groupSize;
+        const unsigned int numWorkspaces = std::min(pool->getNumThreads(), numGroups);
+        workspaces.reserve(numWorkspaces);
+            for (unsigned int t = 0; t < numWorkspaces; t++) {
+                workspaces.emplace_back(groupSize * numParticles, getDimensions(), groupSize);
+            }
+    }
+
+    /**
+     * @brief Initialize the swarm of every problem, run maxIterations iterations of all of them,
+     * and return their solutions, in the order of the problems.
+     * @details The particles of every problem are initialized as PSO::initializeParticles() does:
+     * uniformly in its box, with velocities up to the width of the box.
+     * @throws std::overflow_error If Scalar uses the Trap policy and an operation overflowed. The
+     * groups being solved are finished, but no other group is started.
+     */
+    std::vector<Solution>
+    solve();
+
+    /**
+     * @brief Select the instruction set used by the velocity and position update, the random
+     * numbers, and the batch functions to minimize that accept it, see PSO::setSimdLevel().
+     *
+     * @param level Instruction set to use.
+     */
+    void
+    setSimdLevel(const SimdLevel &level) {
+        simdLevel    = std::min(level, detectSimdLevel());
+        updateKernel = UpdateKernel<Scalar>::select(simdLevel);
+        random.setSimdLevel(simdLevel);
+    }
+
+    /**
+     * @brief Get the instruction set used by the solver, see setSimdLevel().
+     */
+    SimdLevel
+    getSimdLevel() const {
+        return simdLevel;
+    }
+
+    /**
+     * @brief Get the number of dimensions of the problems.
+     */
+    unsigned int
+    getDimensions() const {
+        return Dims == dynamicDimensions ? dimensions : Dims;
+    }
+
+  private:
+    /**
+     * @brief Storage of the swarms of a group of problems, see solveGroup(), carved from one
+     * arena as the swarm of a PSO.
+     */
+    struct Workspace {
+        /**
+         * @brief Allocate the storage of numParticles_ particles in total, of numProblems_
+         * problems.
+         */
+        Workspace(const unsigned int &numParticles_,
+                  const unsigned int &dimensions_,
+                  const unsigned int &numProblems_) :
+            arena(footprint(numParticles_, dimensions_, numProblems_)),
+            positions(numParticles_, dimensions_, arena),
+            velocities(numParticles_, dimensions_, arena),
+            bestPositions(numParticles_, dimensions_, arena),
+            globalBests(numProblems_, dimensions_, arena), scores(arena, numParticles_),
+            bestScores(arena, numParticles_), cognitiveFactors(arena, numParticles_),
+            socialFactors(arena, numParticles_), globalBestScores(arena, numProblems_) {}
+
+        /**
+         * @brief Get the size of the arena of a workspace.
+         */
+        static std::size_t
+        footprint(const unsigned int &numParticles_,
+                  const unsigned int &dimensions_,
+                  const unsigned int &numProblems_) {
+            return 3 * SwarmStorage<Scalar, Dims>::footprint(numParticles_, dimensions_) +
+                   SwarmStorage<Scalar, Dims>::footprint(numProblems_, dimensions_) +
+                   4 * ArenaArray<Scalar>::footprint(numParticles_) +
+                   ArenaArray<Scalar>::footprint(numProblems_);
+        }
+
+        /**
+         * @brief Arena the storage is carved from, which must outlive it.
+         */
+        SwarmArena arena;
+
+        /**
+         * @brief Positions of the particles.
+         */
+        SwarmStorage<Scalar, Dims> positions;
+        /**
+         * @brief Velocities of the particles.
+         */
+        SwarmStorage<Scalar, Dims> velocities;
+        /**
+         * @brief Personal best positions of the particles.
+         */
+        SwarmStorage<Scalar, Dims> bestPositions;
+        /**
+         * @brief Global best position of every problem, stored as one particle per problem, so
+         * that row d holds the d-th coordinate of every problem, as the update kernel reads it.
+         */
+        SwarmStorage<Scalar, Dims> globalBests;
+        /**
+         * @brief Scores of the particles.
+         */
+        ArenaArray<Scalar> scores;
+        /**
+         * @brief Personal best scores of the particles.
+         */
+        ArenaArray<Scalar> bestScores;
+        /**
+         * @brief Random factors of the cognitive component for the dimension being updated.
+         */
+        ArenaArray<Scalar> cognitiveFactors;
+        /**
+         * @brief Random factors of the social component for the dimension being updated.
+         */
+        ArenaArray<Scalar> socialFactors;
+        /**
+         * @brief Global best score of every problem.
+         */
+        ArenaArray<Scalar> globalBestScores;
+    };
+
+    /**
+     * @brief Evaluate the function to minimize on every particle of x, passing it the SimdLevel
+     * of the solver if it accepts one.
+     */
+    void
+    evaluate(const SwarmView<Scalar, Dims> &x, Scalar *out) {
+            if constexpr (std::is_invocable_v<Objective &,
+                                              const SwarmView<Scalar, Dims> &,
+                                              Scalar *,
+                                              const SimdLevel &>) {
+                func(x, out, simdLevel);
+            } else {
+                func(x, out);
+            }
+    }
+
+    /**
+     * @brief Solve the count problems starting from the first-th one, stored in workspace,
+     * and write their solutions into solutions, with the number of overflows of the calling
+     * thread while solving them.
+     */
+    void
+    solveGroup(const unsigned int    &first,
+               const unsigned int    &count,
+               Workspace             &workspace,
+               std::vector<Solution> &solutions);
+
+    /**
+     * @brief Number of particles of a group of problems, all the problems together: their
+     * storage, about 100 bytes per particle in 2 dimensions, fits in the L2 cache.
+     */
+    static constexpr unsigned int groupParticles = 2048;
+    /**
+     * @brief Number of problems.
+     */
+    const unsigned int numProblems;
+    /**
+     * @brief Number of particles of every problem.
+     */
+    const unsigned int numParticles;
+    /**
+     * @brief Number of dimensions of the problems.
+     */
+    const unsigned int dimensions;
+    /**
+     * @brief Function to minimize.
+     */
+    Objective func;
+    /**
+     * @brief Number of iterations performed on every problem.
+     */
+    const unsigned int maxIterations;
+    /**
+     * @brief Number of problems of a group, all but the last one.
+     */
+    const unsigned int groupSize;
+    /**
+     * @brief Lower bound of every problem.
+     */
+    std::vector<Scalar> lowerBounds;
+    /**
+     * @brief Width of the box of every problem.
+     */
+    std::vector<Scalar> ranges;
+    /**
+     * @brief Inertia weight of every problem.
+     */
+    std::vector<Scalar> inertias;
+    /**
+     * @brief Cognitive weight coefficient of every problem.
+     */
+    std::vector<Scalar> cognitives;
+    /**
+     * @brief Social weight coefficient of every problem.
+     */
+    std::vector<Scalar> socials;
+    /**
+     * @brief Persistent pool of threads the particles are partitioned across.
+     */
+    std::unique_ptr<ThreadPool> pool;
+    /**
+     * @brief Counter-based generator of the random numbers, keyed by the seed.
+     */
+    Philox random;
+    /**
+     * @brief Storage of the groups of every thread that takes some, built by the constructor.
+     */
+    std::vector<Workspace> workspaces;
+    /**
+     * @brief Instruction set used by the solver, see setSimdLevel().
+     */
+    SimdLevel simdLevel;
+    /**
+     * @brief Velocity and position update kernel for simdLevel.
+     */
+    typename UpdateKernel<Scalar>::Function updateKernel;
+};
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+void
+BatchSolver<Scalar, Dims, Objective>::solveGroup(const unsigned int    &first,
+                                                 const unsigned int    &count,
+                                                 Workspace             &workspace,
+                                                 std::vector<Solution> &solutions) {
+    const unsigned int m    = count;
+    const unsigned int n    = numParticles;
+    const unsigned int size = n * m;
+    // Counter of the first particle of the group: the particles of the batch are numbered
+    // problem after problem, so that every problem draws its own random numbers.
+    const unsigned int base = first * n;
+    // Overflows counted by the calling thread before the group are not the group's.
+    OverflowTraits<Scalar>::reset();
+    std::fill_n(workspace.globalBestScores.begin(), m, std::numeric_limits<Scalar>::max());
+    // The arena leaves the storage unspecified, and a problem whose scores are all the largest
+    // one never sets its global best position.
+    workspace.globalBests.fill(Scalar{});
+
+    // Update the global best of the problem of the j-th particle of the group, if it improved.
+    const auto updateGlobalBest = [&](const unsigned int &j, const unsigned int &iteration) {
+        const unsigned int k = j / n;
+            if (workspace.bestScores[j] < workspace.globalBestScores[k]) {
+                workspace.globalBestScores[k] = workspace.bestScores[j];
+                    for (unsigned int d = 0; d < getDimensions(); d++) {
+                        workspace.globalBests(d, k) = workspace.bestPositions(d, j);
+                    }
+                solutions[first + k].bestIteration = iteration;
+        }
+    };
+
+    Scalar position, velocity;
+        for (unsigned int j = 0; j < size; j++) {
+            const unsigned int k = first + j / n;
+                for (unsigned int d = 0; d < getDimensions(); d++) {
+                    random.uniform(
+                        0, base + j, d, Philox::initializationStream, position, velocity);
+                    workspace.positions(d, j)  = lowerBounds[k] + position * ranges[k];
+                    workspace.velocities(d, j) = velocity * (ranges[k] + ranges[k]) - ranges[k];
+                }
+            workspace.bestPositions.copyParticle(j, workspace.positions);
+        }
+    evaluate(workspace.positions.view(0, size), workspace.scores.data());
+    std::copy_n(workspace.scores.begin(), size, workspace.bestScores.begin());
+        for (unsigned int j = 0; j < size; j++) {
+            updateGlobalBest(j, 0);
+        }
+
+        for (unsigned int i = 0; i < maxIterations; i++) {
+                for (unsigned int d = 0; d < getDimensions(); d++) {
+                    random.fill(i,
+                                d,
+                                Philox::updateStream,
+                                base,
+                                size,
+                                workspace.cognitiveFactors.data(),
+                                workspace.socialFactors.data());
+                        for (unsigned int k = 0; k < m; k++) {
+                            const std::size_t offset = static_cast<std::size_t>(k) * n;
+                            updateKernel(n,
+                                         inertias[first + k],
+                                         cognitives[first + k],
+                                         socials[first + k],
+                                         workspace.globalBests(d, k),
+                                         workspace.positions.row(d) + offset,
+                                         workspace.velocities.row(d) + offset,
+                                         workspace.bestPositions.row(d) + offset,
+                                         workspace.cognitiveFactors.data() + offset,
+                                         workspace.socialFactors.data() + offset);
+                        }
+                }
+            evaluate(workspace.positions.view(0, size), workspace.scores.data());
+            // Visiting the particles in order keeps the first one on ties, as PSO does.
+                for (unsigned int j = 0; j < size; j++) {
+                        if (workspace.scores[j] < workspace.bestScores[j]) {
+                            workspace.bestScores[j] = workspace.scores[j];
+                            workspace.bestPositions.copyParticle(j, workspace.positions);
+                            updateGlobalBest(j, i);
+                    }
+                }
+        }
+
+    const std::uint64_t overflows = OverflowTraits<Scalar>::take();
+        for (unsigned int k = 0; k < m; k++) {
+            Solution &solution = solutions[first + k];
+            solution.bestScore = workspace.globalBestScores[k];
+            solution.overflows = overflows;
+                if constexpr (Dims == dynamicDimensions) {
+                    solution.bestPosition.resize(getDimensions());
+            }
+            workspace.globalBests.gather(k, solution.bestPosition.data());
+        }
+}
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+std::vector<typename BatchSolver<Scalar, Dims, Objective>::Solution>
+BatchSolver<Scalar, Dims, Objective>::solve() {
+    std::vector<Solution> solutions(numProblems);
+        if (numProblems == 0 || numParticles == 0) {
+            return solutions;
+    }
+    const unsigned int        numGroups = (numProblems + groupSize - 1) / groupSize;
+    std::atomic<unsigned int> next{0};
+    // First problem of the first group found to overflow, under the Trap policy.
+    std::atomic<unsigned int> trapped{numProblems};
+    pool->run([&](const unsigned int &t) {
+            if (t >= workspaces.size()) {
+                return;
+        }
+            for (unsigned int g = next.fetch_add(1, std::memory_order_relaxed); g < numGroups;
+                 g              = next.fetch_add(1, std::memory_order_relaxed)) {
+                const unsigned int first = g * groupSize;
+                solveGroup(
+                    first, std::min(groupSize, numProblems - first), workspaces[t], solutions);
+                    if constexpr (OverflowTraits<Scalar>::policy == OverflowPolicy::Trap) {
+                            if (solutions[first].overflows > 0) {
+                                unsigned int expected = numProblems;
+                                trapped.compare_exchange_strong(expected, first);
+                                next.store(numGroups, std::memory_order_relaxed);
+                        }
+                }
+            }
+    });
+        if constexpr (OverflowTraits<Scalar>::policy == OverflowPolicy::Trap) {
+                if (trapped.load() < numProblems) {
+                    const unsigned int first = trapped.load();
+                    throw std::overflow_error(std::to_string(solutions[first].overflows) +
+                                              " arithmetic overflows in the group of problem " +
+                                              std::to_string(first));
+            }
+    }
+    return solutions;
+}
+
+#endif
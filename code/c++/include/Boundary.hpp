@@ -0,0 +1,337 @@
+#ifndef BOUNDARY_HPP
+#define BOUNDARY_HPP
+
+#include "UpdateKernels.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+/**
+ * @brief What happens to the coordinates of the particles that leave the search space, see
+ * PSO::setBoundaryHandling().
+ */
+enum class BoundaryPolicy {
+    /**
+     * @brief Nothing: the particles may leave the search space.
+     */
+    None,
+    /**
+     * @brief The coordinate is moved back to the closest bound, and the velocity is kept.
+     */
+    Clamp,
+    /**
+     * @brief The coordinate is mirrored on the bound it crossed, and the velocity reversed.
+     */
+    Reflect,
+    /**
+     * @brief The search space is periodic: the coordinate re-enters from the opposite bound.
+     */
+    Wrap,
+    /**
+     * @brief The coordinate is drawn again, uniformly between the bounds, and the velocity is kept.
+     */
+    Reinitialize,
+    /**
+     * @brief The coordinate is moved back to the closest bound, and the velocity zeroed.
+     */
+    Absorb
+};
+
+/**
+ * @brief Get a printable name of the given boundary policy.
+ */
+inline const char *
+boundaryPolicyName(const BoundaryPolicy &policy) {
+        switch (policy) {
+            case BoundaryPolicy::Clamp:
+                return "clamp";
+            case BoundaryPolicy::Reflect:
+                return "reflect";
+            case BoundaryPolicy::Wrap:
+                return "wrap";
+            case BoundaryPolicy::Reinitialize:
+                return "reinitialize";
+            case BoundaryPolicy::Absorb:
+                return "absorb";
+            default:
+                return "none";
+        }
+}
+
+/**
+ * @brief Convert a value computed in Wide back to Value, saturating it if Value is narrower.
+ */
+template <typename Value, typename Wide>
+inline Value
+narrowBoundary(const Wide &x) {
+        if constexpr (std::is_same_v<Value, Wide>) {
+            return x;
+        } else {
+            return static_cast<Value>(std::min(std::max(x, Wide{std::numeric_limits<Value>::min()}),
+                                               Wide{std::numeric_limits<Value>::max()}));
+        }
+}
+
+/**
+ * @brief Clamp the velocities of n particles along one dimension between -vmax and vmax, and move
+ * their positions back by the part of the velocities that was cut off, so that x[j] is the
+ * position before the update plus the clamped velocity.
+ * @details The loop only uses min, max, additions and subtractions, so that it has no branch and
+ * is vectorized by the compiler, see BoundaryLoops. The values are computed in Wide, which holds
+ * the exact results when Value is the raw integer of a fixed-point type: the correction is then
+ * exact. In floating point, both the update and the correction round, so that x[j] only
+ * approximates it, within a few ulps of the unclamped position. The positions of the particles
+ * whose velocity is not clamped are left untouched.
+ *
+ * @param n Number of particles.
+ * @param vmax Largest absolute value of a component of a velocity, positive.
+ * @param x Coordinates of the updated positions, updated in place.
+ * @param v Components of the updated velocities, updated in place.
+ */
+template <typename Value, typename Wide = Value>
+inline void
+clampVelocitiesScalar(const unsigned int &n,
+                      const Value        &vmax,
+                      Value *__restrict x,
+                      Value *__restrict v) {
+    const Wide high = vmax;
+    const Wide low  = -high;
+        for (unsigned int j = 0; j < n; j++) {
+            const Wide vj      = v[j];
+            const Wide clamped = std::min(std::max(vj, low), high);
+            x[j]               = narrowBoundary<Value>(Wide(x[j]) + (clamped - vj));
+            v[j]               = narrowBoundary<Value>(clamped);
+        }
+}
+
+/**
+ * @brief Bring back between lower and upper the coordinates of n particles along one dimension,
+ * according to policy.
+ * @details The policy is selected once per call, and every loop only uses min, max, additions,
+ * subtractions and selections, so that it has no branch and is vectorized by the compiler. Reflect
+ * and Wrap move a coordinate by at most the width of the search space, which is exact as long as
+ * the velocities are at most that wide; coordinates farther away are then clamped.
+ *
+ * @param policy Boundary policy, None does nothing.
+ * @param n Number of particles.
+ * @param lower Lower bound of the search space.
+ * @param upper Upper bound of the search space.
+ * @param x Coordinates of the positions, updated in place.
+ * @param v Components of the velocities, updated in place.
+ * @param fresh Coordinates drawn uniformly between the bounds, one per particle, only read by
+ * Reinitialize.
+ */
+template <typename Value, typename Wide = Value>
+inline void
+enforceBoundsScalar(const BoundaryPolicy &policy,
+                    const unsigned int   &n,
+                    const Value          &lower,
+                    const Value          &upper,
+                    Value *__restrict x,
+                    Value *__restrict v,
+                    const Value *__restrict fresh) {
+    const Wide lo    = lower;
+    const Wide hi    = upper;
+    const Wide width = hi - lo;
+    const Wide zero  = Wide{0};
+        switch (policy) {
+            case BoundaryPolicy::Clamp:
+                    for (unsigned int j = 0; j < n; j++) {
+                        x[j] = narrowBoundary<Value>(std::min(std::max(Wide(x[j]), lo), hi));
+                    }
+                break;
+            case BoundaryPolicy::Absorb:
+                    for (unsigned int j = 0; j < n; j++) {
+                        const Wide xj      = x[j];
+                        const Wide vj      = v[j];
+                        const Wide clamped = std::min(std::max(xj, lo), hi);
+                        x[j]               = narrowBoundary<Value>(clamped);
+                        v[j]               = narrowBoundary<Value>(clamped == xj ? vj : zero);
+                    }
+                break;
+            case BoundaryPolicy::Reflect:
+                    for (unsigned int j = 0; j < n; j++) {
+                        const Wide xj = std::min(std::max(Wide(x[j]), lo - width), hi + width);
+                        // Mirroring on a bound only moves the coordinates beyond it.
+                        const Wide fromUpper = std::min(xj, hi + hi - xj);
+                        const Wide fromLower = std::max(fromUpper, lo + lo - fromUpper);
+                        const Wide vj        = v[j];
+                        x[j] = narrowBoundary<Value>(std::min(std::max(fromLower, lo), hi));
+                        v[j] = narrowBoundary<Value>((xj < lo) | (xj > hi) ? zero - vj : vj);
+                    }
+                break;
+            case BoundaryPolicy::Wrap:
+                    for (unsigned int j = 0; j < n; j++) {
+                        const Wide xj = std::min(std::max(Wide(x[j]), lo - width), hi + width);
+                        const Wide wrapped =
+                            xj + (xj < lo ? width : zero) - (xj > hi ? width : zero);
+                        x[j] = narrowBoundary<Value>(std::min(std::max(wrapped, lo), hi));
+                    }
+                break;
+            case BoundaryPolicy::Reinitialize:
+                    for (unsigned int j = 0; j < n; j++) {
+                        // Both are loaded, so that the selection has no branch.
+                        const Wide xj = x[j];
+                        const Wide fj = fresh[j];
+                        x[j]          = narrowBoundary<Value>((xj < lo) | (xj > hi) ? fj : xj);
+                    }
+                break;
+            default:
+                break;
+        }
+}
+
+#ifdef PSO_X86_KERNELS
+/**
+ * @brief clampVelocitiesScalar() compiled for AVX2, whose comparisons of 64-bit integers let the
+ * compiler vectorize it for the raw values of the fixed-point types too.
+ */
+template <typename Value, typename Wide = Value>
+__attribute__((target("avx2"))) inline void
+clampVelocitiesAVX2(const unsigned int &n, const Value &vmax, Value *x, Value *v) {
+    clampVelocitiesScalar<Value, Wide>(n, vmax, x, v);
+}
+
+/**
+ * @brief clampVelocitiesScalar() compiled for AVX-512.
+ */
+template <typename Value, typename Wide = Value>
+__attribute__((target("avx512f"))) inline void
+clampVelocitiesAVX512(const unsigned int &n, const Value &vmax, Value *x, Value *v) {
+    clampVelocitiesScalar<Value, Wide>(n, vmax, x, v);
+}
+
+/**
+ * @brief enforceBoundsScalar() compiled for AVX2, see clampVelocitiesAVX2().
+ */
+template <typename Value, typename Wide = Value>
+__attribute__((target("avx2"))) inline void
+enforceBoundsAVX2(const BoundaryPolicy &policy,
+                  const unsigned int   &n,
+                  const Value          &lower,
+                  const Value          &upper,
+                  Value                *x,
+                  Value                *v,
+                  const Value          *fresh) {
+    enforceBoundsScalar<Value, Wide>(policy, n, lower, upper, x, v, fresh);
+}
+
+/**
+ * @brief enforceBoundsScalar() compiled for AVX-512.
+ */
+template <typename Value, typename Wide = Value>
+__attribute__((target("avx512f"))) inline void
+enforceBoundsAVX512(const BoundaryPolicy &policy,
+                    const unsigned int   &n,
+                    const Value          &lower,
+                    const Value          &upper,
+                    Value                *x,
+                    Value                *v,
+                    const Value          *fresh) {
+    enforceBoundsScalar<Value, Wide>(policy, n, lower, upper, x, v, fresh);
+}
+#endif
+
+/**
+ * @brief Boundary kernels on values of type Value computed in Wide, compiled for the given
+ * instruction set, or for the widest one available below it. The loops are the same, so all the
+ * instruction sets give the same results.
+ */
+template <typename Value, typename Wide = Value>
+struct BoundaryLoops {
+    /**
+     * @brief See clampVelocitiesScalar().
+     */
+    static void
+    clampVelocities(const SimdLevel    &level,
+                    const unsigned int &n,
+                    const Value        &vmax,
+                    Value              *x,
+                    Value              *v) {
+#ifdef PSO_X86_KERNELS
+            switch (level) {
+                case SimdLevel::AVX512:
+                    clampVelocitiesAVX512<Value, Wide>(n, vmax, x, v);
+                    return;
+                case SimdLevel::AVX2:
+                    clampVelocitiesAVX2<Value, Wide>(n, vmax, x, v);
+                    return;
+                default:
+                    break;
+            }
+#endif
+        clampVelocitiesScalar<Value, Wide>(n, vmax, x, v);
+    }
+
+    /**
+     * @brief See enforceBoundsScalar().
+     */
+    static void
+    enforceBounds(const SimdLevel      &level,
+                  const BoundaryPolicy &policy,
+                  const unsigned int   &n,
+                  const Value          &lower,
+                  const Value          &upper,
+                  Value                *x,
+                  Value                *v,
+                  const Value          *fresh) {
+#ifdef PSO_X86_KERNELS
+            switch (level) {
+                case SimdLevel::AVX512:
+                    enforceBoundsAVX512<Value, Wide>(policy, n, lower, upper, x, v, fresh);
+                    return;
+                case SimdLevel::AVX2:
+                    enforceBoundsAVX2<Value, Wide>(policy, n, lower, upper, x, v, fresh);
+                    return;
+                default:
+                    break;
+            }
+#endif
+        enforceBoundsScalar<Value, Wide>(policy, n, lower, upper, x, v, fresh);
+    }
+};
+
+/**
+ * @brief Velocity clamping and boundary handling kernels for the given Scalar type.
+ * @details The generic version runs the scalar loops on Scalar; the specializations select the
+ * loops compiled for the instruction set of the swarm, on Scalar or on another representation of
+ * it, e.g. the raw integers of the fixed-point types.
+ */
+template <typename Scalar>
+struct BoundaryKernel {
+    /**
+     * @brief See clampVelocitiesScalar().
+     */
+    static void
+    clampVelocities(const SimdLevel &,
+                    const unsigned int &n,
+                    const Scalar       &vmax,
+                    Scalar             *x,
+                    Scalar             *v) {
+        clampVelocitiesScalar<Scalar>(n, vmax, x, v);
+    }
+
+    /**
+     * @brief See enforceBoundsScalar().
+     */
+    static void
+    enforceBounds(const SimdLevel &,
+                  const BoundaryPolicy &policy,
+                  const unsigned int   &n,
+                  const Scalar         &lower,
+                  const Scalar         &upper,
+                  Scalar               *x,
+                  Scalar               *v,
+                  const Scalar         *fresh) {
+        enforceBoundsScalar<Scalar>(policy, n, lower, upper, x, v, fresh);
+    }
+};
+
+/**
+ * @brief Boundary kernels for double, which the compiler vectorizes for every instruction set.
+ */
+template <>
+struct BoundaryKernel<double> : BoundaryLoops<double> {};
+
+#endif
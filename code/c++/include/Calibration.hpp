@@ -0,0 +1,62 @@
+#ifndef CALIBRATION_HPP
+#define CALIBRATION_HPP
+
+#include "DynamicRange.hpp"
+#include "PSO.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+/**
+ * @brief Default number of iterations of the calibration pass.
+ */
+constexpr unsigned int calibrationIterations = 50;
+
+/**
+ * @brief Measure the dynamic range of an optimization with a short double-precision pass.
+ * @details Runs the synchronous PSO in double precision with the same swarm, parameters and seed
+ * for at most calibrationIterations iterations, recording the largest magnitudes reached by the
+ * positions, velocities and scores. The result can be used to pick the narrowest fixed-point
+ * format that does not overflow (see DynamicRange::integerBits()).
+ * @tparam Objective Type of the function to minimize, which must be callable on double.
+ *
+ * @param iterations Number of iterations of the optimization to calibrate; the pass performs at
+ * most calibrationIterations of them.
+ * @return DynamicRange Largest magnitudes reached during the pass.
+ */
+template <typename Objective>
+DynamicRange
+calibrate(const Objective     &func,
+          const unsigned int  &numParticles,
+          const unsigned int  &dimensions,
+          const double        &upperBound,
+          const double        &lowerBound,
+          const double        &w,
+          const double        &c,
+          const double        &s,
+          const unsigned int  &iterations,
+          const unsigned int  &numThreads = 1,
+          const std::uint64_t &seed       = 42) {
+    std::cout << "===== Calibrating the fixed-point format with a double-precision pass"
+              << std::endl;
+    PSO<double, dynamicDimensions, Objective> pso(numParticles,
+                                                  dimensions,
+                                                  func,
+                                                  upperBound,
+                                                  lowerBound,
+                                                  w,
+                                                  c,
+                                                  s,
+                                                  std::min(iterations, calibrationIterations),
+                                                  numThreads,
+                                                  seed);
+    pso.setTrackDynamicRange(true);
+    pso.initializeParticles();
+    pso.run();
+    const DynamicRange &range = pso.getDynamicRange();
+    std::cout << "===== Calibration done: largest position " << range.position << ", velocity "
+              << range.velocity << ", score " << range.score << std::endl;
+    return range;
+}
+
+#endif
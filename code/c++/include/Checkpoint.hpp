@@ -0,0 +1,242 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Alignment of the sections of a checkpoint file, in bytes.
+ */
+constexpr std::size_t checkpointAlignment = 64;
+
+/**
+ * @brief Header at the beginning of a checkpoint file, see PSO::saveCheckpoint().
+ * @details The header is followed by the sections of the swarm, each one starting at a multiple of
+ * checkpointAlignment bytes: the best position, the best score, the scores, the personal best
+ * scores, and then the positions, the velocities and the personal best positions, with one section
+ * per dimension holding the coordinates of all the particles along it.
+ * The values are stored as the bytes of the arithmetic type of the optimizer, in the byte order of
+ * the machine.
+ */
+struct CheckpointHeader {
+    /**
+     * @brief "PSOCKPT", terminated by a null character.
+     */
+    char magic[8];
+    /**
+     * @brief Version of the format, currently 1.
+     */
+    std::uint32_t version;
+    /**
+     * @brief Size of the header in bytes.
+     */
+    std::uint32_t headerSize;
+    /**
+     * @brief Size of a value in bytes.
+     */
+    std::uint32_t scalarSize;
+    /**
+     * @brief Number of dimensions of the problem.
+     */
+    std::uint32_t dimensions;
+    /**
+     * @brief Number of particles.
+     */
+    std::uint32_t numParticles;
+    /**
+     * @brief Number of iterations performed.
+     */
+    std::uint32_t iterations;
+    /**
+     * @brief Number of iterations performed when the best score last improved.
+     */
+    std::uint32_t lastImprovement;
+    /**
+     * @brief Unused, zero.
+     */
+    std::uint32_t reserved;
+    /**
+     * @brief Number of evaluations of the function to minimize, initial evaluation included.
+     */
+    std::uint64_t evaluations;
+    /**
+     * @brief Seed of the random numbers.
+     */
+    std::uint64_t seed;
+    /**
+     * @brief Bytes of the value 1 in the arithmetic type, followed by zeros: they tell apart types
+     * of the same size, such as two fixed-point formats.
+     */
+    unsigned char one[16];
+};
+
+static_assert(sizeof(CheckpointHeader) == 72, "the header of a checkpoint file has no padding");
+
+/**
+ * @brief Writer of the sections of a checkpoint file.
+ * @details The sections are written to a temporary file next to the destination, which replaces
+ * the destination only when commit() is called, so that a process stopped while writing leaves the
+ * previous checkpoint intact.
+ */
+class CheckpointWriter {
+  public:
+    /**
+     * @brief Create the temporary file of the checkpoint path_.
+     * @throw std::runtime_error If the file cannot be created.
+     */
+    explicit CheckpointWriter(const std::string &path_) :
+        path(path_), temporaryPath(path_ + ".tmp") {
+        file = std::fopen(temporaryPath.c_str(), "wb");
+            if (file == nullptr) {
+                throw std::runtime_error("cannot create the checkpoint file " + temporaryPath);
+        }
+    }
+
+    CheckpointWriter(const CheckpointWriter &) = delete;
+
+    CheckpointWriter &
+    operator=(const CheckpointWriter &) = delete;
+
+    /**
+     * @brief Remove the temporary file, unless commit() has been called.
+     */
+    ~CheckpointWriter() {
+            if (file != nullptr) {
+                std::fclose(file);
+                std::remove(temporaryPath.c_str());
+        }
+    }
+
+    /**
+     * @brief Write a section of size bytes, padded with zeros to a multiple of
+     * checkpointAlignment bytes.
+     */
+    void
+    write(const void *data, const std::size_t &size) {
+        static const char padding[checkpointAlignment] = {};
+        const std::size_t padded = (size + checkpointAlignment - 1) / checkpointAlignment;
+            if (std::fwrite(data, 1, size, file) != size ||
+                std::fwrite(padding, 1, padded * checkpointAlignment - size, file) !=
+                    padded * checkpointAlignment - size) {
+                throw std::runtime_error("cannot write the checkpoint file " + temporaryPath);
+        }
+    }
+
+    /**
+     * @brief Close the temporary file and move it to the destination.
+     * @throw std::runtime_error If the file cannot be written or moved.
+     */
+    void
+    commit() {
+        const bool closed = std::fclose(file) == 0;
+        file              = nullptr;
+            if (!closed || std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+                std::remove(temporaryPath.c_str());
+                throw std::runtime_error("cannot write the checkpoint file " + path);
+        }
+    }
+
+  private:
+    /**
+     * @brief Destination of the checkpoint.
+     */
+    const std::string path;
+    /**
+     * @brief Path of the file being written.
+     */
+    const std::string temporaryPath;
+    /**
+     * @brief File being written, or nullptr once committed.
+     */
+    std::FILE *file = nullptr;
+};
+
+/**
+ * @brief Reader of the sections of a checkpoint file, which maps the file into memory instead of
+ * reading it through a buffer: the sections are copied once, straight from the page cache.
+ */
+class CheckpointReader {
+  public:
+    /**
+     * @brief Map the checkpoint file path_.
+     * @throw std::runtime_error If the file cannot be opened or mapped.
+     */
+    explicit CheckpointReader(const std::string &path_) : path(path_) {
+        const int descriptor = ::open(path.c_str(), O_RDONLY);
+        struct stat status;
+            if (descriptor < 0 || ::fstat(descriptor, &status) != 0) {
+                    if (descriptor >= 0) {
+                        ::close(descriptor);
+                }
+                throw std::runtime_error("cannot open the checkpoint file " + path);
+        }
+        size = static_cast<std::size_t>(status.st_size);
+            if (size > 0) {
+                void *mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+                    if (mapped == MAP_FAILED) {
+                        ::close(descriptor);
+                        throw std::runtime_error("cannot map the checkpoint file " + path);
+                }
+                data = static_cast<const unsigned char *>(mapped);
+                // The whole file is about to be read: start reading it ahead.
+                ::madvise(mapped, size, MADV_WILLNEED);
+        }
+        ::close(descriptor);
+    }
+
+    CheckpointReader(const CheckpointReader &) = delete;
+
+    CheckpointReader &
+    operator=(const CheckpointReader &) = delete;
+
+    /**
+     * @brief Unmap the file.
+     */
+    ~CheckpointReader() {
+            if (data != nullptr) {
+                ::munmap(const_cast<unsigned char *>(data), size);
+        }
+    }
+
+    /**
+     * @brief Copy the next section, of size bytes, to out, and skip its padding.
+     * @throw std::runtime_error If the file is too short.
+     */
+    void
+    read(void *out, const std::size_t &size_) {
+            if (offset + size_ > size) {
+                throw std::runtime_error("truncated checkpoint file " + path);
+        }
+        std::memcpy(out, data + offset, size_);
+        offset += (size_ + checkpointAlignment - 1) / checkpointAlignment * checkpointAlignment;
+    }
+
+  private:
+    /**
+     * @brief Path of the file.
+     */
+    const std::string path;
+    /**
+     * @brief Contents of the file.
+     */
+    const unsigned char *data = nullptr;
+    /**
+     * @brief Size of the file in bytes.
+     */
+    std::size_t size = 0;
+    /**
+     * @brief Offset of the next section.
+     */
+    std::size_t offset = 0;
+};
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef DYNAMIC_RANGE_HPP
+#define DYNAMIC_RANGE_HPP
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Largest magnitudes reached by the coordinates of the positions, by the components of the
+ * velocities and by the scores of a swarm.
+ * @details Recorded by PSO when setTrackDynamicRange() is enabled, and used to pick a fixed-point
+ * format wide enough for a problem (see calibrate()).
+ */
+struct DynamicRange {
+    /**
+     * @brief Largest magnitude of a coordinate of a position.
+     */
+    double position = 0;
+    /**
+     * @brief Largest magnitude of a component of a velocity.
+     */
+    double velocity = 0;
+    /**
+     * @brief Largest magnitude of a score.
+     */
+    double score = 0;
+
+    /**
+     * @brief Record a coordinate of a position and the corresponding component of the velocity.
+     */
+    template <typename Scalar>
+    void
+    recordParticle(const Scalar &position_, const Scalar &velocity_) {
+        position = std::max(position, std::abs(static_cast<double>(position_)));
+        velocity = std::max(velocity, std::abs(static_cast<double>(velocity_)));
+    }
+
+    /**
+     * @brief Record a score.
+     */
+    template <typename Scalar>
+    void
+    recordScore(const Scalar &score_) {
+        score = std::max(score, std::abs(static_cast<double>(score_)));
+    }
+
+    /**
+     * @brief Widen this range to include other.
+     */
+    void
+    merge(const DynamicRange &other) {
+        position = std::max(position, other.position);
+        velocity = std::max(velocity, other.velocity);
+        score    = std::max(score, other.score);
+    }
+
+    /**
+     * @brief Get the largest of the recorded magnitudes.
+     */
+    double
+    getMax() const {
+        return std::max({position, velocity, score});
+    }
+
+    /**
+     * @brief Get the number of integer bits, sign included, that a signed fixed-point format needs
+     * to represent every recorded magnitude multiplied by headroom.
+     * @details The headroom covers the values that are not recorded, such as the intermediate
+     * results of the function to minimize and the values reached after the recorded iterations.
+     */
+    unsigned int
+    integerBits(const double &headroom = 2.0) const {
+        // 2^(bits - 1) must be larger than the magnitude.
+        const double magnitude = getMax() * headroom;
+        return magnitude < 1.0 ? 1
+                               : static_cast<unsigned int>(std::floor(std::log2(magnitude))) + 2;
+    }
+};
+
+#endif
@@ -0,0 +1,429 @@
+#ifndef EVALUATION_CACHE_HPP
+#define EVALUATION_CACHE_HPP
+
+#include "SwarmArena.hpp"
+#include "SwarmStorage.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief Lookups of an EvaluationCache, counted per particle.
+ */
+struct EvaluationCacheStatistics {
+    /**
+     * @brief Number of particles whose score was found in the cache.
+     */
+    std::uint64_t hits = 0;
+    /**
+     * @brief Number of particles that were evaluated, because their position was not in the cache.
+     */
+    std::uint64_t misses = 0;
+    /**
+     * @brief Number of cached positions replaced by newer ones.
+     */
+    std::uint64_t evictions = 0;
+
+    /**
+     * @brief Get the fraction of the lookups that hit, or 0 if there were none.
+     */
+    double
+    getHitRate() const {
+        return hits + misses > 0 ? static_cast<double>(hits) / static_cast<double>(hits + misses)
+                                 : 0.0;
+    }
+};
+
+/**
+ * @brief Bounded cache of the scores of the positions evaluated by a swarm, for functions to
+ * minimize that are expensive and deterministic.
+ * @details A position is keyed by the exact bits of its coordinates, so a hit returns the very
+ * score the function would have computed, and a run gives the same result with or without the
+ * cache, but for the overflows of the types that count them, which a hit does not replay (see
+ * PSO::setEvaluationCache()). The table is open-addressed and set-associative: a position hashes
+ * to a bucket of ways slots, which are probed in order, and once they are all taken the oldest
+ * one is replaced, so that the memory is fixed when the cache is constructed. Each bucket is
+ * guarded by a sequence lock, but the cache never waits: a lookup that races with a write to its
+ * bucket misses, and a write to a bucket that another thread is writing is dropped.
+ * @tparam Scalar Type of the coordinates and of the scores.
+ * @tparam Dims Number of dimensions, or dynamicDimensions if it is only known at run time.
+ */
+template <typename Scalar, unsigned int Dims = dynamicDimensions>
+class EvaluationCache {
+    static_assert(std::is_trivially_copyable_v<Scalar> && sizeof(Scalar) <= sizeof(std::uint64_t),
+                  "the positions are keyed by the bits of their coordinates");
+
+  public:
+    /**
+     * @brief Read-only view of the positions of a batch of particles.
+     */
+    using View = SwarmView<Scalar, Dims>;
+
+    /**
+     * @brief Number of slots of a bucket.
+     */
+    static constexpr unsigned int ways = 4;
+
+    /**
+     * @brief Construct an empty cache of about capacity_ positions, for a swarm of the given
+     * shape.
+     * @details The number of buckets is capacity_ / ways rounded down to a power of two, and at
+     * least one. All the memory, the table and the buffers the positions that miss are gathered
+     * into, is allocated at once, see footprint().
+     */
+    EvaluationCache(const std::size_t  &capacity_,
+                    const unsigned int &numParticles_,
+                    const unsigned int &dimensions_) :
+        dimensions(dimensions_),
+        numBuckets(bucketCount(capacity_)),
+        arena(footprint(capacity_, numParticles_, dimensions_)) {
+        const std::size_t slots = numBuckets * ways;
+        buckets                 = arena.carve<Bucket>(numBuckets);
+        hashes                  = arena.carve<std::atomic<std::uint64_t>>(slots);
+        scores                  = arena.carve<std::atomic<Scalar>>(slots);
+        keys                    = arena.carve<std::atomic<Scalar>>(slots * dimensions);
+        missPositions           = SwarmStorage<Scalar, Dims>(numParticles_, dimensions_, arena);
+        missHashes              = ArenaArray<std::uint64_t>(arena, numParticles_);
+        missIndices             = ArenaArray<unsigned int>(arena, numParticles_);
+        missScores              = ArenaArray<Scalar>(arena, numParticles_);
+    }
+
+    /**
+     * @brief Get the number of bytes allocated by a cache of about capacity_ positions, for a
+     * swarm of the given shape.
+     */
+    static std::size_t
+    footprint(const std::size_t  &capacity_,
+              const unsigned int &numParticles_,
+              const unsigned int &dimensions_) {
+        const std::size_t slots = bucketCount(capacity_) * ways;
+        return SwarmArena::footprint<Bucket>(bucketCount(capacity_)) +
+               SwarmArena::footprint<std::atomic<std::uint64_t>>(slots) +
+               SwarmArena::footprint<std::atomic<Scalar>>(slots) +
+               SwarmArena::footprint<std::atomic<Scalar>>(slots * dimensions_) +
+               SwarmStorage<Scalar, Dims>::footprint(numParticles_, dimensions_) +
+               ArenaArray<std::uint64_t>::footprint(numParticles_) +
+               ArenaArray<unsigned int>::footprint(numParticles_) +
+               ArenaArray<Scalar>::footprint(numParticles_);
+    }
+
+    /**
+     * @brief Write the score of every particle of x into out, looking it up in the cache, and
+     * evaluate the particles that miss with a single call of evaluateMisses, on a view of their
+     * positions gathered into a buffer of the cache, before caching their scores.
+     * @details Threads may evaluate disjoint ranges of particles concurrently: the positions that
+     * miss are gathered from the offset-th particle of the buffer on, so x must be the particles of
+     * a swarm of at most the number of particles the cache was constructed for, starting from the
+     * offset-th one.
+     *
+     * @param x Positions of the particles to evaluate.
+     * @param offset Index, in the swarm, of the first particle of x.
+     * @param out Output array, the score of the j-th particle of x is written into out[j].
+     * @param evaluateMisses Function callable as `void(const View &, Scalar *)`, which writes the
+     * score of the j-th particle of the view into the j-th element of the output array.
+     */
+    template <typename Evaluate>
+    void
+    evaluate(const View         &x,
+             const unsigned int &offset,
+             Scalar             *out,
+             Evaluate          &&evaluateMisses) {
+        const unsigned int n    = x.getNumParticles();
+        std::uint64_t     *hash = missHashes.data() + offset;
+        // The hashes are mixed one row at a time, so that the coordinates are read contiguously.
+            for (unsigned int j = 0; j < n; j++) {
+                hash[j] = seed;
+            }
+            for (unsigned int d = 0; d < getDimensions(); d++) {
+                const Scalar *row = x.row(d);
+                    for (unsigned int j = 0; j < n; j++) {
+                        hash[j] = (((hash[j] << 5) | (hash[j] >> 59)) ^ bits(row[j])) * multiplier;
+                    }
+            }
+
+        unsigned int  misses = 0;
+        unsigned int *index  = missIndices.data() + offset;
+            for (unsigned int j = 0; j < n; j++) {
+                const std::uint64_t h = finalize(hash[j]);
+                    if (!lookup(x, j, h, out[j])) {
+                        hash[misses]    = h;
+                        index[misses++] = j;
+                }
+            }
+        hits.fetch_add(n - misses, std::memory_order_relaxed);
+            if (misses == 0) {
+                return;
+        }
+        missCount.fetch_add(misses, std::memory_order_relaxed);
+
+            for (unsigned int d = 0; d < getDimensions(); d++) {
+                const Scalar *row    = x.row(d);
+                Scalar       *gather = missPositions.row(d) + offset;
+                    for (unsigned int k = 0; k < misses; k++) {
+                        gather[k] = row[index[k]];
+                    }
+            }
+        Scalar *score = missScores.data() + offset;
+        evaluateMisses(missPositions.view(offset, misses), score);
+        std::uint64_t evicted = 0;
+            for (unsigned int k = 0; k < misses; k++) {
+                out[index[k]] = score[k];
+                evicted += insert(offset + k, hash[k], score[k]);
+            }
+            if (evicted > 0) {
+                evictions.fetch_add(evicted, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Get the lookups counted since the construction or the last resetStatistics().
+     */
+    EvaluationCacheStatistics
+    getStatistics() const {
+        EvaluationCacheStatistics statistics;
+        statistics.hits      = hits.load(std::memory_order_relaxed);
+        statistics.misses    = missCount.load(std::memory_order_relaxed);
+        statistics.evictions = evictions.load(std::memory_order_relaxed);
+        return statistics;
+    }
+
+    /**
+     * @brief Reset the counts of getStatistics(), keeping the cached positions.
+     */
+    void
+    resetStatistics() {
+        hits.store(0, std::memory_order_relaxed);
+        missCount.store(0, std::memory_order_relaxed);
+        evictions.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the number of positions the cache can hold.
+     */
+    std::size_t
+    getCapacity() const {
+        return numBuckets * ways;
+    }
+
+    /**
+     * @brief Get the number of dimensions.
+     */
+    unsigned int
+    getDimensions() const {
+        return Dims == dynamicDimensions ? dimensions : Dims;
+    }
+
+  private:
+    /**
+     * @brief Lock and occupancy of the ways slots of a bucket.
+     */
+    struct Bucket {
+        /**
+         * @brief Even when the bucket is stable, odd while a writer is updating it.
+         */
+        std::atomic<std::uint64_t> sequence{0};
+        /**
+         * @brief Number of slots taken, from the first one.
+         */
+        std::atomic<unsigned int> filled{0};
+        /**
+         * @brief Slot replaced by the next insertion once they are all taken, only accessed by
+         * the writer holding the bucket.
+         */
+        unsigned int next = 0;
+    };
+
+    /**
+     * @brief Initial value of the hash of a position.
+     */
+    static constexpr std::uint64_t seed = 0x243F6A8885A308D3ull;
+    /**
+     * @brief Odd constant the hash is multiplied by after mixing each coordinate.
+     */
+    static constexpr std::uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+
+    /**
+     * @brief Get the number of buckets of a cache of about capacity_ positions.
+     */
+    static std::size_t
+    bucketCount(const std::size_t &capacity_) {
+        std::size_t count = 1;
+            while (count * 2 * ways <= capacity_) {
+                count *= 2;
+            }
+        return count;
+    }
+
+    /**
+     * @brief Get the bits of a coordinate, zero-extended to 64 bits.
+     */
+    static std::uint64_t
+    bits(const Scalar &value) {
+        std::uint64_t result = 0;
+        std::memcpy(&result, &value, sizeof(Scalar));
+        return result;
+    }
+
+    /**
+     * @brief Spread the bits of a mixed hash over all the 64 bits, so that its low bits can index
+     * the buckets (the finalizer of SplitMix64).
+     */
+    static std::uint64_t
+    finalize(std::uint64_t h) {
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+        return h ^ (h >> 31);
+    }
+
+    /**
+     * @brief Check whether the given slot holds the position of hash h whose d-th coordinate is
+     * coordinate(d).
+     */
+    template <typename Coordinate>
+    bool
+    holds(const std::size_t &slot, const std::uint64_t &h, const Coordinate &coordinate) const {
+            if (hashes[slot].load(std::memory_order_relaxed) != h) {
+                return false;
+        }
+        const std::atomic<Scalar> *key = keys + slot * getDimensions();
+            for (unsigned int d = 0; d < getDimensions(); d++) {
+                    if (bits(key[d].load(std::memory_order_relaxed)) != bits(coordinate(d))) {
+                        return false;
+                }
+            }
+        return true;
+    }
+
+    /**
+     * @brief Look up the j-th particle of x, whose hash is h.
+     * @return true if it was found, and its score copied into score.
+     */
+    bool
+    lookup(const View &x, const unsigned int &j, const std::uint64_t &h, Scalar &score) const {
+        const Bucket       &bucket = buckets[h & (numBuckets - 1)];
+        const std::size_t   first  = (h & (numBuckets - 1)) * ways;
+        const std::uint64_t seq    = bucket.sequence.load(std::memory_order_acquire);
+            if (seq & 1) {
+                return false;
+        }
+        const unsigned int filled     = bucket.filled.load(std::memory_order_relaxed);
+        const auto         coordinate = [&](const unsigned int &d) { return x(d, j); };
+            for (unsigned int k = 0; k < filled && k < ways; k++) {
+                    if (holds(first + k, h, coordinate)) {
+                        const Scalar score_ = scores[first + k].load(std::memory_order_relaxed);
+                        std::atomic_thread_fence(std::memory_order_acquire);
+                            if (bucket.sequence.load(std::memory_order_relaxed) != seq) {
+                                return false;
+                        }
+                        score = score_;
+                        return true;
+                }
+            }
+        return false;
+    }
+
+    /**
+     * @brief Cache the score of the k-th particle of missPositions, whose hash is h, unless the
+     * position is cached already or another thread is writing its bucket.
+     * @return 1 if a cached position was replaced, 0 otherwise.
+     */
+    unsigned int
+    insert(const unsigned int &k, const std::uint64_t &h, const Scalar &score) {
+        Bucket           &bucket = buckets[h & (numBuckets - 1)];
+        const std::size_t first  = (h & (numBuckets - 1)) * ways;
+        std::uint64_t     seq    = bucket.sequence.load(std::memory_order_relaxed);
+            if ((seq & 1) ||
+                !bucket.sequence.compare_exchange_strong(
+                    seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return 0;
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        const auto         coordinate = [&](const unsigned int &d) { return missPositions(d, k); };
+        const unsigned int filled     = bucket.filled.load(std::memory_order_relaxed);
+        unsigned int       evicted    = 0;
+        unsigned int       way        = filled;
+            for (unsigned int w = 0; w < filled; w++) {
+                    if (holds(first + w, h, coordinate)) {
+                        bucket.sequence.store(seq + 2, std::memory_order_release);
+                        return 0;
+                }
+            }
+            if (filled < ways) {
+                bucket.filled.store(filled + 1, std::memory_order_relaxed);
+            } else {
+                way         = bucket.next;
+                bucket.next = (bucket.next + 1) % ways;
+                evicted     = 1;
+            }
+        hashes[first + way].store(h, std::memory_order_relaxed);
+        scores[first + way].store(score, std::memory_order_relaxed);
+        std::atomic<Scalar> *key = keys + (first + way) * getDimensions();
+            for (unsigned int d = 0; d < getDimensions(); d++) {
+                key[d].store(missPositions(d, k), std::memory_order_relaxed);
+            }
+        bucket.sequence.store(seq + 2, std::memory_order_release);
+        return evicted;
+    }
+
+    /**
+     * @brief Number of dimensions.
+     */
+    unsigned int dimensions;
+    /**
+     * @brief Number of buckets, a power of two.
+     */
+    std::size_t numBuckets;
+    /**
+     * @brief Memory of the table and of the buffers.
+     */
+    SwarmArena arena;
+    /**
+     * @brief Lock and occupancy of every bucket.
+     */
+    Bucket *buckets = nullptr;
+    /**
+     * @brief Hash of the position held by every slot, the slots of a bucket being consecutive.
+     */
+    std::atomic<std::uint64_t> *hashes = nullptr;
+    /**
+     * @brief Score of the position held by every slot.
+     */
+    std::atomic<Scalar> *scores = nullptr;
+    /**
+     * @brief Coordinates of the position held by every slot, one slot after the other.
+     */
+    std::atomic<Scalar> *keys = nullptr;
+    /**
+     * @brief Positions of the particles that missed, gathered for their evaluation.
+     */
+    SwarmStorage<Scalar, Dims> missPositions;
+    /**
+     * @brief Hashes of the particles being looked up, then of the ones that missed.
+     */
+    ArenaArray<std::uint64_t> missHashes;
+    /**
+     * @brief Index in their batch of the particles that missed.
+     */
+    ArenaArray<unsigned int> missIndices;
+    /**
+     * @brief Scores of the particles that missed.
+     */
+    ArenaArray<Scalar> missScores;
+    /**
+     * @brief Number of particles found in the cache.
+     */
+    std::atomic<std::uint64_t> hits{0};
+    /**
+     * @brief Number of particles not found in the cache.
+     */
+    std::atomic<std::uint64_t> missCount{0};
+    /**
+     * @brief Number of cached positions replaced.
+     */
+    std::atomic<std::uint64_t> evictions{0};
+};
+
+#endif
@@ -0,0 +1,191 @@
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Whether the optimizer records the time of the phases of its iterations and counts the
+ * improvements of the bests, see Instrumentation. Set by the PSO_INSTRUMENTATION option of CMake;
+ * when disabled, the instrumentation compiles to nothing.
+ */
+#ifdef PSO_INSTRUMENTATION
+constexpr bool instrumentationEnabled = true;
+#else
+constexpr bool instrumentationEnabled = false;
+#endif
+
+/**
+ * @brief Phases of an iteration of the optimizer.
+ */
+enum class Phase {
+    /**
+     * @brief Generation of the random factors.
+     */
+    Random,
+    /**
+     * @brief Update of the velocities and positions.
+     */
+    Update,
+    /**
+     * @brief Evaluation of the function to minimize.
+     */
+    Evaluation,
+    /**
+     * @brief Update of the personal bests, and search and update of the global best.
+     */
+    Reduction
+};
+
+/**
+ * @brief Number of phases of an iteration.
+ */
+constexpr unsigned int numPhases = 4;
+
+/**
+ * @brief All the phases, in the order they run in.
+ */
+constexpr Phase phases[numPhases] = {Phase::Random, Phase::Update, Phase::Evaluation,
+                                     Phase::Reduction};
+
+/**
+ * @brief Get a printable name of the given phase.
+ */
+inline const char *
+phaseName(const Phase &phase) {
+        switch (phase) {
+            case Phase::Random:
+                return "random";
+            case Phase::Update:
+                return "update";
+            case Phase::Evaluation:
+                return "evaluation";
+            default:
+                return "reduction";
+        }
+}
+
+/**
+ * @brief Time spent in each phase of the iterations, and number of improvements of the personal
+ * and global bests.
+ * @details The times are summed over the threads, so with more than one thread they add up to
+ * more than the wall time. Every thread records into its own instance, aligned to a cache line so
+ * that the threads do not share one, and the instances are merged at the end of a run.
+ */
+struct alignas(64) Instrumentation {
+    /**
+     * @brief Time spent in each phase, in nanoseconds, indexed by Phase.
+     */
+    std::array<std::uint64_t, numPhases> phaseTimes{};
+    /**
+     * @brief Number of times a particle improved its personal best.
+     */
+    std::uint64_t personalBestImprovements = 0;
+    /**
+     * @brief Number of times the global best improved.
+     */
+    std::uint64_t globalBestImprovements = 0;
+
+    /**
+     * @brief Get the time spent in the given phase, in nanoseconds.
+     */
+    std::uint64_t
+    getPhaseTime(const Phase &phase) const {
+        return phaseTimes[static_cast<unsigned int>(phase)];
+    }
+
+    /**
+     * @brief Get the time spent in all the phases, in nanoseconds.
+     */
+    std::uint64_t
+    getTotalTime() const {
+        std::uint64_t total = 0;
+            for (const std::uint64_t &time : phaseTimes) {
+                total += time;
+            }
+        return total;
+    }
+
+    /**
+     * @brief Count an improvement of a personal best, if the instrumentation is enabled.
+     */
+    void
+    countPersonalBest() {
+            if constexpr (instrumentationEnabled) {
+                personalBestImprovements++;
+        }
+    }
+
+    /**
+     * @brief Count an improvement of the global best, if the instrumentation is enabled.
+     */
+    void
+    countGlobalBest() {
+            if constexpr (instrumentationEnabled) {
+                globalBestImprovements++;
+        }
+    }
+
+    /**
+     * @brief Add the times and the counters of other to this.
+     */
+    void
+    merge(const Instrumentation &other) {
+            for (unsigned int p = 0; p < numPhases; p++) {
+                phaseTimes[p] += other.phaseTimes[p];
+            }
+        personalBestImprovements += other.personalBestImprovements;
+        globalBestImprovements += other.globalBestImprovements;
+    }
+};
+
+/**
+ * @brief Stopwatch that splits the time of a thread into consecutive phases.
+ * @details Every call to lap() adds the time elapsed since the construction or the previous lap()
+ * to the given phase. The version for a disabled instrumentation is empty, so that it compiles to
+ * nothing.
+ */
+template <bool Enabled = instrumentationEnabled>
+class PhaseTimer {
+  public:
+    /**
+     * @brief Start a stopwatch that records into instrumentation_.
+     */
+    explicit PhaseTimer(Instrumentation &instrumentation_) :
+        instrumentation(instrumentation_), last(clock::now()) {}
+
+    /**
+     * @brief Add the time since the previous lap to phase.
+     */
+    void
+    lap(const Phase &phase) {
+        const clock::time_point now = clock::now();
+        instrumentation.phaseTimes[static_cast<unsigned int>(phase)] +=
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count();
+        last = now;
+    }
+
+  private:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Instrumentation the times are added to.
+     */
+    Instrumentation &instrumentation;
+    /**
+     * @brief Time of the previous lap.
+     */
+    clock::time_point last;
+};
+
+template <>
+class PhaseTimer<false> {
+  public:
+    explicit PhaseTimer(Instrumentation &) {}
+
+    void
+    lap(const Phase &) {}
+};
+
+#endif
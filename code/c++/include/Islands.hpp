@@ -0,0 +1,336 @@
+#ifndef ISLANDS_HPP
+#define ISLANDS_HPP
+
+#include "PSO.hpp"
+#include "SpscQueue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Island model: several independent swarms, which periodically send their best particles
+ * to each other.
+ * @details Every island is a single-threaded PSO with its own seed, hence its own random numbers,
+ * and runs on its own thread of a pool. The islands form a ring: every migrationInterval
+ * iterations, each island sends the personal bests of its best particles to the next one, through
+ * a lock-free single-producer single-consumer queue, and replaces its worst particles with the
+ * ones received from the previous island (see PSO::emigrate() and PSO::immigrate()). Between two
+ * migrations the islands share nothing, so the run scales with the number of cores, while the
+ * migrations spread the good regions found by an island to the others without collapsing all of
+ * them on the same basin.
+ * An island only waits for the migrants of the same epoch from the previous island, never for the
+ * whole ring, and the result is reproducible for a given seed.
+ *
+ * @tparam Scalar Arithmetic type of the islands, see PSO.
+ * @tparam Dims Number of dimensions of the search space, see PSO.
+ * @tparam Objective Type of the function to minimize, see PSO. It is called concurrently by the
+ * islands, so it must be safe to call from several threads at once.
+ */
+template <typename Scalar,
+          unsigned int Dims = dynamicDimensions,
+          typename Objective =
+              std::function<void(const SwarmView<Scalar, Dims> &, Scalar *)>>
+class Islands {
+  public:
+    /**
+     * @brief Swarm of an island.
+     */
+    using Swarm = PSO<Scalar, Dims, Objective>;
+
+    /**
+     * @brief Outcome of a run, returned by run().
+     */
+    using Result = typename Swarm::Result;
+
+    /**
+     * @brief Construct numIslands_ islands of numParticles_ particles each, which will be used to
+     * minimize the given function.
+     * @details The parameters are the ones of PSO: every island is a single-threaded swarm, and
+     * the i-th one is seeded with seed_ + i.
+     */
+    Islands(const unsigned int  &numIslands_,
+            const unsigned int  &numParticles_,
+            const unsigned int  &dimensions_,
+            const Objective     &func_,
+            const Scalar        &upperBound_,
+            const Scalar        &lowerBound_,
+            const Scalar        &w_,
+            const Scalar        &c_             = Scalar{1},
+            const Scalar        &s_             = Scalar{1},
+            const unsigned int  &maxIterations_ = 1000,
+            const std::uint64_t &seed_          = 42) :
+        numParticles(numParticles_), maxIterations(maxIterations_),
+        migrants(std::min(2u, numParticles_)), pool(std::make_unique<ThreadPool>(numIslands_)) {
+            for (unsigned int i = 0; i < pool->getNumThreads(); i++) {
+                islands.push_back(std::make_unique<Swarm>(numParticles_,
+                                                          dimensions_,
+                                                          func_,
+                                                          upperBound_,
+                                                          lowerBound_,
+                                                          w_,
+                                                          c_,
+                                                          s_,
+                                                          maxIterations_,
+                                                          1,
+                                                          seed_ + i));
+            }
+    }
+
+    /**
+     * @brief Get the number of islands.
+     */
+    unsigned int
+    getNumIslands() const {
+        return static_cast<unsigned int>(islands.size());
+    }
+
+    /**
+     * @brief Get the swarm of the i-th island, e.g. to select its topology or its stopping
+     * criteria; an island that stops early no longer sends nor receives migrants.
+     */
+    Swarm &
+    getIsland(const unsigned int &i) {
+        return *islands[i];
+    }
+
+    /**
+     * @brief Select how often and how many particles migrate.
+     *
+     * @param interval Number of iterations between two migrations (20 by default, at least 1).
+     * @param migrants_ Number of particles sent by every island at every migration (2 by default),
+     * or 0 to keep the islands isolated.
+     */
+    void
+    setMigration(const unsigned int &interval, const unsigned int &migrants_) {
+        migrationInterval = std::max(1u, interval);
+        migrants          = std::min(migrants_, numParticles);
+    }
+
+    /**
+     * @brief Initialize the particles of every island, see PSO::initializeParticles().
+     */
+    void
+    initializeParticles() {
+            for (const std::unique_ptr<Swarm> &island : islands) {
+                island->initializeParticles();
+            }
+    }
+
+    /**
+     * @brief Run every island up to maxIterations iterations, migrating particles between them.
+     * @details The best score and position are the best ones of all the islands, the stop reason is
+     * the one of the island that found them, the number of iterations is the largest one of an
+     * island, and the evaluations, the overflows and the instrumentation are summed over the
+     * islands, each of which counts its own overflows. The history holds the improvements of the
+     * best score of all the islands, in the order they happened.
+     * @note This function must be called after initializeParticles().
+     * @throws std::overflow_error If Scalar traps on overflow and an island stopped because of an
+     * overflow, once all the islands stopped.
+     */
+    Result
+    run();
+
+  private:
+    /**
+     * @brief Personal bests sent by an island to the next one at a migration.
+     */
+    struct Migration {
+        /**
+         * @brief Positions of the migrants, one after the other.
+         */
+        std::vector<Scalar> positions;
+        /**
+         * @brief Scores of the migrants.
+         */
+        std::vector<Scalar> scores;
+    };
+
+    /**
+     * @brief Run the t-th island up to maxIterations iterations, migrating particles every
+     * migrationInterval iterations.
+     *
+     * @param t Index of the island.
+     * @param start Time at which the run started.
+     * @param history Receives the improvements of the best score of the island, timed from start.
+     * @param summary Receives the stop reason and the merged instrumentation of the island.
+     */
+    void
+    runIsland(const unsigned int                                   &t,
+              const std::chrono::high_resolution_clock::time_point &start,
+              std::vector<Improvement<Scalar>>                     &history,
+              Result                                               &summary);
+
+    /**
+     * @brief Number of particles of every island.
+     */
+    const unsigned int numParticles;
+    /**
+     * @brief Maximum number of iterations of every island.
+     */
+    const unsigned int maxIterations;
+    /**
+     * @brief Number of iterations between two migrations.
+     */
+    unsigned int migrationInterval = 20;
+    /**
+     * @brief Number of particles sent by every island at every migration.
+     */
+    unsigned int migrants;
+    /**
+     * @brief Threads running the islands, one per island.
+     */
+    std::unique_ptr<ThreadPool> pool;
+    /**
+     * @brief Swarms of the islands.
+     */
+    std::vector<std::unique_ptr<Swarm>> islands;
+    /**
+     * @brief Queue of the migrants sent by the i-th island to the next one, for every island.
+     */
+    std::vector<std::unique_ptr<SpscQueue<Migration>>> queues;
+    /**
+     * @brief Set by every island when it stops, so that its neighbors stop waiting for it.
+     */
+    std::unique_ptr<std::atomic<bool>[]> finished;
+};
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+void
+Islands<Scalar, Dims, Objective>::runIsland(
+    const unsigned int                                   &t,
+    const std::chrono::high_resolution_clock::time_point &start,
+    std::vector<Improvement<Scalar>>                     &history,
+    Result                                               &summary) {
+    using clock                    = std::chrono::high_resolution_clock;
+    const unsigned int    n        = getNumIslands();
+    const unsigned int    next     = (t + 1) % n;
+    const unsigned int    previous = (t + n - 1) % n;
+    Swarm                &island   = *islands[t];
+    // The queue of an island carries its migrants to the next one.
+    SpscQueue<Migration> &outbox   = *queues[t];
+    SpscQueue<Migration> &inbox    = *queues[previous];
+    Migration             outgoing, incoming;
+    // Without migrations, an island runs in one go.
+    const unsigned int    interval =
+        n > 1 && migrants > 0 ? migrationInterval : std::numeric_limits<unsigned int>::max();
+    outgoing.positions.resize(static_cast<std::size_t>(migrants) * island.getDimensions());
+    outgoing.scores.resize(migrants);
+
+        while (true) {
+            const clock::duration offset = clock::now() - start;
+            const Result          epoch  = island.run(interval);
+                for (const Improvement<Scalar> &improvement : epoch.history) {
+                    history.push_back(
+                        {improvement.iteration, improvement.time + offset, improvement.score});
+                }
+            summary.stopReason = epoch.stopReason;
+            summary.overflows += epoch.overflows;
+            summary.instrumentation.merge(epoch.instrumentation);
+                if (epoch.stopReason != StopReason::MaxIterations ||
+                    island.getIterations() >= maxIterations) {
+                    break;
+            }
+
+            island.emigrate(migrants, outgoing.positions.data(), outgoing.scores.data());
+                while (!outbox.push(outgoing) && !finished[next].load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+            bool received = inbox.pop(incoming);
+                while (!received && !finished[previous].load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                    received = inbox.pop(incoming);
+                }
+                // The previous island may have sent its last migrants right before stopping.
+                if (!received) {
+                    received = inbox.pop(incoming);
+            }
+                if (received) {
+                    island.immigrate(migrants, incoming.positions.data(), incoming.scores.data());
+            }
+        }
+    finished[t].store(true, std::memory_order_release);
+}
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+typename Islands<Scalar, Dims, Objective>::Result
+Islands<Scalar, Dims, Objective>::run() {
+    using clock          = std::chrono::high_resolution_clock;
+    const unsigned int n = getNumIslands();
+    std::vector<std::vector<Improvement<Scalar>>> histories(n);
+    std::vector<Result>                           summaries(n);
+    std::vector<std::exception_ptr>               errors(n);
+    Scalar                                        bestScore = islands[0]->getBestScore();
+        for (const std::unique_ptr<Swarm> &island : islands) {
+            bestScore = std::min(bestScore, island->getBestScore());
+        }
+    // Two epochs of room, so that an island can send its migrants before the next one took the
+    // previous ones; queues left over by a previous run are discarded.
+    queues.clear();
+        for (unsigned int i = 0; i < n; i++) {
+            queues.push_back(std::make_unique<SpscQueue<Migration>>(2));
+        }
+    finished = std::make_unique<std::atomic<bool>[]>(n);
+        for (unsigned int i = 0; i < n; i++) {
+            finished[i].store(false, std::memory_order_relaxed);
+        }
+
+    const clock::time_point start = clock::now();
+    pool->run([&](const unsigned int &t) {
+            try {
+                runIsland(t, start, histories[t], summaries[t]);
+            } catch (...) {
+                errors[t] = std::current_exception();
+                finished[t].store(true, std::memory_order_release);
+            }
+    });
+    Result result;
+    result.totalTime = clock::now() - start;
+        for (const std::exception_ptr &error : errors) {
+                if (error) {
+                    std::rethrow_exception(error);
+            }
+        }
+
+    unsigned int best = 0;
+        for (unsigned int i = 0; i < n; i++) {
+                if (islands[i]->getBestScore() < islands[best]->getBestScore()) {
+                    best = i;
+            }
+            result.iterations = std::max(result.iterations, islands[i]->getIterations());
+            result.evaluations += islands[i]->getEvaluations();
+            result.overflows += summaries[i].overflows;
+            result.instrumentation.merge(summaries[i].instrumentation);
+            result.history.insert(result.history.end(), histories[i].begin(), histories[i].end());
+        }
+    result.bestScore    = islands[best]->getBestScore();
+    result.bestPosition = islands[best]->getBestPosition();
+    result.stopReason   = summaries[best].stopReason;
+    // Keep the improvements of the best score of all the islands.
+    std::stable_sort(result.history.begin(),
+                     result.history.end(),
+                     [](const Improvement<Scalar> &a, const Improvement<Scalar> &b) {
+                         return a.time < b.time;
+                     });
+    std::vector<Improvement<Scalar>> improvements;
+        for (const Improvement<Scalar> &improvement : result.history) {
+                if (improvement.score < bestScore) {
+                    bestScore = improvement.score;
+                    improvements.push_back(improvement);
+            }
+        }
+    result.history = std::move(improvements);
+        if (!result.history.empty()) {
+            result.bestIteration = result.history.back().iteration;
+            result.timeUntilBest = result.history.back().time;
+    }
+    return result;
+}
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef OVERFLOW_HPP
+#define OVERFLOW_HPP
+
+#include <cstdint>
+
+/**
+ * @brief What an arithmetic type does when the result of an operation does not fit in it.
+ */
+enum class OverflowPolicy {
+    /**
+     * @brief Keep the low bits of the result, i.e. wrap around, silently.
+     */
+    Wrap,
+    /**
+     * @brief Clamp the result to the closest representable value, and count the overflow.
+     */
+    Saturate,
+    /**
+     * @brief Wrap around and count the overflow; the optimizer stops with an error at the end of
+     * the iteration in which the first overflow happened.
+     */
+    Trap
+};
+
+/**
+ * @brief Get a printable name of the given policy.
+ */
+inline const char *
+overflowPolicyName(const OverflowPolicy &policy) {
+        switch (policy) {
+            case OverflowPolicy::Saturate:
+                return "saturate";
+            case OverflowPolicy::Trap:
+                return "trap";
+            default:
+                return "wrap";
+        }
+}
+
+/**
+ * @brief Overflow policy and counters of the arithmetic type Scalar.
+ * @details The generic version describes types that do not detect overflows, such as double.
+ * Types that do detect them specialize it, and count the overflows of every thread separately: the
+ * optimizer takes the counts of the threads that run its tasks and adds them to its own total,
+ * which it reports at the end of a run and uses to stop a run in the Trap policy.
+ */
+template <typename Scalar>
+struct OverflowTraits {
+    /**
+     * @brief Policy applied by Scalar.
+     */
+    static constexpr OverflowPolicy policy = OverflowPolicy::Wrap;
+
+    /**
+     * @brief Whether Scalar counts its overflows.
+     */
+    static constexpr bool counted = false;
+
+    /**
+     * @brief Get the number of operations that overflowed in the calling thread since the last
+     * reset() or take() in it.
+     */
+    static std::uint64_t
+    count() {
+        return 0;
+    }
+
+    /**
+     * @brief Reset the number of operations that overflowed in the calling thread.
+     */
+    static void
+    reset() {}
+
+    /**
+     * @brief Get the number of operations that overflowed in the calling thread, and reset it.
+     */
+    static std::uint64_t
+    take() {
+        return 0;
+    }
+};
+
+#endif
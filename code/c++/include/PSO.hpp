@@ -0,0 +1,1879 @@
+#ifndef PSO_HPP
+#define PSO_HPP
+
+#include "Boundary.hpp"
+#include "Checkpoint.hpp"
+#include "DynamicRange.hpp"
+#include "EvaluationCache.hpp"
+#include "Instrumentation.hpp"
+#include "Overflow.hpp"
+#include "Philox.hpp"
+#include "Result.hpp"
+#include "SharedBest.hpp"
+#include "StoppingCriteria.hpp"
+#include "SwarmArena.hpp"
+#include "SwarmStorage.hpp"
+#include "ThreadPool.hpp"
+#include "Topology.hpp"
+#include "Trajectory.hpp"
+#include "UpdateKernels.hpp"
+#include "WorkStealingQueue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief How the iterations of the particles are scheduled.
+ */
+enum class ExecutionMode {
+    /**
+     * @brief All the particles perform an iteration, then the global best is updated, then the
+     * next iteration starts.
+     */
+    Synchronous,
+    /**
+     * @brief Blocks of particles iterate independently, reading and publishing the global best as
+     * they go, without waiting for each other.
+     */
+    Asynchronous
+};
+
+/**
+ * @brief Particle Swarm Optimization (PSO) algorithm.
+ * @details This class implements the PSO algorithm. It can be used to minimize a function of
+ * several variables.
+ * @note This class is based on the pseudo-code found on the Wikipedia page for PSO:
+ * https://en.wikipedia.org/wiki/Particle_swarm_optimization#Algorithm
+ *
+ * @tparam Scalar Arithmetic type used for positions, velocities and scores, e.g. double or a
+ * fixed-point type.
+ * @tparam Dims Number of dimensions of the search space, or dynamicDimensions if it is only known
+ * at run time. Fixing it at compile time lets the loops over the dimensions be fully unrolled.
+ * @tparam Objective Type of the function to minimize. It is either a batch function, callable as
+ * `void(const SwarmView<Scalar, Dims> &, Scalar *)`, which writes the score of the j-th particle of
+ * the view into the j-th element of the output array, and is given the instruction set of the
+ * optimizer (see setSimdLevel()) as a third argument if it accepts a SimdLevel, or a function of
+ * a single particle, callable as `Scalar(const SwarmPoint<Scalar, Dims> &)`. Using the concrete
+ * type of a functor or lambda, rather than the default type-erased std::function, lets the
+ * compiler inline it.
+ */
+template <typename Scalar,
+          unsigned int Dims = dynamicDimensions,
+          typename Objective =
+              std::function<void(const SwarmView<Scalar, Dims> &, Scalar *)>>
+class PSO {
+  public:
+    /**
+     * @brief Position of a single particle.
+     */
+    using Point = SwarmPoint<Scalar, Dims>;
+
+    /**
+     * @brief Read-only view of the positions of a batch of particles.
+     */
+    using View = SwarmView<Scalar, Dims>;
+
+    /**
+     * @brief Type-erased function to minimize, evaluated on a batch of particles at once.
+     */
+    using BatchFunction = std::function<void(const View &, Scalar *)>;
+
+    /**
+     * @brief Outcome of a run, returned by run().
+     */
+    using Result = RunResult<Scalar, Point>;
+
+    /**
+     * @brief State of a run, handed to the progress callback.
+     */
+    using Progress = RunProgress<Scalar, Point>;
+
+    /**
+     * @brief Function called by run() to report its progress, see setProgressCallback().
+     */
+    using ProgressCallback = std::function<void(const Progress &)>;
+
+    /**
+     * @brief Construct a new PSO object, which will be used to minimize the given function.
+     * @details This constructor initializes the PSO object with the given parameters.
+     *
+     * @param numParticles_ Number of particles to use.
+     * @param dimensions_ Number of dimensions of the search space. Must be equal to Dims, unless
+     * Dims is dynamicDimensions.
+     * @param func_ Function to minimize.
+     * @param upperBound_ Upper bound of the search space.
+     * @param lowerBound_ Lower bound of the search space.
+     * @param w_ Inertia weight.
+     * @param c_ Cognitive weight coefficient.
+     * @param s_ Social weight coefficient.
+     * @param maxIterations_ Maximum number of iterations.
+     * @param numThreads_ Number of threads the particles are partitioned across. With more than
+     * one thread, the function to minimize is called concurrently on disjoint batches of particles,
+     * so it must be safe to call from several threads at once.
+     * @param seed_ Seed of the random numbers. For a given seed, the result of a synchronous run
+     * does not depend on the number of threads nor on the instruction set.
+     *
+     *
+     * @note The default values for c_ and s_ are 1, which means that the cognitive and social
+     * components are weighted equally. These can be changed to tune the algorithm.
+     */
+    PSO(const unsigned int  &numParticles_,
+        const unsigned int  &dimensions_,
+        const Objective     &func_,
+        const Scalar        &upperBound_,
+        const Scalar        &lowerBound_,
+        const Scalar        &w_,
+        const Scalar        &c_             = Scalar{1},
+        const Scalar        &s_             = Scalar{1},
+        const int           &maxIterations_ = 1000,
+        const unsigned int  &numThreads_    = 1,
+        const std::uint64_t &seed_          = 42) :
+        numParticles(numParticles_),
+        dimensions(dimensions_), func(func_), upperBound(upperBound_), lowerBound(lowerBound_),
+        w(w_), c(c_), s(s_), maxIterations(maxIterations_),
+        pool(std::make_unique<ThreadPool>(numThreads_)), random(seed_) {
+        setSimdLevel(detectSimdLevel());
+            if (Dims != dynamicDimensions && dimensions_ != Dims) {
+                throw std::invalid_argument("PSO: dimensions_ does not match the Dims parameter");
+        }
+        allocateSwarm();
+        resetSwarm();
+    };
+
+    /**
+     * @brief Initialize the particles.
+     * @details This function initializes the particles by randomly generating their positions and
+     * velocities. It also calculates the initial scores and sets the best scores and positions.
+     * @note This function must be called before run().
+     * @note The random numbers are drawn from the stream Philox::initializationStream of the
+     * generator keyed by the seed given to the constructor, and converted to Scalar by
+     * UniformFromBits, so that a fixed-point Scalar needs no floating-point operation.
+     * @note Resets the overflow counter of the optimizer, see getOverflows().
+     * @throws std::overflow_error If Scalar traps on overflow and an operation overflowed.
+     * @see run()
+     */
+    void
+    initializeParticles();
+
+    /**
+     * @brief Save the whole state of the swarm to a checkpoint file, see CheckpointHeader.
+     * @details The positions, velocities, scores, personal and global bests, the number of
+     * iterations and evaluations, and the seed are saved: since the random numbers only depend on
+     * the seed and on their counters, this is the whole state of the generator too. The file is
+     * written next to path and then renamed to it, so that an interrupted save leaves the
+     * previous checkpoint intact.
+     * @throws std::runtime_error If the file cannot be written.
+     * @see loadCheckpoint()
+     */
+    void
+    saveCheckpoint(const std::string &path) const;
+
+    /**
+     * @brief Restore the state of the swarm from a checkpoint file written by saveCheckpoint(),
+     * instead of initializeParticles().
+     * @details The file is mapped into memory and copied into the swarm. The next run() continues
+     * from the saved iteration: in the synchronous mode, its result is bit-exact with the one of a
+     * run that was never interrupted, whatever the number of threads.
+     * @note Resets the overflow counter of the optimizer, see getOverflows().
+     * @throws std::runtime_error If the file cannot be read.
+     * @throws std::invalid_argument If the file was saved by an optimizer with another number of
+     * particles or dimensions, or another arithmetic type.
+     */
+    void
+    loadCheckpoint(const std::string &path);
+
+    /**
+     * @brief Run the algorithm.
+     * @details This function runs the algorithm. At every iteration, it updates the positions and
+     * velocities of all the particles, one dimension at a time with the kernel selected by
+     * setSimdLevel(), evaluates the function on the whole swarm, and then updates the best scores
+     * and positions.
+     * With more than one thread, each thread updates and evaluates a contiguous range of
+     * particles and finds the best particle of its range; the global best is then reduced from
+     * these in thread order, keeping the particle with the lowest index on ties. The random
+     * factors of every particle are identified by (iteration, particle, dimension) and generated
+     * in bulk by a counter-based generator, so the result is reproducible for a given seed,
+     * whatever the number of threads.
+     * The run stops after maxIterations iterations, or earlier if one of the criteria selected by
+     * setStoppingCriteria() holds; getStopReason() tells which one did.
+     * Nothing is printed: the progress is reported to the callback set by setProgressCallback(),
+     * if any, and the outcome is returned.
+     * The run continues from the iterations already performed since initializeParticles() or
+     * loadCheckpoint(), so calling it again after a run stopped by a criterion resumes it.
+     * @note This function must be called after initializeParticles() or loadCheckpoint().
+     * @throws std::overflow_error If Scalar traps on overflow, at the end of the iteration during
+     * which an operation overflowed.
+     * @see initializeParticles()
+     *
+     * @param count Maximum number of iterations to perform, so that a run can be split into
+     * several calls; the stop reason of a call that performs them all is
+     * StopReason::MaxIterations. By default, the run goes on up to maxIterations.
+     * @return Result Best score and position, number of iterations and evaluations, why the run
+     * stopped, timings and every improvement of the global best.
+     */
+    Result
+    run(const unsigned int &count = std::numeric_limits<unsigned int>::max());
+
+    /**
+     * @brief Copy the personal bests of the count particles with the best personal best scores,
+     * best first, to another swarm, see immigrate().
+     *
+     * @param count Number of particles, at most the number of particles of the swarm.
+     * @param positions_ Receives the count personal best positions, one after the other.
+     * @param scores_ Receives the count personal best scores.
+     */
+    void
+    emigrate(const unsigned int &count, Scalar *positions_, Scalar *scores_) const;
+
+    /**
+     * @brief Receive the personal bests of particles of another swarm, see emigrate().
+     * @details Every migrant replaces the position and the personal best of one of the particles
+     * with the worst personal best scores, if it is better than it, and keeps its velocity. The
+     * global best and the neighborhood bests are updated accordingly.
+     *
+     * @param count Number of migrants, at most the number of particles of the swarm.
+     * @param positions_ Positions of the migrants, one after the other.
+     * @param scores_ Scores of the migrants.
+     */
+    void
+    immigrate(const unsigned int &count, const Scalar *positions_, const Scalar *scores_);
+
+    /**
+     * @brief Get the best position.
+     * @details This function returns the best position found by the algorithm.
+     * @return Point& that contains the best position.
+     */
+    Point &
+    getBestPosition();
+
+    /**
+     * @brief Get the best score.
+     * @details This function returns the best score found by the algorithm.
+     * @return Scalar& that contains the best score.
+     */
+    Scalar &
+    getBestScore();
+
+    /**
+     * @brief Select the instruction set used by the velocity and position update, the boundary
+     * handling, and the batch functions to minimize that accept it.
+     * @details By default, the widest instruction set supported by the CPU is used. Requesting a
+     * wider one than the CPU supports selects the widest supported one instead. All the
+     * instruction sets give bit-identical results.
+     *
+     * @param level Instruction set to use.
+     */
+    void
+    setSimdLevel(const SimdLevel &level) {
+        simdLevel    = std::min(level, detectSimdLevel());
+        updateKernel = UpdateKernel<Scalar>::select(simdLevel);
+        random.setSimdLevel(simdLevel);
+    }
+
+    /**
+     * @brief Get the instruction set used by the optimizer, see setSimdLevel().
+     */
+    SimdLevel
+    getSimdLevel() const {
+        return simdLevel;
+    }
+
+    /**
+     * @brief Get the number of dimensions of the search space.
+     * @details When Dims is not dynamicDimensions this is a compile-time constant, so that loops
+     * bounded by it can be unrolled.
+     */
+    unsigned int
+    getDimensions() const {
+        return Dims == dynamicDimensions ? dimensions : Dims;
+    }
+
+    /**
+     * @brief Select how the iterations of the particles are scheduled by run().
+     * @details In the (default) synchronous mode, every iteration ends with a barrier across the
+     * threads and a reduction of the global best, which makes the result reproducible but leaves
+     * threads idle when some particles are much slower to evaluate than others.
+     * In the asynchronous mode, the swarm is split into blocks of particles, one cache line wide,
+     * spread over per-thread work-stealing queues. A thread takes a block, moves it by one
+     * iteration towards the latest published global best, evaluates it, publishes the
+     * improvement, if any, and puts the block back at the end of its queue; threads that run out
+     * of blocks steal them from the others. Each block performs maxIterations iterations, and there
+     * is no barrier between iterations. The random factors of a block only depend on its own
+     * iteration count, but the global best is shared through a SharedBest record, so the result
+     * depends on the timing of the threads and is not reproducible.
+     *
+     * @param mode Execution mode to use.
+     */
+    void
+    setExecutionMode(const ExecutionMode &mode) {
+        executionMode = mode;
+    }
+
+    /**
+     * @brief Get how the iterations of the particles are scheduled by run().
+     */
+    ExecutionMode
+    getExecutionMode() const {
+        return executionMode;
+    }
+
+    /**
+     * @brief Select the neighborhood whose best position every particle follows, see Topology.
+     * @details With the (default) global topology, every particle follows the best position of the
+     * whole swarm, which converges fast but often prematurely on multimodal functions. With the
+     * other ones, the information spreads gradually through overlapping neighborhoods, which
+     * keeps the swarm exploring for longer. The neighbors of every particle are tabulated once,
+     * and after every iteration each particle looks for the best personal best among its own
+     * neighbors and copies it only if it changed, so the overhead of an iteration is proportional
+     * to the number of particles times the size of the neighborhoods.
+     * The global best is still kept up to date, for the results and the stopping criteria.
+     * @note Takes effect at the next initializeParticles() or loadCheckpoint(). The asynchronous
+     * mode always uses the global topology.
+     *
+     * @param topology_ Topology to use.
+     * @param informants_ Number of neighbors on each side in a ring (1 by default), or number of
+     * random informants of every particle (3 by default); ignored by the other topologies.
+     */
+    void
+    setTopology(const Topology &topology_, const unsigned int &informants_ = 0) {
+        topology   = topology_;
+        informants = informants_ > 0 ? informants_ : topology_ == Topology::Ring ? 1 : 3;
+    }
+
+    /**
+     * @brief Get the neighborhood whose best position every particle follows.
+     */
+    Topology
+    getTopology() const {
+        return topology;
+    }
+
+    /**
+     * @brief Get the number of threads the particles are partitioned across.
+     */
+    unsigned int
+    getNumThreads() const {
+        return pool->getNumThreads();
+    }
+
+    /**
+     * @brief Get the number of arithmetic operations of the optimizer that overflowed during the
+     * last run(), or since initializeParticles() or loadCheckpoint() if it did not run since.
+     * @details Always 0 for types that do not count their overflows (see OverflowTraits). Only the
+     * operations run by the optimizer are counted, so that other optimizers of the same type
+     * running at the same time do not change it, and a particle whose score comes from the
+     * evaluation cache counts none, see setEvaluationCache().
+     */
+    std::uint64_t
+    getOverflows() const {
+        return overflows;
+    }
+
+    /**
+     * @brief Select whether the largest magnitudes of the positions, velocities and scores are
+     * recorded, see getDynamicRange().
+     * @details Disabled by default, since recording them reads the whole swarm once more at every
+     * iteration.
+     */
+    void
+    setTrackDynamicRange(const bool &track) {
+        trackDynamicRange = track;
+    }
+
+    /**
+     * @brief Get the largest magnitudes of the positions, velocities and scores reached since
+     * initializeParticles(), initial values included.
+     * @note Only recorded if enabled by setTrackDynamicRange(), and updated at the end of
+     * initializeParticles() and of run().
+     */
+    const DynamicRange &
+    getDynamicRange() const {
+        return dynamicRange;
+    }
+
+    /**
+     * @brief Get the time spent by the last run() in each phase of the iterations, and the number
+     * of improvements of the personal and global bests.
+     * @note Only recorded if compiled with PSO_INSTRUMENTATION (see instrumentationEnabled),
+     * otherwise everything is zero.
+     */
+    const Instrumentation &
+    getInstrumentation() const {
+        return instrumentation;
+    }
+
+    /**
+     * @brief Select the function called by run() to report its progress, and how often.
+     * @details In the synchronous mode, callback is called at the beginning of every interval-th
+     * iteration, on the calling thread; the time it takes is excluded from the timings of the
+     * run. The asynchronous mode has no iteration shared by the whole swarm, so it does not call
+     * it.
+     *
+     * @param callback Function to call, or an empty function to report nothing (the default).
+     * @param interval Number of iterations between two calls; 0 selects a tenth of
+     * maxIterations, and at least 1.
+     */
+    void
+    setProgressCallback(const ProgressCallback &callback, const unsigned int &interval = 0) {
+        progressCallback = callback;
+        progressInterval = interval > 0 ? interval : std::max(1u, maxIterations / 10);
+    }
+
+    /**
+     * @brief Select the writer the trajectory of the swarm is recorded to by run().
+     * @details In the synchronous mode, the state after every writer->getInterval() iterations,
+     * and the final one, are handed to the writer, on the calling thread; the time it takes to
+     * buffer them is excluded from the timings of the run, as the progress callback. The
+     * asynchronous mode has no consistent state of the swarm before its end, so only the final
+     * state is recorded.
+     *
+     * @param writer_ Writer to record to, which must outlive the runs, or nullptr to record
+     * nothing (the default).
+     */
+    void
+    setTrajectoryWriter(TrajectoryWriter<Scalar> *writer_) {
+        trajectoryWriter = writer_;
+    }
+
+    /**
+     * @brief Make run() save a checkpoint to path periodically, see saveCheckpoint().
+     * @details In the synchronous mode, a checkpoint is saved after every interval-th iteration,
+     * and at the end of the run; the time it takes is excluded from the timings of the run. In the
+     * asynchronous mode, it is only saved at the end of the run.
+     *
+     * @param path Path of the checkpoint file, overwritten by every save, or an empty string to
+     * save nothing (the default).
+     * @param interval Number of iterations between two saves (at least 1).
+     */
+    void
+    setCheckpointing(const std::string &path, const unsigned int &interval) {
+        checkpointPath     = path;
+        checkpointInterval = std::max(1u, interval);
+    }
+
+    /**
+     * @brief Select the conditions that end run() before maxIterations iterations, see
+     * StoppingCriteria. By default, run() always performs maxIterations iterations.
+     */
+    void
+    setStoppingCriteria(const StoppingCriteria<Scalar> &criteria) {
+        stoppingCriteria = criteria;
+    }
+
+    /**
+     * @brief Select how run() keeps the particles between lowerBound and upperBound, and the
+     * largest absolute value of the components of their velocities.
+     * @details Both are enforced along every dimension right after the velocities and positions
+     * are updated, by branch-free loops that the compiler vectorizes, see BoundaryKernel: first the
+     * velocities are clamped, which moves the positions back by the part of the velocities that
+     * was cut off (exactly with a fixed-point Scalar, up to rounding in floating point), and then
+     * the coordinates out of bounds are handled according to policy. By default neither is
+     * enforced, so the particles may leave the search space, and with a fixed-point Scalar their
+     * velocities may grow until they overflow.
+     *
+     * @param policy What happens to the coordinates that leave the search space.
+     * @param maxVelocity_ Largest absolute value of a component of a velocity, or 0 for no maximum.
+     * Reflect and Wrap are only exact when it is at most upperBound - lowerBound.
+     */
+    void
+    setBoundaryHandling(const BoundaryPolicy &policy, const Scalar &maxVelocity_ = Scalar{0}) {
+        boundaryPolicy = policy;
+        maxVelocity    = maxVelocity_;
+    }
+
+    /**
+     * @brief Cache the scores of up to about capacity positions, so that the particles whose
+     * position was evaluated already are not evaluated again, see EvaluationCache.
+     * @details Worth it when the function to minimize is expensive: converged particles keep
+     * landing on the same positions, all the more with a fixed-point Scalar. The function must be
+     * deterministic, and the result of a run is then the same with or without the cache; the
+     * cached particles still count as evaluations, e.g. for StoppingCriteria::maxEvaluations.
+     * Their overflows do not, though: a batch function overflows for a whole batch, not for one of
+     * its particles, so the cache cannot replay them, and getOverflows() only counts the ones of
+     * the positions actually evaluated. For the same reason, the cache is refused for types that
+     * trap on overflow, which would let a run that traps without the cache finish with it. The
+     * memory of the cache, EvaluationCache::footprint(), is allocated by this call, and the cached
+     * positions are kept until the next call.
+     *
+     * @param capacity Number of positions to cache, rounded down to a power of two (at least
+     * EvaluationCache::ways), or 0 to disable the cache (the default).
+     * @throws std::invalid_argument If capacity is not 0 and Scalar uses the Trap policy.
+     */
+    void
+    setEvaluationCache(const std::size_t &capacity) {
+            if constexpr (OverflowTraits<Scalar>::policy == OverflowPolicy::Trap) {
+                    if (capacity > 0) {
+                        throw std::invalid_argument(
+                            "PSO: the evaluation cache cannot replay the overflows the Trap policy "
+                            "stops on");
+                }
+        }
+        cache = capacity > 0 ? std::make_unique<EvaluationCache<Scalar, Dims>>(
+                                   capacity, numParticles, getDimensions())
+                             : nullptr;
+    }
+
+    /**
+     * @brief Get the lookups of the evaluation cache since the beginning of the last run(), or
+     * since setEvaluationCache() if the swarm did not run yet.
+     */
+    EvaluationCacheStatistics
+    getEvaluationCacheStatistics() const {
+        return cache ? cache->getStatistics() : EvaluationCacheStatistics{};
+    }
+
+    /**
+     * @brief Get the conditions that end run() before maxIterations iterations.
+     */
+    const StoppingCriteria<Scalar> &
+    getStoppingCriteria() const {
+        return stoppingCriteria;
+    }
+
+    /**
+     * @brief Get why the last run() stopped.
+     */
+    StopReason
+    getStopReason() const {
+        return stopReason;
+    }
+
+    /**
+     * @brief Get the number of iterations performed since initializeParticles(), or since the
+     * beginning of the run saved by the checkpoint loaded by loadCheckpoint(); in the asynchronous
+     * mode, the largest number of iterations performed by a block.
+     */
+    unsigned int
+    getIterations() const {
+        return iterations;
+    }
+
+    /**
+     * @brief Get the number of evaluations of the function to minimize since
+     * initializeParticles(), initial evaluation included.
+     */
+    std::uint64_t
+    getEvaluations() const {
+        return evaluations;
+    }
+
+  private:
+    /**
+     * @brief Get the range of particles assigned to the t-th thread.
+     * @details The particles are split into contiguous ranges whose size is a multiple of the
+     * number of values that fit in the storage alignment, so that different threads never write
+     * to the same cache line.
+     *
+     * @param t Index of the thread.
+     * @param begin Set to the index of the first particle of the range.
+     * @param end Set to one past the index of the last particle of the range.
+     */
+    void
+    particleRange(const unsigned int &t, unsigned int &begin, unsigned int &end) const {
+        const unsigned int perLine = std::max<std::size_t>(
+            1, SwarmStorage<Scalar, Dims>::alignment / sizeof(Scalar));
+        const unsigned int numThreads = pool->getNumThreads();
+        const unsigned int chunk =
+            ((numParticles + numThreads - 1) / numThreads + perLine - 1) / perLine * perLine;
+        begin = std::min(numParticles, t * chunk);
+        end   = std::min(numParticles, begin + chunk);
+    }
+
+    /**
+     * @brief Evaluate the function to minimize on the whole swarm, in parallel, and store the
+     * results in scores.
+     */
+    void
+    evaluateSwarm();
+
+    /**
+     * @brief Carve the storage of the swarm and the buffers of the iterations from a new arena,
+     * sized for all of them, so that the swarm is allocated once, by the constructor.
+     */
+    void
+    allocateSwarm();
+
+    /**
+     * @brief Reset the scores and the best position, before the particles are initialized or
+     * loaded.
+     */
+    void
+    resetSwarm();
+
+    /**
+     * @brief Tabulate the neighborhoods of the topology, and find the best position of every one.
+     */
+    void
+    initializeNeighborhoods();
+
+    /**
+     * @brief Update the best positions of the neighborhoods of the particles from begin to end
+     * (excluded) with the current personal bests.
+     */
+    void
+    updateNeighborhoodBests(const unsigned int &begin, const unsigned int &end);
+
+    /**
+     * @brief Record that the personal best of the j-th particle, in the range of particles
+     * starting at begin, is its current position.
+     * @details The copy into bestPositions is deferred until the range is next updated, so that
+     * an improvement costs O(1) instead of O(dimensions): the indices of the improved particles
+     * of a range are stored from pendingBests[begin], and their number in pendingCounts[begin].
+     * The range must not be empty, since begin is then numParticles.
+     */
+    void
+    deferPersonalBest(const unsigned int &begin, const unsigned int &j) {
+        pendingBests[begin + pendingCounts[begin]++] = j;
+    }
+
+    /**
+     * @brief Copy the d-th coordinate of the deferred personal bests of the range of particles
+     * starting at begin into bestPositions.
+     * @details It is called right before the update kernel reads row d of the range, so that the
+     * rows are copied while they are in the cache, one after the other, rather than the coordinates
+     * of a particle scattered across all the rows.
+     */
+    void
+    applyPersonalBests(const unsigned int &begin, const unsigned int &d) {
+        const Scalar       *x       = positions.row(d);
+        Scalar             *p       = bestPositions.row(d);
+        const unsigned int *pending = pendingBests.data() + begin;
+            for (unsigned int k = 0; k < pendingCounts[begin]; k++) {
+                p[pending[k]] = x[pending[k]];
+            }
+    }
+
+    /**
+     * @brief Copy every deferred personal best into bestPositions, so that the state of the swarm
+     * is complete, e.g. at the end of a run or before a checkpoint.
+     */
+    void
+    applyPersonalBests();
+
+    /**
+     * @brief Reset the dynamic range to the one of the current swarm, if tracked.
+     */
+    void
+    resetDynamicRange();
+
+    /**
+     * @brief Save the state of the swarm to path, as after iterations_ iterations with the last
+     * improvement of the best score after lastImprovement_ iterations; see saveCheckpoint().
+     */
+    void
+    writeCheckpoint(const std::string  &path,
+                    const unsigned int &iterations_,
+                    const unsigned int &lastImprovement_) const;
+
+    /**
+     * @brief Run synchronous iterations up to the limit-th one, see setExecutionMode().
+     *
+     * @param start Time at which the run started.
+     * @param limit Number of iterations after which the run stops, at most maxIterations.
+     * @param result Receives the iteration and the time at which the best score was found, the
+     * improvements of the global best and the duration of the run.
+     */
+    void
+    runSynchronous(const std::chrono::high_resolution_clock::time_point &start,
+                   const unsigned int                                   &limit,
+                   Result                                               &result);
+
+    /**
+     * @brief Run asynchronous iterations of every block up to the limit-th one, see
+     * setExecutionMode().
+     *
+     * @param start Time at which the run started.
+     * @param limit Number of iterations after which a block stops, at most maxIterations.
+     * @param result Receives the iteration, of the block that found it, and the time at which the
+     * best score was found, the improvements of the global best and the duration of the run.
+     */
+    void
+    runAsynchronous(const std::chrono::high_resolution_clock::time_point &start,
+                    const unsigned int                                   &limit,
+                    Result                                               &result);
+
+    /**
+     * @brief Record the dynamic range of the particles from begin to end - 1 into the range of the
+     * t-th thread, if enabled by setTrackDynamicRange().
+     */
+    void
+    recordDynamicRange(const unsigned int &t, const unsigned int &begin, const unsigned int &end) {
+            if (!trackDynamicRange) {
+                return;
+        }
+            for (unsigned int d = 0; d < getDimensions(); d++) {
+                    for (unsigned int j = begin; j < end; j++) {
+                        threadRanges[t].recordParticle(positions(d, j), velocities(d, j));
+                    }
+            }
+            for (unsigned int j = begin; j < end; j++) {
+                threadRanges[t].recordScore(scores[j]);
+            }
+    }
+
+    /**
+     * @brief Merge the ranges recorded by the threads into dynamicRange.
+     */
+    void
+    mergeDynamicRanges() {
+            for (const DynamicRange &range : threadRanges) {
+                dynamicRange.merge(range);
+            }
+    }
+
+    /**
+     * @brief Check the stopping criteria that do not depend on the shape of the swarm, i.e. all
+     * but the swarm diameter.
+     *
+     * @param score Best score found so far.
+     * @param sinceImprovement Number of iterations since the best score last improved.
+     * @param nextEvaluations Number of evaluations of the function to minimize there would be after
+     * another iteration.
+     * @param start Time at which the run started.
+     * @param reason Set to the criterion that holds, if any.
+     * @return bool Whether a criterion holds.
+     */
+    bool
+    reachedStoppingCriterion(const Scalar                                         &score,
+                             const unsigned int                                   &sinceImprovement,
+                             const std::uint64_t                                  &nextEvaluations,
+                             const std::chrono::high_resolution_clock::time_point &start,
+                             StopReason                                           &reason) const {
+            if (stoppingCriteria.targetScore && !(*stoppingCriteria.targetScore < score)) {
+                reason = StopReason::TargetScore;
+            } else if (stoppingCriteria.stagnationIterations > 0 &&
+                       sinceImprovement >= stoppingCriteria.stagnationIterations) {
+                reason = StopReason::Stagnation;
+            } else if (stoppingCriteria.maxEvaluations > 0 &&
+                       nextEvaluations > stoppingCriteria.maxEvaluations) {
+                reason = StopReason::EvaluationBudget;
+            } else if (stoppingCriteria.timeLimit.count() > 0 &&
+                       std::chrono::high_resolution_clock::now() - start >=
+                           stoppingCriteria.timeLimit) {
+                reason = StopReason::TimeLimit;
+            } else {
+                return false;
+            }
+        return true;
+    }
+
+    /**
+     * @brief Stop the optimizer if Scalar traps on overflow and an operation has overflowed.
+     *
+     * @param iteration Iteration during which the overflows were checked.
+     * @throws std::overflow_error If Scalar uses the Trap policy and the overflow counter of the
+     * optimizer is not zero.
+     * @note The overflows must have been collected, see collectOverflows().
+     */
+    void
+    trapOverflows(const unsigned int &iteration) const {
+            if constexpr (OverflowTraits<Scalar>::policy == OverflowPolicy::Trap) {
+                    if (overflows > 0) {
+                        throw std::overflow_error(std::to_string(overflows) +
+                                                  " arithmetic overflows in iteration " +
+                                                  std::to_string(iteration));
+                }
+        }
+    }
+
+    /**
+     * @brief Run task on every thread of the pool, and keep the number of overflows each thread
+     * counted while running it, see collectOverflows().
+     */
+    void
+    runTask(const ThreadPool::Task &task) {
+        pool->run([&](const unsigned int &t) {
+            task(t);
+            threadOverflows[t] += OverflowTraits<Scalar>::take();
+        });
+    }
+
+    /**
+     * @brief Add the overflows kept by runTask(), and the ones counted by the calling thread, to
+     * the overflow counter of the optimizer.
+     */
+    void
+    collectOverflows() {
+        overflows += OverflowTraits<Scalar>::take();
+            for (std::uint64_t &count : threadOverflows) {
+                overflows += count;
+                count = 0;
+            }
+    }
+
+    /**
+     * @brief Reset the overflow counter of the optimizer, discarding the overflows counted by the
+     * calling thread outside of it.
+     */
+    void
+    resetOverflows() {
+        overflows = 0;
+        OverflowTraits<Scalar>::reset();
+        std::fill(threadOverflows.begin(), threadOverflows.end(), 0);
+    }
+
+    /**
+     * @brief Evaluate the function to minimize on every particle of x.
+     * @details Batch functions are called once; functions of a single particle are called on each
+     * particle in turn, after gathering its position into a Point.
+     *
+     * @param x Positions of the particles to evaluate.
+     * @param out Output array, the score of the j-th particle of x is written into out[j].
+     */
+    void
+    evaluate(const View &x, Scalar *out);
+
+    /**
+     * @brief Evaluate the particles from begin to end, through the cache if there is one, and
+     * store the results in scores. An empty range is not evaluated.
+     */
+    void
+    evaluateRange(const unsigned int &begin, const unsigned int &end);
+
+    /**
+     * @brief Clamp the velocities and handle the coordinates out of bounds of the particles from
+     * begin to end along the d-th dimension, after their update in the given iteration, see
+     * setBoundaryHandling().
+     * @note Overwrites the random factors of the particles, which must have been used already.
+     */
+    void
+    enforceBounds(const unsigned int &iteration,
+                  const unsigned int &begin,
+                  const unsigned int &end,
+                  const unsigned int &d);
+
+    /**
+     * @brief Number of dimensions of the search space.
+     */
+    const unsigned int dimensions;
+    /**
+     * @brief Number of particles to use.
+     */
+    const unsigned int numParticles;
+    /**
+     * @brief Function to minimize.
+     */
+    Objective func;
+    /**
+     * @brief Inertia weight.
+     */
+    const Scalar w;
+    /**
+     * @brief Cognitive weight coefficient.
+     */
+    const Scalar c;
+    /**
+     * @brief Social weight coefficient.
+     */
+    const Scalar s;
+    /**
+     * @brief Lower bound of the search space.
+     */
+    const Scalar lowerBound;
+    /**
+     * @brief Upper bound of the search space.
+     */
+    const Scalar upperBound;
+    /**
+     * @brief Maximum number of iterations to be performed.
+     */
+    const unsigned int maxIterations;
+    /**
+     * @brief Single buffer the storage of the swarm and the per-particle buffers are carved from.
+     */
+    SwarmArena arena;
+    /**
+     * @brief Positions of the particles, stored dimension-major: row d contains the d-th
+     * coordinate of every particle.
+     */
+    SwarmStorage<Scalar, Dims> positions;
+    /**
+     * @brief Best positions of the particles, stored dimension-major: row d contains the d-th
+     * coordinate of the best position found so far by every particle.
+     */
+    SwarmStorage<Scalar, Dims> bestPositions;
+    /**
+     * @brief Best position found by the algorithm so far. It is sized once by
+     * initializeParticles() and then only overwritten in place.
+     */
+    Point bestPosition;
+    /**
+     * @brief Scores of the particles. For each particle, there is a Scalar that contains its score.
+     */
+    ArenaArray<Scalar> scores;
+    /**
+     * @brief Best scores of the particles. For each particle, there is a Scalar that contains its
+     * best score found so far.
+     */
+    ArenaArray<Scalar> bestScores;
+    /**
+     * @brief Best score found by the algorithm so far.
+     */
+    Scalar bestScore;
+    /**
+     * @brief Velocities of the particles, stored dimension-major: row d contains the d-th
+     * component of the velocity of every particle.
+     */
+    SwarmStorage<Scalar, Dims> velocities;
+    /**
+     * @brief Random factors of the cognitive component for the dimension being updated, one per
+     * particle.
+     */
+    ArenaArray<Scalar> cognitiveFactors;
+    /**
+     * @brief Random factors of the social component for the dimension being updated, one per
+     * particle.
+     */
+    ArenaArray<Scalar> socialFactors;
+    /**
+     * @brief Instruction set used by the velocity and position update.
+     */
+    SimdLevel simdLevel;
+    /**
+     * @brief Velocity and position update kernel for simdLevel.
+     */
+    typename UpdateKernel<Scalar>::Function updateKernel;
+    /**
+     * @brief Persistent pool of threads the particles are partitioned across.
+     */
+    std::unique_ptr<ThreadPool> pool;
+    /**
+     * @brief What happens to the coordinates that leave the search space.
+     */
+    BoundaryPolicy boundaryPolicy = BoundaryPolicy::None;
+    /**
+     * @brief Largest absolute value of a component of a velocity, or 0 for no maximum.
+     */
+    Scalar maxVelocity = Scalar{0};
+    /**
+     * @brief Cache of the scores of the evaluated positions, if enabled by setEvaluationCache().
+     */
+    std::unique_ptr<EvaluationCache<Scalar, Dims>> cache;
+    /**
+     * @brief How the iterations of the particles are scheduled by run().
+     */
+    ExecutionMode executionMode = ExecutionMode::Synchronous;
+    /**
+     * @brief Counter-based generator of the random numbers, keyed by the seed.
+     */
+    Philox random;
+    /**
+     * @brief Whether the dynamic range of the swarm is recorded.
+     */
+    bool trackDynamicRange = false;
+    /**
+     * @brief Dynamic range of the swarm since initializeParticles().
+     */
+    DynamicRange dynamicRange;
+    /**
+     * @brief Dynamic range recorded by each thread since the last merge.
+     */
+    std::vector<DynamicRange> threadRanges;
+    /**
+     * @brief Instrumentation of the last run(), including the phases run by the calling thread.
+     */
+    Instrumentation instrumentation;
+    /**
+     * @brief Instrumentation recorded by each thread during the current run().
+     */
+    std::vector<Instrumentation> threadInstrumentations;
+    /**
+     * @brief Number of operations that overflowed, see getOverflows().
+     */
+    std::uint64_t overflows = 0;
+    /**
+     * @brief Overflows counted by each thread since the last collectOverflows().
+     */
+    std::vector<std::uint64_t> threadOverflows;
+    /**
+     * @brief Function called by run() to report its progress, if not empty.
+     */
+    ProgressCallback progressCallback;
+    /**
+     * @brief Number of iterations between two calls to progressCallback.
+     */
+    unsigned int progressInterval = 1;
+    /**
+     * @brief Writer the trajectory is recorded to, if not nullptr.
+     */
+    TrajectoryWriter<Scalar> *trajectoryWriter = nullptr;
+    /**
+     * @brief Neighborhood whose best position every particle follows.
+     */
+    Topology topology = Topology::Global;
+    /**
+     * @brief Number of neighbors on each side, or of random informants, see setTopology().
+     */
+    unsigned int informants = 1;
+    /**
+     * @brief Neighbors of every particle, unless the topology is global.
+     */
+    Neighborhoods neighborhoods;
+    /**
+     * @brief Best position of the neighborhood of every particle, unless the topology is global.
+     */
+    SwarmStorage<Scalar, Dims> neighborhoodBests;
+    /**
+     * @brief Index of the particle whose personal best is neighborhoodBests, for every particle.
+     */
+    ArenaArray<unsigned int> neighborhoodBestIndices;
+    /**
+     * @brief Indices of the particles whose personal best is deferred, see deferPersonalBest().
+     */
+    ArenaArray<unsigned int> pendingBests;
+    /**
+     * @brief Number of deferred personal bests of the range of particles starting at j, at index
+     * j, see deferPersonalBest().
+     */
+    ArenaArray<unsigned int> pendingCounts;
+    /**
+     * @brief Score of neighborhoodBests, for every particle.
+     */
+    ArenaArray<Scalar> neighborhoodBestScores;
+    /**
+     * @brief Path of the checkpoint saved by run(), if not empty.
+     */
+    std::string checkpointPath;
+    /**
+     * @brief Number of iterations between two checkpoints saved by run().
+     */
+    unsigned int checkpointInterval = 1;
+    /**
+     * @brief Conditions that end run() before maxIterations iterations.
+     */
+    StoppingCriteria<Scalar> stoppingCriteria;
+    /**
+     * @brief Why the last run() stopped.
+     */
+    StopReason stopReason = StopReason::MaxIterations;
+    /**
+     * @brief Number of iterations performed by the last run().
+     */
+    unsigned int iterations = 0;
+    /**
+     * @brief Number of iterations performed when the best score last improved, 0 if it has not
+     * improved since initializeParticles().
+     */
+    unsigned int lastImprovement = 0;
+    /**
+     * @brief Number of evaluations of the function to minimize since initializeParticles().
+     */
+    std::uint64_t evaluations = 0;
+};
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+typename PSO<Scalar, Dims, Objective>::Point &
+PSO<Scalar, Dims, Objective>::getBestPosition() {
+    return bestPosition;
+}
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+Scalar &
+PSO<Scalar, Dims, Objective>::getBestScore() {
+    return bestScore;
+}
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+void
+PSO<Scalar, Dims, Objective>::evaluate(const View &x, Scalar *out) {
+        if constexpr (std::is_invocable_v<Objective &, const View &, Scalar *, const SimdLevel &>) {
+            func(x, out, simdLevel);
+        } else if constexpr (std::is_invocable_v<Objective &, const View &, Scalar *>) {
+            func(x, out);
+        } else {
+            Point position{};
+                if constexpr (Dims == dynamicDimensions) {
+                    position.resize(x.getDimensions());
+            }
+                for (unsigned int j = 0; j < x.getNumParticles(); j++) {
+                        for (unsigned int d = 0; d < x.getDimensions(); d++) {
+                            position[d] = x(d, j);
+                        }
+                    out[j] = static_cast<Scalar>(func(position));
+                }
+        }
+}
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+void
+PSO<Scalar, Dims, Objective>::evaluateSwarm() {
+    runTask([this](const unsigned int &t) {
+        unsigned int begin, end;
+        particleRange(t, begin, end);
+        evaluateRange(begin, end);
+    });
+}
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+void
+PSO<Scalar, Dims, Objective>::evaluateRange(const unsigned int &begin, const unsigned int &end) {
+        if (begin == end) {
+            return;
+    }
+        if (cache) {
+            cache->evaluate(positions.view(begin, end - begin),
+                            begin,
+                            scores.data() + begin,
+                            [this](const View &misses, Scalar *out) { evaluate(misses, out); });
+        } else {
+            evaluate(positions.view(begin, end - begin), scores.data() + begin);
+        }
+}
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+void
+PSO<Scalar, Dims, Objective>::enforceBounds(const unsigned int &iteration,
+                                            const unsigned int &begin,
+                                            const unsigned int &end,
+                                            const unsigned int &d) {
+    Scalar *x = positions.row(d) + begin;
+    Scalar *v = velocities.row(d) + begin;
+        if (maxVelocity > Scalar{0}) {
+            BoundaryKernel<Scalar>::clampVelocities(simdLevel, end - begin, maxVelocity, x, v);
+    }
+        if (boundaryPolicy == BoundaryPolicy::None) {
+            return;
+    }
+    Scalar *fresh = cognitiveFactors.data() + begin;
+        if (boundaryPolicy == BoundaryPolicy::Reinitialize) {
+            const Scalar range = upperBound - lowerBound;
+            random.fill(iteration,
+                        d,
+                        Philox::boundaryStream,
+                        begin,
+                        end - begin,
+                        fresh,
+                        socialFactors.data() + begin);
+                for (unsigned int j = 0; j < end - begin; j++) {
+                    fresh[j] = lowerBound + fresh[j] * range;
+                }
+    }
+    BoundaryKernel<Scalar>::enforceBounds(
+        simdLevel, boundaryPolicy, end - begin, lowerBound, upperBound, x, v, fresh);
+}
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+void
+PSO<Scalar, Dims, Objective>::allocateSwarm() {
+    using Storage = SwarmStorage<Scalar, Dims>;
+    // The neighborhood buffers are carved even for the global topology, which never touches
+    // their pages, so that setTopology() allocates nothing either.
+    const std::size_t storage = Storage::footprint(numParticles, dimensions);
+    const std::size_t row     = ArenaArray<Scalar>::footprint(numParticles);
+    const std::size_t indices = ArenaArray<unsigned int>::footprint(numParticles);
+
+    arena                   = SwarmArena(4 * storage + 5 * row + 3 * indices);
+    positions               = Storage(numParticles, dimensions, arena);
+    velocities              = Storage(numParticles, dimensions, arena);
+    bestPositions           = Storage(numParticles, dimensions, arena);
+    neighborhoodBests       = Storage(numParticles, dimensions, arena);
+    scores                  = ArenaArray<Scalar>(arena, numParticles);
+    bestScores              = ArenaArray<Scalar>(arena, numParticles);
+    cognitiveFactors        = ArenaArray<Scalar>(arena, numParticles);
+    socialFactors           = ArenaArray<Scalar>(arena, numParticles);
+    neighborhoodBestScores  = ArenaArray<Scalar>(arena, numParticles);
+    neighborhoodBestIndices = ArenaArray<unsigned int>(arena, numParticles);
+    pendingBests            = ArenaArray<unsigned int>(arena, numParticles);
+    pendingCounts           = ArenaArray<unsigned int>(arena, numParticles);
+        if constexpr (Dims == dynamicDimensions) {
+            bestPosition.resize(dimensions);
+    }
+    threadRanges.resize(pool->getNumThreads());
+    threadInstrumentations.resize(pool->getNumThreads());
+    threadOverflows.resize(pool->getNumThreads());
+}
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+void
+PSO<Scalar, Dims, Objective>::resetSwarm() {
+    std::fill(bestPosition.begin(), bestPosition.end(), Scalar{0});
+    scores.fill(Scalar{0});
+    cognitiveFactors.fill(Scalar{0});
+    socialFactors.fill(Scalar{0});
+    bestScores.fill(std::numeric_limits<Scalar>::max());
+    pendingCounts.fill(0);
+}
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+void
+PSO<Scalar, Dims, Objective>::applyPersonalBests() {
+        for (unsigned int begin = 0; begin < numParticles; begin++) {
+                if (pendingCounts[begin] > 0) {
+                        for (unsigned int d = 0; d < getDimensions(); d++) {
+                            applyPersonalBests(begin, d);
+                        }
+                    pendingCounts[begin] = 0;
+            }
+        }
+}
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+void
+PSO<Scalar, Dims, Objective>::resetDynamicRange() {
+    dynamicRange = DynamicRange{};
+    threadRanges.assign(pool->getNumThreads(), DynamicRange{});
+        if (trackDynamicRange) {
+            runTask([&](const unsigned int &t) {
+                unsigned int begin, end;
+                particleRange(t, begin, end);
+                recordDynamicRange(t, begin, end);
+            });
+            mergeDynamicRanges();
+    }
+}
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+void
+PSO<Scalar, Dims, Objective>::initializeParticles() {
+    resetOverflows();
+    const Scalar range = upperBound - lowerBound;
+    bestScore          = std::numeric_limits<Scalar>::max();
+    resetSwarm();
+
+    runTask([&](const unsigned int &t) {
+        unsigned int begin, end;
+        Scalar       position, velocity;
+        particleRange(t, begin, end);
+            for (unsigned int i = begin; i < end; i++) {
+                    for (unsigned int j = 0; j < getDimensions(); j++) {
+                        random.uniform(0, i, j, Philox::initializationStream, position, velocity);
+                        positions(j, i)  = lowerBound + position * range;
+                        velocities(j, i) = velocity * (range + range) - range;
+                    }
+                bestPositions.copyParticle(i, positions);
+            }
+    });
+    evaluateSwarm();
+    resetDynamicRange();
+        for (unsigned int i = 0; i < numParticles; i++) {
+                if (scores[i] < bestScore) {
+                    bestScore = scores[i];
+                    positions.gather(i, bestPosition.data());
+            }
+        }
+    initializeNeighborhoods();
+    iterations      = 0;
+    lastImprovement = 0;
+    evaluations     = numParticles;
+    collectOverflows();
+    trapOverflows(0);
+}
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+void
+PSO<Scalar, Dims, Objective>::initializeNeighborhoods() {
+        if (topology == Topology::Global) {
+            neighborhoods = Neighborhoods();
+            return;
+    }
+    neighborhoods = Neighborhoods(topology, numParticles, informants, random);
+    // No particle follows a valid index yet, so that every neighborhood best is copied.
+    neighborhoodBestIndices.fill(numParticles);
+    neighborhoodBestScores.fill(std::numeric_limits<Scalar>::max());
+    runTask([&](const unsigned int &t) {
+        unsigned int begin, end;
+        particleRange(t, begin, end);
+        updateNeighborhoodBests(begin, end);
+    });
+}
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+void
+PSO<Scalar, Dims, Objective>::updateNeighborhoodBests(const unsigned int &begin,
+                                                      const unsigned int &end) {
+    const unsigned int size = neighborhoods.getSize();
+        for (unsigned int j = begin; j < end; j++) {
+            const unsigned int *neighbors = neighborhoods.of(j);
+            unsigned int        best      = neighbors[0];
+                for (unsigned int k = 1; k < size; k++) {
+                        if (bestScores[neighbors[k]] < bestScores[best]) {
+                            best = neighbors[k];
+                    }
+                }
+            // A personal best only moves when its score improves.
+                if (best != neighborhoodBestIndices[j] ||
+                    bestScores[best] != neighborhoodBestScores[j]) {
+                    neighborhoodBestIndices[j] = best;
+                    neighborhoodBestScores[j]  = bestScores[best];
+                    neighborhoodBests.copyParticle(j, bestPositions, best);
+            }
+        }
+}
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+void
+PSO<Scalar, Dims, Objective>::writeCheckpoint(const std::string  &path,
+                                              const unsigned int &iterations_,
+                                              const unsigned int &lastImprovement_) const {
+    static_assert(std::is_trivially_copyable_v<Scalar>, "the values are saved as their bytes");
+    static_assert(sizeof(Scalar) <= sizeof(CheckpointHeader::one), "the values fit in the header");
+    CheckpointHeader header{};
+    std::memcpy(header.magic, "PSOCKPT", 8);
+    header.version         = 1;
+    header.headerSize      = sizeof(CheckpointHeader);
+    header.scalarSize      = sizeof(Scalar);
+    header.dimensions      = getDimensions();
+    header.numParticles    = numParticles;
+    header.iterations      = iterations_;
+    header.lastImprovement = lastImprovement_;
+    header.evaluations     = evaluations;
+    header.seed            = random.getSeed();
+    const Scalar one{1};
+    std::memcpy(header.one, &one, sizeof(Scalar));
+
+    const std::size_t row = numParticles * sizeof(Scalar);
+    CheckpointWriter  writer(path);
+    writer.write(&header, sizeof(header));
+    writer.write(bestPosition.data(), getDimensions() * sizeof(Scalar));
+    writer.write(&bestScore, sizeof(Scalar));
+    writer.write(scores.data(), row);
+    writer.write(bestScores.data(), row);
+        for (const SwarmStorage<Scalar, Dims> *storage :
+             {&positions, &velocities, &bestPositions}) {
+                for (unsigned int d = 0; d < getDimensions(); d++) {
+                    writer.write(storage->row(d), row);
+                }
+        }
+    writer.commit();
+}
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+void
+PSO<Scalar, Dims, Objective>::saveCheckpoint(const std::string &path) const {
+    writeCheckpoint(path, iterations, lastImprovement);
+}
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+void
+PSO<Scalar, Dims, Objective>::loadCheckpoint(const std::string &path) {
+    CheckpointReader reader(path);
+    CheckpointHeader header;
+    reader.read(&header, sizeof(header));
+    const Scalar one{1};
+        if (std::memcmp(header.magic, "PSOCKPT", 8) != 0 || header.version != 1 ||
+            header.headerSize != sizeof(CheckpointHeader)) {
+            throw std::invalid_argument("PSO: " + path + " is not a checkpoint file");
+    }
+        if (header.scalarSize != sizeof(Scalar) || std::memcmp(header.one, &one, sizeof(Scalar)) ||
+            header.dimensions != getDimensions() || header.numParticles != numParticles) {
+            throw std::invalid_argument("PSO: " + path +
+                                        " was saved with other dimensions, particles or types");
+    }
+
+    resetOverflows();
+    resetSwarm();
+    const std::size_t row = numParticles * sizeof(Scalar);
+    reader.read(bestPosition.data(), getDimensions() * sizeof(Scalar));
+    reader.read(&bestScore, sizeof(Scalar));
+    reader.read(scores.data(), row);
+    reader.read(bestScores.data(), row);
+        for (SwarmStorage<Scalar, Dims> *storage : {&positions, &velocities, &bestPositions}) {
+                for (unsigned int d = 0; d < getDimensions(); d++) {
+                    reader.read(storage->row(d), row);
+                }
+        }
+    iterations      = header.iterations;
+    lastImprovement = header.lastImprovement;
+    evaluations     = header.evaluations;
+    random          = Philox(header.seed);
+    setSimdLevel(simdLevel);
+    initializeNeighborhoods();
+    resetDynamicRange();
+}
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+void
+PSO<Scalar, Dims, Objective>::runSynchronous(
+    const std::chrono::high_resolution_clock::time_point &start,
+    const unsigned int                                   &limit,
+    Result                                               &result) {
+    using clock                      = std::chrono::high_resolution_clock;
+    const unsigned int numThreads    = pool->getNumThreads();
+    const bool         trackDiameter = stoppingCriteria.minDiameter.has_value();
+
+    std::vector<unsigned int> candidates(numThreads);
+    // Smallest and largest coordinates of the range of each thread, for the swarm diameter.
+    std::vector<Point>        lows(numThreads, bestPosition);
+    std::vector<Point>        highs(numThreads, bestPosition);
+    unsigned int              i        = iterations;
+    const unsigned int        first    = i;
+    // Number of iterations performed when the best score last improved.
+    unsigned int              improved = lastImprovement;
+    // Time spent in the progress callback and the trajectory writer, excluded from the timings.
+    clock::duration           excluded{0};
+    // The best score improves at most once per iteration, so that the iterations never allocate.
+    result.history.reserve(limit > i ? limit - i : 0);
+
+    // Update, evaluate and find the best improved particle of the range of the t-th thread.
+    const ThreadPool::Task step = [&](const unsigned int &t) {
+        unsigned int begin, end;
+        particleRange(t, begin, end);
+        candidates[t] = numParticles;
+            // A thread left without particles has nothing to do, and must not touch the pending
+            // personal bests at index numParticles, which belong to no range.
+            if (begin == end) {
+                    if (trackDiameter) {
+                        for (unsigned int d = 0; d < getDimensions(); d++) {
+                            lows[t][d]  = std::numeric_limits<Scalar>::max();
+                            highs[t][d] = std::numeric_limits<Scalar>::lowest();
+                        }
+                }
+                return;
+        }
+        PhaseTimer<> timer(threadInstrumentations[t]);
+            for (unsigned int d = 0; d < getDimensions(); d++) {
+                random.fill(i,
+                            d,
+                            Philox::updateStream,
+                            begin,
+                            end - begin,
+                            cognitiveFactors.data() + begin,
+                            socialFactors.data() + begin);
+                timer.lap(Phase::Random);
+                applyPersonalBests(begin, d);
+                    if (topology == Topology::Global) {
+                        updateKernel(end - begin,
+                                     w,
+                                     c,
+                                     s,
+                                     bestPosition[d],
+                                     positions.row(d) + begin,
+                                     velocities.row(d) + begin,
+                                     bestPositions.row(d) + begin,
+                                     cognitiveFactors.data() + begin,
+                                     socialFactors.data() + begin);
+                    } else {
+                        updateParticlesNeighborhood(end - begin,
+                                                    w,
+                                                    c,
+                                                    s,
+                                                    neighborhoodBests.row(d) + begin,
+                                                    positions.row(d) + begin,
+                                                    velocities.row(d) + begin,
+                                                    bestPositions.row(d) + begin,
+                                                    cognitiveFactors.data() + begin,
+                                                    socialFactors.data() + begin);
+                    }
+                enforceBounds(i, begin, end, d);
+                    if (trackDiameter) {
+                        const Scalar *x = positions.row(d);
+                        lows[t][d]      = std::numeric_limits<Scalar>::max();
+                        highs[t][d]     = std::numeric_limits<Scalar>::lowest();
+                            for (unsigned int j = begin; j < end; j++) {
+                                lows[t][d]  = std::min(lows[t][d], x[j]);
+                                highs[t][d] = std::max(highs[t][d], x[j]);
+                            }
+                }
+                timer.lap(Phase::Update);
+            }
+        pendingCounts[begin] = 0;
+        evaluateRange(begin, end);
+        timer.lap(Phase::Evaluation);
+            for (unsigned int j = begin; j < end; j++) {
+                    if (scores[j] < bestScores[j]) {
+                        threadInstrumentations[t].countPersonalBest();
+                        bestScores[j] = scores[j];
+                            // The neighbors read the personal bests of the whole swarm right
+                            // after this step, so they cannot be deferred.
+                            if (topology == Topology::Global) {
+                                deferPersonalBest(begin, j);
+                            } else {
+                                bestPositions.copyParticle(j, positions);
+                            }
+                            if (candidates[t] == numParticles ||
+                                bestScores[j] < bestScores[candidates[t]]) {
+                                candidates[t] = j;
+                        }
+                }
+            }
+        timer.lap(Phase::Reduction);
+        recordDynamicRange(t, begin, end);
+    };
+
+    // Follow the personal bests found by step() in the neighborhoods of the t-th thread's range.
+    const ThreadPool::Task followNeighborhoods = [&](const unsigned int &t) {
+        unsigned int begin, end;
+        particleRange(t, begin, end);
+        PhaseTimer<> timer(threadInstrumentations[t]);
+        updateNeighborhoodBests(begin, end);
+        timer.lap(Phase::Reduction);
+    };
+
+    bool stop =
+        reachedStoppingCriterion(bestScore, 0, evaluations + numParticles, start, stopReason);
+        for (; i < limit && !stop; i++) {
+                if ((progressCallback && i % progressInterval == 0) ||
+                    (trajectoryWriter != nullptr && trajectoryWriter->wants(i)) ||
+                    (!checkpointPath.empty() && i > first && i % checkpointInterval == 0)) {
+                    const clock::time_point reportStart = clock::now();
+                        if (progressCallback && i % progressInterval == 0) {
+                            progressCallback(Progress{i, evaluations, bestScore, bestPosition});
+                    }
+                        if (trajectoryWriter != nullptr && trajectoryWriter->wants(i)) {
+                            trajectoryWriter->record(
+                                i, bestScore, bestPosition.data(), positions, velocities);
+                    }
+                        if (!checkpointPath.empty() && i > first && i % checkpointInterval == 0) {
+                            applyPersonalBests();
+                            writeCheckpoint(checkpointPath, i, improved);
+                    }
+                    excluded += clock::now() - reportStart;
+            }
+            runTask(step);
+                if (topology != Topology::Global) {
+                    runTask(followNeighborhoods);
+            }
+            PhaseTimer<> timer(instrumentation);
+            // The global best is only copied once per iteration, from the best candidate.
+            unsigned int best = numParticles;
+                for (const unsigned int &j : candidates) {
+                        if (j < numParticles &&
+                            bestScores[j] < (best < numParticles ? bestScores[best] : bestScore)) {
+                            best = j;
+                    }
+                }
+                if (best < numParticles) {
+                    instrumentation.countGlobalBest();
+                    bestScore = bestScores[best];
+                    positions.gather(best, bestPosition.data());
+                    result.timeUntilBest = clock::now() - start - excluded;
+                    result.bestIteration = i;
+                    improved             = i + 1;
+                    result.history.push_back({i, result.timeUntilBest, bestScore});
+            }
+            Scalar diameter{0};
+                if (trackDiameter) {
+                        for (unsigned int d = 0; d < getDimensions(); d++) {
+                            Scalar low = lows[0][d], high = highs[0][d];
+                                for (unsigned int t = 1; t < numThreads; t++) {
+                                    low  = std::min(low, lows[t][d]);
+                                    high = std::max(high, highs[t][d]);
+                                }
+                            diameter = std::max(diameter, high - low);
+                        }
+            }
+            timer.lap(Phase::Reduction);
+            collectOverflows();
+            trapOverflows(i);
+            evaluations += numParticles;
+                if (trackDiameter && diameter < *stoppingCriteria.minDiameter) {
+                    stopReason = StopReason::SwarmDiameter;
+                    stop       = true;
+                } else {
+                    stop = reachedStoppingCriterion(
+                        bestScore, i + 1 - improved, evaluations + numParticles, start, stopReason);
+                }
+        }
+    result.totalTime = clock::now() - start - excluded;
+    iterations       = i;
+    lastImprovement  = improved;
+    applyPersonalBests();
+        if (trajectoryWriter != nullptr) {
+            trajectoryWriter->record(i, bestScore, bestPosition.data(), positions, velocities);
+    }
+        if (!checkpointPath.empty()) {
+            writeCheckpoint(checkpointPath, iterations, lastImprovement);
+    }
+}
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+void
+PSO<Scalar, Dims, Objective>::runAsynchronous(
+    const std::chrono::high_resolution_clock::time_point &start,
+    const unsigned int                                   &limit,
+    Result                                               &result) {
+    using clock                   = std::chrono::high_resolution_clock;
+    const unsigned int numThreads = pool->getNumThreads();
+    const unsigned int blockSize =
+        std::max<std::size_t>(1, SwarmStorage<Scalar, Dims>::alignment / sizeof(Scalar));
+    const unsigned int numBlocks = (numParticles + blockSize - 1) / blockSize;
+
+    std::vector<std::unique_ptr<WorkStealingQueue>> queues;
+    std::vector<Point>                              localBests(numThreads, bestPosition);
+    std::vector<Point>                              candidates(numThreads, bestPosition);
+    std::vector<unsigned int>                       blockIterations(numBlocks, iterations);
+    // Last improvement of the global best published by each thread in each iteration of its
+    // blocks, from the first one of the run, so that the threads never allocate; an iteration
+    // without one is marked with limit.
+    std::vector<std::vector<Improvement<Scalar>>>   improvements(numThreads);
+    std::atomic<unsigned int>                       remaining{numBlocks};
+    std::atomic<bool>                               stopped{false};
+    std::atomic<StopReason>                         reason{StopReason::MaxIterations};
+    std::atomic<unsigned int>                       trapIteration{0};
+    std::atomic<std::uint64_t>                      evaluationsDone{evaluations};
+    SharedBest<Scalar> sharedBest(getDimensions(),
+                                  numThreads,
+                                  bestScore,
+                                  bestPosition.data(),
+                                  lastImprovement > 0 ? lastImprovement - 1 : 0);
+
+    // Stop every thread, keeping the reason of the first one that stops.
+    const auto stopWith = [&](const StopReason &stopReason_) {
+        StopReason expected = StopReason::MaxIterations;
+        reason.compare_exchange_strong(expected, stopReason_, std::memory_order_relaxed);
+        stopped.store(true, std::memory_order_relaxed);
+    };
+
+        for (unsigned int t = 0; t < numThreads; t++) {
+            queues.push_back(std::make_unique<WorkStealingQueue>(numBlocks));
+            improvements[t].resize(limit > iterations ? limit - iterations : 0,
+                                   Improvement<Scalar>{limit, {}, bestScore});
+        }
+        for (unsigned int b = 0; b < numBlocks; b++) {
+            queues[static_cast<unsigned long>(b) * numThreads / numBlocks]->push(b);
+        }
+
+    runTask([&](const unsigned int &t) {
+        Scalar      *localBest = localBests[t].data();
+        unsigned int b;
+            while (remaining.load(std::memory_order_acquire) > 0 &&
+                   !stopped.load(std::memory_order_relaxed)) {
+                bool found = queues[t]->pop(b);
+                    for (unsigned int k = 1; !found && k < numThreads; k++) {
+                        found = queues[(t + k) % numThreads]->steal(b);
+                    }
+                    if (!found) {
+                        std::this_thread::yield();
+                        continue;
+                }
+
+                const unsigned int begin = b * blockSize;
+                const unsigned int end   = std::min(numParticles, begin + blockSize);
+                const unsigned int count = end - begin;
+                    if (stoppingCriteria.maxEvaluations > 0 &&
+                        evaluationsDone.fetch_add(count, std::memory_order_relaxed) + count >
+                            stoppingCriteria.maxEvaluations) {
+                        evaluationsDone.fetch_sub(count, std::memory_order_relaxed);
+                        stopWith(StopReason::EvaluationBudget);
+                        continue;
+                }
+                PhaseTimer<> timer(threadInstrumentations[t]);
+                Scalar       globalScore = sharedBest.load(localBest);
+                    for (unsigned int d = 0; d < getDimensions(); d++) {
+                        random.fill(blockIterations[b],
+                                    d,
+                                    Philox::updateStream,
+                                    begin,
+                                    end - begin,
+                                    cognitiveFactors.data() + begin,
+                                    socialFactors.data() + begin);
+                        timer.lap(Phase::Random);
+                        applyPersonalBests(begin, d);
+                        updateKernel(end - begin,
+                                     w,
+                                     c,
+                                     s,
+                                     localBest[d],
+                                     positions.row(d) + begin,
+                                     velocities.row(d) + begin,
+                                     bestPositions.row(d) + begin,
+                                     cognitiveFactors.data() + begin,
+                                     socialFactors.data() + begin);
+                        enforceBounds(blockIterations[b], begin, end, d);
+                        timer.lap(Phase::Update);
+                    }
+                pendingCounts[begin] = 0;
+                evaluateRange(begin, end);
+                timer.lap(Phase::Evaluation);
+                unsigned int candidate = numParticles;
+                    for (unsigned int j = begin; j < end; j++) {
+                            if (scores[j] < bestScores[j]) {
+                                threadInstrumentations[t].countPersonalBest();
+                                bestScores[j] = scores[j];
+                                deferPersonalBest(begin, j);
+                                    if (candidate == numParticles ||
+                                        bestScores[j] < bestScores[candidate]) {
+                                        candidate = j;
+                                }
+                        }
+                    }
+                    if (candidate != numParticles) {
+                        positions.gather(candidate, candidates[t].data());
+                        const Scalar *position = candidates[t].data();
+                            if (sharedBest.publish(
+                                    t, bestScores[candidate], position, blockIterations[b])) {
+                                threadInstrumentations[t].countGlobalBest();
+                                improvements[t][blockIterations[b] - iterations] = {
+                                    blockIterations[b], clock::now() - start, bestScores[candidate]};
+                                globalScore = bestScores[candidate];
+                        }
+                }
+                timer.lap(Phase::Reduction);
+                recordDynamicRange(t, begin, end);
+                const unsigned int improved = sharedBest.getIteration();
+                StopReason         stopReason_;
+                    if (reachedStoppingCriterion(globalScore,
+                                                 blockIterations[b] > improved
+                                                     ? blockIterations[b] - improved
+                                                     : 0,
+                                                 0,
+                                                 start,
+                                                 stopReason_)) {
+                        stopWith(stopReason_);
+                }
+                    if constexpr (OverflowTraits<Scalar>::policy == OverflowPolicy::Trap) {
+                            // The overflows of the worker are only collected once it stops.
+                            if (OverflowTraits<Scalar>::count() > 0) {
+                                trapIteration.store(blockIterations[b], std::memory_order_relaxed);
+                                stopped.store(true, std::memory_order_relaxed);
+                        }
+                }
+
+                    if (++blockIterations[b] < limit) {
+                        queues[t]->push(b);
+                    } else {
+                        remaining.fetch_sub(1, std::memory_order_release);
+                    }
+            }
+    });
+
+    result.totalTime = clock::now() - start;
+    bestScore        = sharedBest.load(bestPosition.data());
+    stopReason       = reason.load();
+        for (const std::vector<Improvement<Scalar>> &published : improvements) {
+                for (const Improvement<Scalar> &improvement : published) {
+                        if (improvement.iteration < limit) {
+                            result.history.push_back(improvement);
+                    }
+                }
+        }
+    // A publication only succeeds with a better score than every previous one.
+    std::sort(result.history.begin(),
+              result.history.end(),
+              [](const Improvement<Scalar> &a, const Improvement<Scalar> &b) {
+                  return b.score < a.score;
+              });
+        if (!result.history.empty()) {
+            result.bestIteration = result.history.back().iteration;
+            result.timeUntilBest = result.history.back().time;
+            lastImprovement      = result.bestIteration + 1;
+    }
+    iterations = *std::max_element(blockIterations.begin(), blockIterations.end());
+        for (unsigned int b = 0; b < numBlocks; b++) {
+            evaluations += static_cast<std::uint64_t>(blockIterations[b]) *
+                           (std::min(numParticles, (b + 1) * blockSize) - b * blockSize);
+        }
+    applyPersonalBests();
+        if (trajectoryWriter != nullptr) {
+            trajectoryWriter->record(
+                iterations, bestScore, bestPosition.data(), positions, velocities);
+    }
+        if (!checkpointPath.empty()) {
+            writeCheckpoint(checkpointPath, iterations, lastImprovement);
+    }
+    collectOverflows();
+    trapOverflows(trapIteration.load());
+}
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+void
+PSO<Scalar, Dims, Objective>::emigrate(const unsigned int &count,
+                                       Scalar             *positions_,
+                                       Scalar             *scores_) const {
+    std::vector<unsigned int> order(numParticles);
+    std::iota(order.begin(), order.end(), 0u);
+    std::partial_sort(order.begin(),
+                      order.begin() + count,
+                      order.end(),
+                      [&](const unsigned int &a, const unsigned int &b) {
+                          return bestScores[a] < bestScores[b];
+                      });
+        for (unsigned int k = 0; k < count; k++) {
+            bestPositions.gather(order[k], positions_ + k * getDimensions());
+            scores_[k] = bestScores[order[k]];
+        }
+}
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+void
+PSO<Scalar, Dims, Objective>::immigrate(const unsigned int &count,
+                                        const Scalar       *positions_,
+                                        const Scalar       *scores_) {
+    std::vector<unsigned int> order(numParticles);
+    std::iota(order.begin(), order.end(), 0u);
+    std::partial_sort(order.begin(),
+                      order.begin() + count,
+                      order.end(),
+                      [&](const unsigned int &a, const unsigned int &b) {
+                          return bestScores[b] < bestScores[a];
+                      });
+        for (unsigned int k = 0; k < count; k++) {
+            const unsigned int j        = order[k];
+            const Scalar      *position = positions_ + k * getDimensions();
+                if (!(scores_[k] < bestScores[j])) {
+                    continue;
+            }
+                for (unsigned int d = 0; d < getDimensions(); d++) {
+                    positions.row(d)[j]     = position[d];
+                    bestPositions.row(d)[j] = position[d];
+                }
+            scores[j]     = scores_[k];
+            bestScores[j] = scores_[k];
+                if (scores_[k] < bestScore) {
+                    bestScore = scores_[k];
+                    std::copy_n(position, getDimensions(), bestPosition.data());
+                    lastImprovement = iterations;
+            }
+        }
+        if (topology != Topology::Global) {
+            updateNeighborhoodBests(0, numParticles);
+    }
+}
+
+template <typename Scalar, unsigned int Dims, typename Objective>
+typename PSO<Scalar, Dims, Objective>::Result
+PSO<Scalar, Dims, Objective>::run(const unsigned int &count) {
+    Result result;
+    result.bestIteration = lastImprovement > 0 ? lastImprovement - 1 : 0;
+    instrumentation = Instrumentation{};
+    threadInstrumentations.assign(pool->getNumThreads(), Instrumentation{});
+    resetOverflows();
+        if (cache) {
+            cache->resetStatistics();
+    }
+    const unsigned int limit =
+        count < maxIterations - std::min(iterations, maxIterations) ? iterations + count
+                                                                    : maxIterations;
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    stopReason       = StopReason::MaxIterations;
+        try {
+                if (executionMode == ExecutionMode::Asynchronous) {
+                    runAsynchronous(start, limit, result);
+                } else {
+                    runSynchronous(start, limit, result);
+                }
+        } catch (...) {
+            // Leave a consistent swarm behind, e.g. for a checkpoint after an overflow trap.
+            applyPersonalBests();
+            throw;
+        }
+    mergeDynamicRanges();
+    collectOverflows();
+        for (const Instrumentation &recorded : threadInstrumentations) {
+            instrumentation.merge(recorded);
+        }
+    result.bestScore       = bestScore;
+    result.bestPosition    = bestPosition;
+    result.iterations      = iterations;
+    result.evaluations     = evaluations;
+    result.stopReason      = stopReason;
+    result.overflows       = getOverflows();
+    result.instrumentation = instrumentation;
+    result.cache           = getEvaluationCacheStatistics();
+    return result;
+}
+
+#endif
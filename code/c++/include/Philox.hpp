@@ -0,0 +1,574 @@
+#ifndef PHILOX_HPP
+#define PHILOX_HPP
+
+#include "UpdateKernels.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief Multipliers and key increments of Philox4x32.
+ */
+constexpr std::uint32_t philoxM0 = 0xD2511F53;
+constexpr std::uint32_t philoxM1 = 0xCD9E8D57;
+constexpr std::uint32_t philoxW0 = 0x9E3779B9;
+constexpr std::uint32_t philoxW1 = 0xBB67AE85;
+
+/**
+ * @brief Number of rounds of Philox4x32 (the variant known as Philox4x32-10).
+ */
+constexpr unsigned int philoxRounds = 10;
+
+/**
+ * @brief Encrypt a 128-bit counter with Philox4x32-10 under a 64-bit key.
+ * @details Philox is a counter-based generator: every output block is a pure function of its
+ * counter and key, so blocks can be computed in any order and on any thread.
+ *
+ * @param counter Counter, updated in place with the 4 random words.
+ * @param key0 Low half of the key.
+ * @param key1 High half of the key.
+ */
+inline void
+philox4x32(std::uint32_t counter[4], std::uint32_t key0, std::uint32_t key1) {
+        for (unsigned int r = 0; r < philoxRounds; r++) {
+            const std::uint64_t p0 = static_cast<std::uint64_t>(philoxM0) * counter[0];
+            const std::uint64_t p1 = static_cast<std::uint64_t>(philoxM1) * counter[2];
+            const std::uint32_t c1 = counter[1];
+            const std::uint32_t c3 = counter[3];
+            counter[0]             = static_cast<std::uint32_t>(p1 >> 32) ^ c1 ^ key0;
+            counter[1]             = static_cast<std::uint32_t>(p1);
+            counter[2]             = static_cast<std::uint32_t>(p0 >> 32) ^ c3 ^ key1;
+            counter[3]             = static_cast<std::uint32_t>(p0);
+            key0 += philoxW0;
+            key1 += philoxW1;
+        }
+}
+
+/**
+ * @brief Map two random words to a double uniformly distributed in [0, 1).
+ * @details The 52 most significant bits of hi:lo become the mantissa of a double in [1, 2), from
+ * which 1 is subtracted. The vectorized kernels use the same bit manipulation, so that they give
+ * bit-identical results.
+ */
+inline double
+philoxToUniform(const std::uint32_t &hi, const std::uint32_t &lo) {
+    const std::uint64_t bits = 0x3FF0000000000000ull |
+                               (((static_cast<std::uint64_t>(hi) << 32) | lo) >> 12);
+    double              value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value - 1.0;
+}
+
+/**
+ * @brief Fill a and b with the random numbers of n consecutive particles along one dimension.
+ * @details The numbers of particle begin + j come from the block of the counter
+ * (begin + j, dimension, iteration, stream): a[j] from its first two words and b[j] from the last
+ * two.
+ *
+ * @param key0 Low half of the key.
+ * @param key1 High half of the key.
+ * @param iteration Iteration the numbers are drawn for.
+ * @param dimension Dimension the numbers are drawn for.
+ * @param stream Independent sequence the numbers are drawn from.
+ * @param begin Index of the first particle.
+ * @param n Number of particles.
+ * @param a First number of every particle.
+ * @param b Second number of every particle.
+ */
+inline void
+philoxFillScalar(const std::uint32_t &key0,
+                 const std::uint32_t &key1,
+                 const std::uint32_t &iteration,
+                 const std::uint32_t &dimension,
+                 const std::uint32_t &stream,
+                 const std::uint32_t &begin,
+                 const unsigned int  &n,
+                 double *__restrict a,
+                 double *__restrict b) {
+        for (unsigned int j = 0; j < n; j++) {
+            std::uint32_t counter[4] = {begin + j, dimension, iteration, stream};
+            philox4x32(counter, key0, key1);
+            a[j] = philoxToUniform(counter[0], counter[1]);
+            b[j] = philoxToUniform(counter[2], counter[3]);
+        }
+}
+
+/**
+ * @brief Fill a and b with random words of n consecutive particles along one dimension.
+ * @details Integer-only counterpart of philoxFillScalar(): a[j] and b[j] receive the first and the
+ * third word of the block of particle begin + j, i.e. the most significant words of the pairs
+ * philoxFillScalar() maps to a[j] and b[j].
+ */
+inline void
+philoxBitsScalar(const std::uint32_t &key0,
+                 const std::uint32_t &key1,
+                 const std::uint32_t &iteration,
+                 const std::uint32_t &dimension,
+                 const std::uint32_t &stream,
+                 const std::uint32_t &begin,
+                 const unsigned int  &n,
+                 std::uint32_t *__restrict a,
+                 std::uint32_t *__restrict b) {
+        for (unsigned int j = 0; j < n; j++) {
+            std::uint32_t counter[4] = {begin + j, dimension, iteration, stream};
+            philox4x32(counter, key0, key1);
+            a[j] = counter[0];
+            b[j] = counter[2];
+        }
+}
+
+#ifdef PSO_X86_KERNELS
+/**
+ * @brief Multiply the 32-bit lanes of x by m, and return the high and low halves of the products.
+ */
+__attribute__((target("avx2"))) inline void
+philoxMultiplyAVX2(const __m256i &x, const __m256i &m, __m256i &hi, __m256i &lo) {
+    const __m256i even = _mm256_mul_epu32(x, m);
+    const __m256i odd  = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), m);
+    hi                 = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+    lo                 = _mm256_mullo_epi32(x, m);
+}
+
+/**
+ * @brief AVX2 version of philox4x32(), encrypting the counters of 8 consecutive particles, from
+ * first, at once.
+ *
+ * @param c Receives the 4 words of the 8 blocks, c[k] holding the k-th word of every block.
+ */
+__attribute__((target("avx2"))) inline void
+philox4x32AVX2(__m256i c[4],
+               const std::uint32_t &first,
+               const std::uint32_t &dimension,
+               const std::uint32_t &iteration,
+               const std::uint32_t &stream,
+               std::uint32_t        key0,
+               std::uint32_t        key1) {
+    const __m256i m0    = _mm256_set1_epi32(static_cast<int>(philoxM0));
+    const __m256i m1    = _mm256_set1_epi32(static_cast<int>(philoxM1));
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    c[0]                = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(first)), lanes);
+    c[1]                = _mm256_set1_epi32(static_cast<int>(dimension));
+    c[2]                = _mm256_set1_epi32(static_cast<int>(iteration));
+    c[3]                = _mm256_set1_epi32(static_cast<int>(stream));
+        for (unsigned int r = 0; r < philoxRounds; r++) {
+            __m256i hi0, lo0, hi1, lo1;
+            philoxMultiplyAVX2(c[0], m0, hi0, lo0);
+            philoxMultiplyAVX2(c[2], m1, hi1, lo1);
+            c[0] = _mm256_xor_si256(_mm256_xor_si256(hi1, c[1]),
+                                    _mm256_set1_epi32(static_cast<int>(key0)));
+            c[1] = lo1;
+            c[2] = _mm256_xor_si256(_mm256_xor_si256(hi0, c[3]),
+                                    _mm256_set1_epi32(static_cast<int>(key1)));
+            c[3] = lo0;
+            key0 += philoxW0;
+            key1 += philoxW1;
+        }
+}
+
+/**
+ * @brief Map 4 32-bit lanes of hi and lo to doubles in [0, 1), see philoxToUniform().
+ */
+__attribute__((target("avx2"))) inline __m256d
+philoxToUniformAVX2(const __m128i &hi, const __m128i &lo) {
+    const __m256i bits = _mm256_or_si256(
+        _mm256_set1_epi64x(0x3FF0000000000000ll),
+        _mm256_srli_epi64(_mm256_or_si256(_mm256_slli_epi64(_mm256_cvtepu32_epi64(hi), 32),
+                                          _mm256_cvtepu32_epi64(lo)),
+                          12));
+    return _mm256_sub_pd(_mm256_castsi256_pd(bits), _mm256_set1_pd(1.0));
+}
+
+/**
+ * @brief AVX2 version of philoxFillScalar(), generating the numbers of 8 particles at once.
+ */
+__attribute__((target("avx2"))) inline void
+philoxFillAVX2(const std::uint32_t &key0,
+               const std::uint32_t &key1,
+               const std::uint32_t &iteration,
+               const std::uint32_t &dimension,
+               const std::uint32_t &stream,
+               const std::uint32_t &begin,
+               const unsigned int  &n,
+               double *__restrict a,
+               double *__restrict b) {
+    unsigned int j = 0;
+        for (; j + 8 <= n; j += 8) {
+            __m256i c[4];
+            philox4x32AVX2(c, begin + j, dimension, iteration, stream, key0, key1);
+            _mm256_storeu_pd(a + j,
+                             philoxToUniformAVX2(_mm256_castsi256_si128(c[0]),
+                                                 _mm256_castsi256_si128(c[1])));
+            _mm256_storeu_pd(a + j + 4,
+                             philoxToUniformAVX2(_mm256_extracti128_si256(c[0], 1),
+                                                 _mm256_extracti128_si256(c[1], 1)));
+            _mm256_storeu_pd(b + j,
+                             philoxToUniformAVX2(_mm256_castsi256_si128(c[2]),
+                                                 _mm256_castsi256_si128(c[3])));
+            _mm256_storeu_pd(b + j + 4,
+                             philoxToUniformAVX2(_mm256_extracti128_si256(c[2], 1),
+                                                 _mm256_extracti128_si256(c[3], 1)));
+        }
+    philoxFillScalar(key0, key1, iteration, dimension, stream, begin + j, n - j, a + j, b + j);
+}
+
+/**
+ * @brief AVX2 version of philoxBitsScalar(), generating the words of 8 particles at once.
+ */
+__attribute__((target("avx2"))) inline void
+philoxBitsAVX2(const std::uint32_t &key0,
+               const std::uint32_t &key1,
+               const std::uint32_t &iteration,
+               const std::uint32_t &dimension,
+               const std::uint32_t &stream,
+               const std::uint32_t &begin,
+               const unsigned int  &n,
+               std::uint32_t *__restrict a,
+               std::uint32_t *__restrict b) {
+    unsigned int j = 0;
+        for (; j + 8 <= n; j += 8) {
+            __m256i c[4];
+            philox4x32AVX2(c, begin + j, dimension, iteration, stream, key0, key1);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(a + j), c[0]);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(b + j), c[2]);
+        }
+    philoxBitsScalar(key0, key1, iteration, dimension, stream, begin + j, n - j, a + j, b + j);
+}
+
+// The AVX-512 intrinsics of GCC 12 initialize their unused operands with themselves, which
+// triggers false -Wmaybe-uninitialized warnings once inlined.
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+/**
+ * @brief Multiply the 32-bit lanes of x by m, and return the high and low halves of the products.
+ */
+__attribute__((target("avx512f"))) inline void
+philoxMultiplyAVX512(const __m512i &x, const __m512i &m, __m512i &hi, __m512i &lo) {
+    const __m512i even = _mm512_mul_epu32(x, m);
+    const __m512i odd  = _mm512_mul_epu32(_mm512_srli_epi64(x, 32), m);
+    hi                 = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(even, 32), odd);
+    lo                 = _mm512_mullo_epi32(x, m);
+}
+
+/**
+ * @brief AVX-512 version of philox4x32(), encrypting the counters of 16 consecutive particles,
+ * from first, at once.
+ *
+ * @param c Receives the 4 words of the 16 blocks, c[k] holding the k-th word of every block.
+ */
+__attribute__((target("avx512f"))) inline void
+philox4x32AVX512(__m512i c[4],
+                 const std::uint32_t &first,
+                 const std::uint32_t &dimension,
+                 const std::uint32_t &iteration,
+                 const std::uint32_t &stream,
+                 std::uint32_t        key0,
+                 std::uint32_t        key1) {
+    const __m512i m0 = _mm512_set1_epi32(static_cast<int>(philoxM0));
+    const __m512i m1 = _mm512_set1_epi32(static_cast<int>(philoxM1));
+    const __m512i lanes =
+        _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    c[0] = _mm512_add_epi32(_mm512_set1_epi32(static_cast<int>(first)), lanes);
+    c[1] = _mm512_set1_epi32(static_cast<int>(dimension));
+    c[2] = _mm512_set1_epi32(static_cast<int>(iteration));
+    c[3] = _mm512_set1_epi32(static_cast<int>(stream));
+        for (unsigned int r = 0; r < philoxRounds; r++) {
+            __m512i hi0, lo0, hi1, lo1;
+            philoxMultiplyAVX512(c[0], m0, hi0, lo0);
+            philoxMultiplyAVX512(c[2], m1, hi1, lo1);
+            c[0] = _mm512_xor_si512(_mm512_xor_si512(hi1, c[1]),
+                                    _mm512_set1_epi32(static_cast<int>(key0)));
+            c[1] = lo1;
+            c[2] = _mm512_xor_si512(_mm512_xor_si512(hi0, c[3]),
+                                    _mm512_set1_epi32(static_cast<int>(key1)));
+            c[3] = lo0;
+            key0 += philoxW0;
+            key1 += philoxW1;
+        }
+}
+
+/**
+ * @brief Map 8 32-bit lanes of hi and lo to doubles in [0, 1), see philoxToUniform().
+ */
+__attribute__((target("avx512f"))) inline __m512d
+philoxToUniformAVX512(const __m256i &hi, const __m256i &lo) {
+    const __m512i bits = _mm512_or_si512(
+        _mm512_set1_epi64(0x3FF0000000000000ll),
+        _mm512_srli_epi64(_mm512_or_si512(_mm512_slli_epi64(_mm512_cvtepu32_epi64(hi), 32),
+                                          _mm512_cvtepu32_epi64(lo)),
+                          12));
+    return _mm512_sub_pd(_mm512_castsi512_pd(bits), _mm512_set1_pd(1.0));
+}
+
+/**
+ * @brief AVX-512 version of philoxFillScalar(), generating the numbers of 16 particles at once.
+ */
+__attribute__((target("avx512f"))) inline void
+philoxFillAVX512(const std::uint32_t &key0,
+                 const std::uint32_t &key1,
+                 const std::uint32_t &iteration,
+                 const std::uint32_t &dimension,
+                 const std::uint32_t &stream,
+                 const std::uint32_t &begin,
+                 const unsigned int  &n,
+                 double *__restrict a,
+                 double *__restrict b) {
+    unsigned int j = 0;
+        for (; j + 16 <= n; j += 16) {
+            __m512i c[4];
+            philox4x32AVX512(c, begin + j, dimension, iteration, stream, key0, key1);
+            _mm512_storeu_pd(a + j,
+                             philoxToUniformAVX512(_mm512_castsi512_si256(c[0]),
+                                                   _mm512_castsi512_si256(c[1])));
+            _mm512_storeu_pd(a + j + 8,
+                             philoxToUniformAVX512(_mm512_extracti64x4_epi64(c[0], 1),
+                                                   _mm512_extracti64x4_epi64(c[1], 1)));
+            _mm512_storeu_pd(b + j,
+                             philoxToUniformAVX512(_mm512_castsi512_si256(c[2]),
+                                                   _mm512_castsi512_si256(c[3])));
+            _mm512_storeu_pd(b + j + 8,
+                             philoxToUniformAVX512(_mm512_extracti64x4_epi64(c[2], 1),
+                                                   _mm512_extracti64x4_epi64(c[3], 1)));
+        }
+    philoxFillScalar(key0, key1, iteration, dimension, stream, begin + j, n - j, a + j, b + j);
+}
+
+/**
+ * @brief AVX-512 version of philoxBitsScalar(), generating the words of 16 particles at once.
+ */
+__attribute__((target("avx512f"))) inline void
+philoxBitsAVX512(const std::uint32_t &key0,
+                 const std::uint32_t &key1,
+                 const std::uint32_t &iteration,
+                 const std::uint32_t &dimension,
+                 const std::uint32_t &stream,
+                 const std::uint32_t &begin,
+                 const unsigned int  &n,
+                 std::uint32_t *__restrict a,
+                 std::uint32_t *__restrict b) {
+    unsigned int j = 0;
+        for (; j + 16 <= n; j += 16) {
+            __m512i c[4];
+            philox4x32AVX512(c, begin + j, dimension, iteration, stream, key0, key1);
+            _mm512_storeu_si512(a + j, c[0]);
+            _mm512_storeu_si512(b + j, c[2]);
+        }
+    philoxBitsScalar(key0, key1, iteration, dimension, stream, begin + j, n - j, a + j, b + j);
+}
+#    pragma GCC diagnostic pop
+#endif
+
+/**
+ * @brief Conversion of random words to values of type T uniformly distributed in [0, 1).
+ * @details The generic version converts the double given by philoxToUniform(). Fixed-point types
+ * specialize it to build their raw value directly from the random bits, so that generating them
+ * needs no floating-point operation.
+ */
+template <typename T>
+struct UniformFromBits {
+    /**
+     * @brief Number of random bits used: when it is at most 32, only hi is used.
+     */
+    static constexpr unsigned int bits = 52;
+
+    /**
+     * @brief Convert the random words hi and lo, hi being the most significant.
+     */
+    static T
+    convert(const std::uint32_t &hi, const std::uint32_t &lo) {
+        return static_cast<T>(philoxToUniform(hi, lo));
+    }
+};
+
+/**
+ * @brief Counter-based random number generator, keyed by a seed.
+ * @details Every random number is identified by (seed, iteration, particle, dimension, stream)
+ * and computed on demand with Philox4x32-10, instead of being the next output of a sequential
+ * generator. Random numbers can therefore be generated in bulk, in any order and on any thread,
+ * and the results do not depend on how the particles are partitioned or vectorized.
+ */
+class Philox {
+  public:
+    /**
+     * @brief Independent sequences drawn from by the algorithm.
+     */
+    enum Stream : std::uint32_t {
+        /**
+         * @brief Initial positions (first number) and velocities (second number).
+         */
+        initializationStream = 0,
+        /**
+         * @brief Cognitive (first number) and social (second number) random factors.
+         */
+        updateStream = 1,
+        /**
+         * @brief Informants of the random neighborhood topology, see Neighborhoods.
+         */
+        topologyStream = 2,
+        /**
+         * @brief Coordinates drawn again by BoundaryPolicy::Reinitialize (first number).
+         */
+        boundaryStream = 3
+    };
+
+    /**
+     * @brief Signature shared by the batch fill kernels, see philoxFillScalar().
+     */
+    using FillFunction = void (*)(const std::uint32_t &,
+                                  const std::uint32_t &,
+                                  const std::uint32_t &,
+                                  const std::uint32_t &,
+                                  const std::uint32_t &,
+                                  const std::uint32_t &,
+                                  const unsigned int &,
+                                  double *,
+                                  double *);
+
+    /**
+     * @brief Signature shared by the batch kernels of random words, see philoxBitsScalar().
+     */
+    using BitsFunction = void (*)(const std::uint32_t &,
+                                  const std::uint32_t &,
+                                  const std::uint32_t &,
+                                  const std::uint32_t &,
+                                  const std::uint32_t &,
+                                  const std::uint32_t &,
+                                  const unsigned int &,
+                                  std::uint32_t *,
+                                  std::uint32_t *);
+
+    /**
+     * @brief Construct a generator keyed by seed_, using the widest instruction set available.
+     */
+    explicit Philox(const std::uint64_t &seed_ = 42) :
+        key0(static_cast<std::uint32_t>(seed_)), key1(static_cast<std::uint32_t>(seed_ >> 32)) {
+        setSimdLevel(detectSimdLevel());
+    }
+
+    /**
+     * @brief Select the instruction set used by fill(). The results do not depend on it.
+     */
+    void
+    setSimdLevel(const SimdLevel &level) {
+        fillKernel = &philoxFillScalar;
+        bitsKernel = &philoxBitsScalar;
+#ifdef PSO_X86_KERNELS
+            if (level == SimdLevel::AVX512) {
+                fillKernel = &philoxFillAVX512;
+                bitsKernel = &philoxBitsAVX512;
+            } else if (level == SimdLevel::AVX2) {
+                fillKernel = &philoxFillAVX2;
+                bitsKernel = &philoxBitsAVX2;
+        }
+#endif
+    }
+
+    /**
+     * @brief Get the pair of random numbers in [0, 1) of a particle, see fill().
+     */
+    template <typename T>
+    void
+    uniform(const std::uint32_t &iteration,
+            const std::uint32_t &particle,
+            const std::uint32_t &dimension,
+            const Stream        &stream,
+            T                   &a,
+            T                   &b) const {
+        std::uint32_t counter[4] = {particle, dimension, iteration, stream};
+        philox4x32(counter, key0, key1);
+        a = UniformFromBits<T>::convert(counter[0], counter[1]);
+        b = UniformFromBits<T>::convert(counter[2], counter[3]);
+    }
+
+    /**
+     * @brief Get a random 32-bit word of a particle: the one uniform() converts to the high bits
+     * of its first number.
+     */
+    std::uint32_t
+    word(const std::uint32_t &iteration,
+         const std::uint32_t &particle,
+         const std::uint32_t &dimension,
+         const Stream        &stream) const {
+        std::uint32_t counter[4] = {particle, dimension, iteration, stream};
+        philox4x32(counter, key0, key1);
+        return counter[0];
+    }
+
+    /**
+     * @brief Fill a and b with the pairs of random numbers in [0, 1) of n consecutive particles.
+     * @details Doubles are generated by the vectorized kernel selected by setSimdLevel(). Types
+     * that need at most 32 random bits, such as the fixed-point types, are converted from the
+     * random words generated in chunks by the vectorized kernel of words, with integer operations
+     * only. Any other type is converted one particle at a time. Whatever the path, the result for
+     * a given counter is the same as uniform().
+     *
+     * @param iteration Iteration the numbers are drawn for.
+     * @param dimension Dimension the numbers are drawn for.
+     * @param stream Sequence the numbers are drawn from.
+     * @param begin Index of the first particle.
+     * @param n Number of particles.
+     * @param a Receives the first number of every particle.
+     * @param b Receives the second number of every particle.
+     */
+    template <typename T>
+    void
+    fill(const std::uint32_t &iteration,
+         const std::uint32_t &dimension,
+         const Stream        &stream,
+         const std::uint32_t &begin,
+         const unsigned int  &n,
+         T                   *a,
+         T                   *b) const {
+            if constexpr (std::is_same_v<T, double>) {
+                fillKernel(key0, key1, iteration, dimension, stream, begin, n, a, b);
+            } else if constexpr (UniformFromBits<T>::bits <= 32) {
+                std::uint32_t x[bitsChunk], y[bitsChunk];
+                    for (unsigned int j = 0; j < n; j += bitsChunk) {
+                        const unsigned int m = std::min(bitsChunk, n - j);
+                        bitsKernel(key0, key1, iteration, dimension, stream, begin + j, m, x, y);
+                            for (unsigned int k = 0; k < m; k++) {
+                                a[j + k] = UniformFromBits<T>::convert(x[k], 0);
+                                b[j + k] = UniformFromBits<T>::convert(y[k], 0);
+                            }
+                    }
+            } else {
+                    for (unsigned int j = 0; j < n; j++) {
+                        uniform(iteration, begin + j, dimension, stream, a[j], b[j]);
+                    }
+            }
+    }
+
+    /**
+     * @brief Get the seed the generator is keyed by. Together with the counter of a number, it is
+     * the whole state of the generator.
+     */
+    std::uint64_t
+    getSeed() const {
+        return (static_cast<std::uint64_t>(key1) << 32) | key0;
+    }
+
+  private:
+    /**
+     * @brief Number of particles whose random words are generated at once by fill().
+     */
+    static constexpr unsigned int bitsChunk = 64;
+    /**
+     * @brief Low half of the key, i.e. of the seed.
+     */
+    std::uint32_t key0;
+    /**
+     * @brief High half of the key, i.e. of the seed.
+     */
+    std::uint32_t key1;
+    /**
+     * @brief Batch fill kernel used for doubles.
+     */
+    FillFunction fillKernel;
+    /**
+     * @brief Batch kernel of random words used for the other types.
+     */
+    BitsFunction bitsKernel;
+};
+
+#endif
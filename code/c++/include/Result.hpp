@@ -0,0 +1,182 @@
+#ifndef RESULT_HPP
+#define RESULT_HPP
+
+#include "EvaluationCache.hpp"
+#include "Instrumentation.hpp"
+#include "Overflow.hpp"
+#include "StoppingCriteria.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Improvement of the global best score during a run.
+ */
+template <typename Scalar>
+struct Improvement {
+    /**
+     * @brief Iteration during which the score was found; in the asynchronous mode, iteration of
+     * the block that found it.
+     */
+    unsigned int iteration;
+    /**
+     * @brief Time since the beginning of the run, excluding the progress callbacks and the
+     * recording of the trajectory.
+     */
+    std::chrono::nanoseconds time;
+    /**
+     * @brief New best score.
+     */
+    Scalar score;
+};
+
+/**
+ * @brief State of a run, handed to the progress callback (see PSO::setProgressCallback()).
+ */
+template <typename Scalar, typename Point>
+struct RunProgress {
+    /**
+     * @brief Iteration about to be performed.
+     */
+    unsigned int iteration;
+    /**
+     * @brief Number of evaluations of the function to minimize so far.
+     */
+    std::uint64_t evaluations;
+    /**
+     * @brief Best score found so far.
+     */
+    Scalar bestScore;
+    /**
+     * @brief Best position found so far; only valid during the callback.
+     */
+    const Point &bestPosition;
+
+    /**
+     * @brief Print the iteration, the best score and the best position on a line.
+     * @details The coordinates are streamed one by one, with 6 decimals, so that printing does
+     * not allocate.
+     */
+    void
+    print(std::ostream &out) const {
+        const std::ios_base::fmtflags flags     = out.flags();
+        const std::streamsize         precision = out.precision();
+        out << "Iteration: " << iteration << ", Best score: " << bestScore
+            << ", Best position: " << std::fixed << std::setprecision(6);
+            for (const Scalar &x : bestPosition) {
+                out << static_cast<double>(x) << " ";
+            }
+        out.flags(flags);
+        out.precision(precision);
+        out << std::endl;
+    }
+};
+
+/**
+ * @brief Outcome of a run, returned by PSO::run().
+ */
+template <typename Scalar, typename Point>
+struct RunResult {
+    /**
+     * @brief Best score found.
+     */
+    Scalar bestScore;
+    /**
+     * @brief Best position found.
+     */
+    Point bestPosition;
+    /**
+     * @brief Iteration during which the best score was found; in the asynchronous mode, iteration
+     * of the block that found it.
+     */
+    unsigned int bestIteration = 0;
+    /**
+     * @brief Number of iterations performed, see PSO::getIterations().
+     */
+    unsigned int iterations = 0;
+    /**
+     * @brief Number of evaluations of the function to minimize since the initialization,
+     * initial evaluation included.
+     */
+    std::uint64_t evaluations = 0;
+    /**
+     * @brief Why the run stopped.
+     */
+    StopReason stopReason = StopReason::MaxIterations;
+    /**
+     * @brief Duration of the run, excluding the progress callbacks and the recording of the
+     * trajectory.
+     */
+    std::chrono::nanoseconds totalTime{0};
+    /**
+     * @brief Time from the beginning of the run until the best score was found, excluding the
+     * progress callbacks and the recording of the trajectory.
+     */
+    std::chrono::nanoseconds timeUntilBest{0};
+    /**
+     * @brief Number of arithmetic operations that overflowed, see PSO::getOverflows().
+     */
+    std::uint64_t overflows = 0;
+    /**
+     * @brief Time spent in each phase and improvements of the bests, see PSO::getInstrumentation().
+     */
+    Instrumentation instrumentation;
+    /**
+     * @brief Lookups of the evaluation cache during the run, see PSO::setEvaluationCache().
+     */
+    EvaluationCacheStatistics cache;
+    /**
+     * @brief Every improvement of the global best score, in the order they happened; in the
+     * asynchronous mode, only the last one of every thread in each iteration of its blocks.
+     */
+    std::vector<Improvement<Scalar>> history;
+
+    /**
+     * @brief Print the timings, the number of iterations and why the run stopped, the number of
+     * overflows if Scalar counts them, the time per phase if the instrumentation is enabled, and
+     * the lookups of the evaluation cache if there is one.
+     */
+    void
+    print(std::ostream &out) const {
+        using std::chrono::duration_cast;
+        using std::chrono::milliseconds;
+        out << "Total time: " << duration_cast<milliseconds>(totalTime).count() << " ms"
+            << std::endl;
+        out << "Time until best: " << duration_cast<milliseconds>(timeUntilBest).count() << " ms"
+            << std::endl;
+        out << "Best iteration: " << bestIteration << std::endl;
+        out << "Iterations: " << iterations << " (" << stopReasonName(stopReason) << ")"
+            << std::endl;
+            if constexpr (OverflowTraits<Scalar>::counted) {
+                out << "Overflows: " << overflows << " ("
+                    << overflowPolicyName(OverflowTraits<Scalar>::policy) << ")" << std::endl;
+        }
+            if constexpr (instrumentationEnabled) {
+                const double total = static_cast<double>(instrumentation.getTotalTime());
+                out << "Time per phase (summed over the threads):" << std::endl;
+                    for (const Phase &phase : phases) {
+                        const double time =
+                            static_cast<double>(instrumentation.getPhaseTime(phase));
+                        out << "  " << phaseName(phase) << ": " << time / 1e6 << " ms, "
+                            << (iterations > 0 ? time / 1e3 / iterations : 0)
+                            << " us per iteration (" << (total > 0 ? 100 * time / total : 0)
+                            << "%)" << std::endl;
+                    }
+                out << "Personal best improvements: " << instrumentation.personalBestImprovements
+                    << std::endl;
+                out << "Global best improvements: " << instrumentation.globalBestImprovements
+                    << std::endl;
+        }
+            if (cache.hits + cache.misses > 0) {
+                out << "Evaluation cache: " << cache.hits << " hits, " << cache.misses
+                    << " misses (" << 100 * cache.getHitRate() << "%), " << cache.evictions
+                    << " evictions" << std::endl;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,192 @@
+#ifndef SHARED_BEST_HPP
+#define SHARED_BEST_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief Best score and position of the swarm, shared by concurrent workers without a lock.
+ * @details Every worker owns two records, which it fills in turn: a record is written while it is
+ * not published, and never changes while it is. A worker publishes an improvement by writing its
+ * spare record, and then swapping the index of the published record for the index of its own
+ * with a compare-and-swap, which fails if another worker published in the meantime; it then
+ * compares its score with the new record again, and gives up once it is no better. Readers copy
+ * the published record, and retry if another one was published while they copied it, since its
+ * owner may then be rewriting it. Nobody ever waits for another worker: a publication or a copy
+ * is only tried again because another publication succeeded. The index is paired with the number
+ * of publications, so that a record published again by its owner is not taken for the one it
+ * replaced.
+ * @tparam Scalar Type of the score and of the coordinates.
+ */
+template <typename Scalar>
+class SharedBest {
+  public:
+    /**
+     * @brief Construct the records of numWorkers_ workers for the given number of dimensions, and
+     * publish score_ and the dimensions_ coordinates of position_, found at iteration iteration_.
+     */
+    SharedBest(const unsigned int &dimensions_,
+               const unsigned int &numWorkers_,
+               const Scalar       &score_,
+               const Scalar       *position_,
+               const unsigned int &iteration_ = 0) :
+        dimensions(dimensions_),
+        stride((dimensions_ + lineValues - 1) / lineValues * lineValues),
+        records(std::make_unique<Record[]>(2 * numWorkers_ + 1)),
+        positions(std::make_unique<std::atomic<Scalar>[]>((2 * numWorkers_ + 1) * stride)),
+        spares(std::make_unique<unsigned int[]>(numWorkers_)) {
+            for (unsigned int w = 0; w < numWorkers_; w++) {
+                spares[w] = 2 * w;
+            }
+        // The initial record belongs to no worker, so it is never written again.
+        write(2 * numWorkers_, score_, position_, iteration_);
+        published.store(2 * numWorkers_, std::memory_order_release);
+    }
+
+    /**
+     * @brief Publish score_ and position_ as the record of worker, if score_ is lower than the
+     * score of the published record.
+     *
+     * @param worker Index of the calling worker, lower than the number of workers. A worker must
+     * not publish from several threads at once.
+     * @param score_ Candidate score.
+     * @param position_ Candidate position, with one coordinate per dimension.
+     * @param iteration_ Iteration at which the candidate was found.
+     * @return true if the record was published.
+     */
+    bool
+    publish(const unsigned int &worker,
+            const Scalar       &score_,
+            const Scalar       *position_,
+            const unsigned int &iteration_) {
+        std::uint64_t current = published.load(std::memory_order_acquire);
+            if (!(score_ < records[index(current)].score.load(std::memory_order_relaxed))) {
+                return false;
+        }
+        const unsigned int spare = spares[worker];
+        write(spare, score_, position_, iteration_);
+        // The count of publications tells a record published again from the one it replaced.
+            while (!published.compare_exchange_weak(current,
+                                                    ((current >> 32) + 1) << 32 | spare,
+                                                    std::memory_order_acq_rel,
+                                                    std::memory_order_acquire)) {
+                    if (!(score_ < records[index(current)].score.load(std::memory_order_relaxed))) {
+                        return false;
+                }
+            }
+        spares[worker] = spare ^ 1;
+        return true;
+    }
+
+    /**
+     * @brief Copy the published record.
+     *
+     * @param position_ Output array, receives one coordinate per dimension.
+     * @return Scalar Score of the copied position.
+     */
+    Scalar
+    load(Scalar *position_) const {
+            while (true) {
+                const std::uint64_t current = published.load(std::memory_order_acquire);
+                const Scalar        score_ =
+                    records[index(current)].score.load(std::memory_order_relaxed);
+                const std::atomic<Scalar> *position = positions.get() + index(current) * stride;
+                    for (unsigned int d = 0; d < dimensions; d++) {
+                        position_[d] = position[d].load(std::memory_order_relaxed);
+                    }
+                // The record cannot have been rewritten while it stayed published.
+                std::atomic_thread_fence(std::memory_order_acquire);
+                    if (published.load(std::memory_order_relaxed) == current) {
+                        return score_;
+                }
+            }
+    }
+
+    /**
+     * @brief Get the iteration at which the published record was found.
+     */
+    unsigned int
+    getIteration() const {
+        return records[index(published.load(std::memory_order_acquire))].iteration.load(
+            std::memory_order_relaxed);
+    }
+
+  private:
+    /**
+     * @brief Score and iteration of a record, on a cache line of their own.
+     */
+    struct alignas(64) Record {
+        /**
+         * @brief Best score.
+         */
+        std::atomic<Scalar> score;
+        /**
+         * @brief Iteration at which the best score was found.
+         */
+        std::atomic<unsigned int> iteration{0};
+    };
+
+    /**
+     * @brief Number of coordinates in a cache line, by which the positions are padded.
+     */
+    static constexpr unsigned int lineValues =
+        64 / sizeof(std::atomic<Scalar>) > 0 ? 64 / sizeof(std::atomic<Scalar>) : 1;
+
+    /**
+     * @brief Get the index of the record of a value of published.
+     */
+    static unsigned int
+    index(const std::uint64_t &current) {
+        return static_cast<unsigned int>(current & 0xffffffff);
+    }
+
+    /**
+     * @brief Fill the record of index i, which must not be published.
+     */
+    void
+    write(const unsigned int &i,
+          const Scalar       &score_,
+          const Scalar       *position_,
+          const unsigned int &iteration_) {
+        // A reader still copying the record, from when it was published, sees it change only after
+        // the publication of another one, so that it tries again.
+        std::atomic_thread_fence(std::memory_order_release);
+        records[i].score.store(score_, std::memory_order_relaxed);
+        records[i].iteration.store(iteration_, std::memory_order_relaxed);
+        std::atomic<Scalar> *position = positions.get() + static_cast<std::size_t>(i) * stride;
+            for (unsigned int d = 0; d < dimensions; d++) {
+                position[d].store(position_[d], std::memory_order_relaxed);
+            }
+    }
+
+    /**
+     * @brief Number of dimensions.
+     */
+    const unsigned int dimensions;
+    /**
+     * @brief Distance between the positions of two records, a whole number of cache lines.
+     */
+    const std::size_t stride;
+    /**
+     * @brief Scores and iterations of the records: two per worker, the 2w-th and the 2w + 1-th
+     * for the w-th worker, and the initial one last.
+     */
+    std::unique_ptr<Record[]> records;
+    /**
+     * @brief Positions of the records, stride coordinates apart.
+     */
+    std::unique_ptr<std::atomic<Scalar>[]> positions;
+    /**
+     * @brief Index of the record each worker writes next, the one it did not publish last.
+     */
+    std::unique_ptr<unsigned int[]> spares;
+    /**
+     * @brief Number of publications, in the 32 most significant bits, and index of the published
+     * record, in the 32 least significant ones.
+     */
+    std::atomic<std::uint64_t> published{0};
+};
+
+#endif
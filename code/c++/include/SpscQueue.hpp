@@ -0,0 +1,85 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/**
+ * @brief Bounded lock-free queue between one producer thread and one consumer thread.
+ * @details The items live in a circular buffer allocated once, whose capacity is a power of two.
+ * The producer only writes the tail and the consumer only writes the head, each on its own cache
+ * line, so that they never contend for a lock nor for a line they both write: an item is handed
+ * over by a release store of the index that publishes it and an acquire load on the other side.
+ * Items are copied into slots constructed up front, so types that own memory, such as vectors,
+ * reuse it from one item to the next.
+ */
+template <typename T>
+class SpscQueue {
+  public:
+    /**
+     * @brief Construct an empty queue that can hold at least capacity_ items (at least one).
+     */
+    explicit SpscQueue(const std::size_t &capacity_) {
+            while (capacity < capacity_) {
+                capacity *= 2;
+            }
+        items = std::make_unique<T[]>(capacity);
+    }
+
+    SpscQueue(const SpscQueue &) = delete;
+
+    SpscQueue &
+    operator=(const SpscQueue &) = delete;
+
+    /**
+     * @brief Append a copy of item at the end of the queue. Must only be called by the producer.
+     * @return false if the queue is full.
+     */
+    bool
+    push(const T &item) {
+        const std::size_t tail_ = tail.load(std::memory_order_relaxed);
+            if (tail_ - head.load(std::memory_order_acquire) == capacity) {
+                return false;
+        }
+        items[tail_ & (capacity - 1)] = item;
+        tail.store(tail_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Copy the item at the front of the queue into item, and remove it. Must only be called
+     * by the consumer.
+     * @return false if the queue is empty.
+     */
+    bool
+    pop(T &item) {
+        const std::size_t head_ = head.load(std::memory_order_relaxed);
+            if (head_ == tail.load(std::memory_order_acquire)) {
+                return false;
+        }
+        item = items[head_ & (capacity - 1)];
+        head.store(head_ + 1, std::memory_order_release);
+        return true;
+    }
+
+  private:
+    /**
+     * @brief Number of slots, a power of two.
+     */
+    std::size_t capacity = 1;
+    /**
+     * @brief Circular buffer of the items.
+     */
+    std::unique_ptr<T[]> items;
+    /**
+     * @brief Number of items popped so far, written by the consumer.
+     */
+    alignas(64) std::atomic<std::size_t> head{0};
+    /**
+     * @brief Number of items pushed so far, written by the producer.
+     */
+    alignas(64) std::atomic<std::size_t> tail{0};
+};
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef STOPPING_CRITERIA_HPP
+#define STOPPING_CRITERIA_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+/**
+ * @brief Why a run of the optimizer stopped.
+ */
+enum class StopReason {
+    /**
+     * @brief Every iteration of the budget was performed.
+     */
+    MaxIterations,
+    /**
+     * @brief The best score reached the target score.
+     */
+    TargetScore,
+    /**
+     * @brief The best score did not improve for the given number of iterations.
+     */
+    Stagnation,
+    /**
+     * @brief The swarm shrank below the given diameter.
+     */
+    SwarmDiameter,
+    /**
+     * @brief The run took the given wall-clock time.
+     */
+    TimeLimit,
+    /**
+     * @brief Another iteration would have evaluated the function more times than the budget.
+     */
+    EvaluationBudget
+};
+
+/**
+ * @brief Get a printable description of the given reason.
+ */
+inline const char *
+stopReasonName(const StopReason &reason) {
+        switch (reason) {
+            case StopReason::TargetScore:
+                return "target score reached";
+            case StopReason::Stagnation:
+                return "no improvement";
+            case StopReason::SwarmDiameter:
+                return "swarm diameter below the minimum";
+            case StopReason::TimeLimit:
+                return "time limit reached";
+            case StopReason::EvaluationBudget:
+                return "evaluation budget exhausted";
+            default:
+                return "maximum number of iterations reached";
+        }
+}
+
+/**
+ * @brief Conditions that end a run of the optimizer before maxIterations iterations.
+ * @details Every criterion is disabled by default; the enabled ones are combined, i.e. the run
+ * stops as soon as any of them holds, and PSO::getStopReason() tells which one did. They are
+ * checked at the end of every iteration in the synchronous mode, and at the end of every block in
+ * the asynchronous one.
+ * @tparam Scalar Arithmetic type of the optimizer.
+ */
+template <typename Scalar>
+struct StoppingCriteria {
+    /**
+     * @brief Stop once the best score is lower than or equal to this.
+     */
+    std::optional<Scalar> targetScore;
+    /**
+     * @brief Stop once the best score has not improved for this many iterations; 0 disables it.
+     * @details In the asynchronous mode, the iterations are counted by each block, from the
+     * iteration of the block that found the best score.
+     */
+    unsigned int stagnationIterations = 0;
+    /**
+     * @brief Stop once the swarm fits in a box whose sides are all shorter than this, i.e. once
+     * the largest extent of the positions along a dimension is below it.
+     * @note Only checked in the synchronous mode: the blocks of the asynchronous mode are at
+     * different iterations, so the swarm has no consistent shape.
+     */
+    std::optional<Scalar> minDiameter;
+    /**
+     * @brief Stop once run() has taken this wall-clock time; 0 disables it.
+     */
+    std::chrono::milliseconds timeLimit{0};
+    /**
+     * @brief Stop before evaluating the function more than this many times since
+     * initializeParticles(), initial evaluation included; 0 disables it.
+     */
+    std::uint64_t maxEvaluations = 0;
+};
+
+#endif
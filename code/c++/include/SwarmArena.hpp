@@ -0,0 +1,238 @@
+#ifndef SWARM_ARENA_HPP
+#define SWARM_ARENA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+/**
+ * @brief Single aligned buffer that the memory of a swarm is carved from.
+ * @details The arena is allocated once, with the total size of the buffers it will hand out, and
+ * carve() then only moves a pointer forward: the buffers are never freed one by one, and are all
+ * released with the arena. A swarm thus costs one heap allocation however many buffers it uses,
+ * and optimizers running concurrently in one process do not contend for the allocator once they
+ * are constructed. Only trivially destructible types can be stored, since the arena runs no
+ * destructor.
+ */
+class SwarmArena {
+  public:
+    /**
+     * @brief Alignment in bytes of the buffer and of every block carved from it.
+     */
+    static constexpr std::size_t alignment = 64;
+
+    /**
+     * @brief Construct an empty arena, from which nothing can be carved.
+     */
+    SwarmArena() = default;
+
+    /**
+     * @brief Allocate an arena of capacity_ bytes, see footprint().
+     */
+    explicit SwarmArena(const std::size_t &capacity_) :
+        capacity(capacity_), data(allocate(capacity_)) {}
+
+    SwarmArena(const SwarmArena &) = delete;
+
+    SwarmArena &
+    operator=(const SwarmArena &) = delete;
+
+    SwarmArena(SwarmArena &&other) noexcept = default;
+
+    SwarmArena &
+    operator=(SwarmArena &&other) noexcept = default;
+
+    /**
+     * @brief Get the number of bytes taken in an arena by count values of type T: the blocks are
+     * rounded up to the alignment, so that the sum of the footprints of the blocks is the capacity
+     * they need.
+     */
+    template <typename T>
+    static constexpr std::size_t
+    footprint(const std::size_t &count) {
+        return (count * sizeof(T) + alignment - 1) / alignment * alignment;
+    }
+
+    /**
+     * @brief Carve an aligned block of count default-initialized values of type T, which lives
+     * as long as the arena.
+     * @throws std::bad_alloc If the arena has less than footprint<T>(count) bytes left.
+     */
+    template <typename T>
+    T *
+    carve(const std::size_t &count) {
+        static_assert(std::is_trivially_destructible_v<T>,
+                      "the arena does not destroy the values it holds");
+        static_assert(alignof(T) <= alignment, "the arena cannot align the values");
+        const std::size_t size = footprint<T>(count);
+            if (size > capacity - used) {
+                throw std::bad_alloc();
+        }
+        T *block = reinterpret_cast<T *>(data.get() + used);
+        used += size;
+        std::uninitialized_default_construct_n(block, count);
+        return block;
+    }
+
+    /**
+     * @brief Get the size of the arena in bytes.
+     */
+    std::size_t
+    getCapacity() const {
+        return capacity;
+    }
+
+    /**
+     * @brief Get the number of bytes carved so far.
+     */
+    std::size_t
+    getUsed() const {
+        return used;
+    }
+
+  private:
+    /**
+     * @brief Deleter matching the aligned operator new of the constructor.
+     */
+    struct AlignedDeleter {
+        void
+        operator()(std::byte *ptr) const {
+            ::operator delete(ptr, std::align_val_t{alignment});
+        }
+    };
+
+    /**
+     * @brief Allocate an aligned buffer of the given number of bytes.
+     */
+    static std::unique_ptr<std::byte[], AlignedDeleter>
+    allocate(const std::size_t &size) {
+            if (size == 0) {
+                return nullptr;
+        }
+        return std::unique_ptr<std::byte[], AlignedDeleter>(
+            static_cast<std::byte *>(::operator new(size, std::align_val_t{alignment})));
+    }
+
+    /**
+     * @brief Size of the buffer in bytes.
+     */
+    std::size_t capacity = 0;
+    /**
+     * @brief Number of bytes carved so far, from the beginning of the buffer.
+     */
+    std::size_t used = 0;
+    /**
+     * @brief The aligned buffer.
+     */
+    std::unique_ptr<std::byte[], AlignedDeleter> data;
+};
+
+/**
+ * @brief Fixed-size array of values carved from a SwarmArena, which owns their memory.
+ * @details It offers the subset of the interface of std::vector used on the per-particle buffers
+ * of a swarm, without ever allocating: its size is set once, when it is carved.
+ */
+template <typename T>
+class ArenaArray {
+  public:
+    /**
+     * @brief Construct an empty array.
+     */
+    ArenaArray() = default;
+
+    /**
+     * @brief Carve an array of size_ default-initialized values from arena.
+     */
+    ArenaArray(SwarmArena &arena, const std::size_t &size_) :
+        values(arena.carve<T>(size_)), size(size_) {}
+
+    /**
+     * @brief Get the footprint in a SwarmArena of an array of size_ values.
+     */
+    static constexpr std::size_t
+    footprint(const std::size_t &size_) {
+        return SwarmArena::footprint<T>(size_);
+    }
+
+    /**
+     * @brief Get the i-th value.
+     */
+    T &
+    operator[](const std::size_t &i) {
+        return values[i];
+    }
+
+    const T &
+    operator[](const std::size_t &i) const {
+        return values[i];
+    }
+
+    /**
+     * @brief Get a pointer to the first value, aligned to SwarmArena::alignment bytes.
+     */
+    T *
+    data() {
+        return values;
+    }
+
+    const T *
+    data() const {
+        return values;
+    }
+
+    /**
+     * @brief Get an iterator to the first value.
+     */
+    T *
+    begin() {
+        return values;
+    }
+
+    const T *
+    begin() const {
+        return values;
+    }
+
+    /**
+     * @brief Get an iterator past the last value.
+     */
+    T *
+    end() {
+        return values + size;
+    }
+
+    const T *
+    end() const {
+        return values + size;
+    }
+
+    /**
+     * @brief Get the number of values.
+     */
+    std::size_t
+    getSize() const {
+        return size;
+    }
+
+    /**
+     * @brief Set every value to value.
+     */
+    void
+    fill(const T &value) {
+        std::fill_n(values, size, value);
+    }
+
+  private:
+    /**
+     * @brief First value, in the arena.
+     */
+    T *values = nullptr;
+    /**
+     * @brief Number of values.
+     */
+    std::size_t size = 0;
+};
+
+#endif
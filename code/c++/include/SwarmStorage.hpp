@@ -0,0 +1,357 @@
+#ifndef SWARM_STORAGE_HPP
+#define SWARM_STORAGE_HPP
+
+#include "SwarmArena.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Value of the Dims template parameter meaning that the number of dimensions is only known
+ * at run time.
+ */
+constexpr unsigned int dynamicDimensions = 0;
+
+/**
+ * @brief Position of a single particle: a std::array when the number of dimensions is known at
+ * compile time, a std::vector otherwise.
+ */
+template <typename T, unsigned int Dims = dynamicDimensions>
+using SwarmPoint =
+    std::conditional_t<Dims == dynamicDimensions, std::vector<T>, std::array<T, Dims>>;
+
+/**
+ * @brief Read-only view of a contiguous range of particles of a SwarmStorage.
+ * @details The view does not own its data: it stays valid as long as the storage it was taken
+ * from is neither destroyed nor reassigned. Particle j of the view is particle begin + j of the
+ * storage.
+ * @tparam T Type of the stored values.
+ * @tparam Dims Number of dimensions, or dynamicDimensions if only known at run time.
+ */
+template <typename T, unsigned int Dims = dynamicDimensions>
+class SwarmView {
+  public:
+    /**
+     * @brief Construct a view over numParticles_ particles whose rows start at data_ and are
+     * stride_ elements apart.
+     */
+    SwarmView(const T            *data_,
+              const std::size_t  &stride_,
+              const unsigned int &numParticles_,
+              const unsigned int &dimensions_) :
+        data(data_),
+        stride(stride_), numParticles(numParticles_), dimensions(dimensions_) {}
+
+    /**
+     * @brief Get the d-th coordinate of the j-th particle of the view.
+     */
+    const T &
+    operator()(const unsigned int &d, const unsigned int &j) const {
+        return data[d * stride + j];
+    }
+
+    /**
+     * @brief Get the d-th coordinate of every particle of the view, as getNumParticles()
+     * consecutive values.
+     */
+    const T *
+    row(const unsigned int &d) const {
+        return data + d * stride;
+    }
+
+    /**
+     * @brief Get the number of particles in the view.
+     */
+    unsigned int
+    getNumParticles() const {
+        return numParticles;
+    }
+
+    /**
+     * @brief Get the number of dimensions.
+     */
+    unsigned int
+    getDimensions() const {
+        return Dims == dynamicDimensions ? dimensions : Dims;
+    }
+
+    /**
+     * @brief Get the distance, in elements, between the beginnings of two consecutive rows.
+     */
+    std::size_t
+    getStride() const {
+        return stride;
+    }
+
+  private:
+    /**
+     * @brief First coordinate of the first particle of the view.
+     */
+    const T *data;
+    /**
+     * @brief Distance, in elements, between the beginnings of two consecutive rows.
+     */
+    std::size_t stride;
+    /**
+     * @brief Number of particles in the view.
+     */
+    unsigned int numParticles;
+    /**
+     * @brief Number of dimensions.
+     */
+    unsigned int dimensions;
+};
+
+/**
+ * @brief Contiguous, aligned storage for one per-particle quantity of the swarm.
+ * @details Values are stored dimension-major (structure of arrays): row d holds the d-th
+ * coordinate of every particle, so that a sweep over the particles for a fixed dimension walks
+ * through consecutive memory. Every row is padded to a multiple of the alignment, so that the
+ * beginning of each row is aligned as well.
+ * @tparam T Type of the stored values.
+ * @tparam Dims Number of dimensions, or dynamicDimensions if only known at run time. When it is
+ * known at compile time, loops bounded by getDimensions() can be fully unrolled.
+ */
+template <typename T, unsigned int Dims = dynamicDimensions>
+class SwarmStorage {
+  public:
+    /**
+     * @brief Alignment in bytes of the buffer and of the beginning of each row.
+     */
+    static constexpr std::size_t alignment = SwarmArena::alignment;
+
+    /**
+     * @brief Construct an empty storage.
+     */
+    SwarmStorage() = default;
+
+    /**
+     * @brief Construct a zero-initialized storage for the given swarm shape.
+     *
+     * @param numParticles_ Number of particles.
+     * @param dimensions_ Number of dimensions of the search space.
+     */
+    SwarmStorage(const unsigned int &numParticles_, const unsigned int &dimensions_) :
+        numParticles(numParticles_), dimensions(dimensions_), stride(paddedStride(numParticles_)),
+        data(allocate(stride * dimensions_)) {
+        std::uninitialized_fill_n(data.get(), stride * dimensions, T{});
+    }
+
+    /**
+     * @brief Construct a storage for the given swarm shape, carved from arena, which owns its
+     * memory and must outlive it. The values are default-initialized, i.e. left unspecified for
+     * arithmetic types, and must be written before they are read.
+     *
+     * @param numParticles_ Number of particles.
+     * @param dimensions_ Number of dimensions of the search space.
+     * @param arena Arena with at least footprint(numParticles_, dimensions_) bytes left.
+     * @throws std::bad_alloc If the arena is too small.
+     */
+    SwarmStorage(const unsigned int &numParticles_,
+                 const unsigned int &dimensions_,
+                 SwarmArena         &arena) :
+        numParticles(numParticles_), dimensions(dimensions_), stride(paddedStride(numParticles_)),
+        data(arena.carve<T>(stride * dimensions_), AlignedDeleter{false}) {}
+
+    /**
+     * @brief Get the number of bytes taken in a SwarmArena by a storage of the given shape.
+     */
+    static std::size_t
+    footprint(const unsigned int &numParticles_, const unsigned int &dimensions_) {
+        return SwarmArena::footprint<T>(paddedStride(numParticles_) * dimensions_);
+    }
+
+    /**
+     * @brief Copy the storage of other into a new buffer, owned by this storage.
+     */
+    SwarmStorage(const SwarmStorage &other) :
+        numParticles(other.numParticles), dimensions(other.dimensions), stride(other.stride),
+        data(allocate(other.stride * other.dimensions)) {
+        std::uninitialized_copy_n(other.data.get(), stride * dimensions, data.get());
+    }
+
+    SwarmStorage(SwarmStorage &&other) noexcept = default;
+
+    SwarmStorage &
+    operator=(const SwarmStorage &other) {
+            if (this != &other) {
+                *this = SwarmStorage(other);
+        }
+        return *this;
+    }
+
+    SwarmStorage &
+    operator=(SwarmStorage &&other) noexcept = default;
+
+    /**
+     * @brief Set every coordinate of every particle to value.
+     */
+    void
+    fill(const T &value) {
+        std::fill_n(data.get(), stride * dimensions, value);
+    }
+
+    /**
+     * @brief Get the d-th coordinate of the j-th particle.
+     */
+    T &
+    operator()(const unsigned int &d, const unsigned int &j) {
+        return data[d * stride + j];
+    }
+
+    const T &
+    operator()(const unsigned int &d, const unsigned int &j) const {
+        return data[d * stride + j];
+    }
+
+    /**
+     * @brief Get the row that holds the d-th coordinate of every particle.
+     * @return T* pointing to the first element of the row, aligned to alignment bytes.
+     */
+    T *
+    row(const unsigned int &d) {
+        return data.get() + d * stride;
+    }
+
+    const T *
+    row(const unsigned int &d) const {
+        return data.get() + d * stride;
+    }
+
+    /**
+     * @brief Get a read-only view of every particle.
+     */
+    SwarmView<T, Dims>
+    view() const {
+        return SwarmView<T, Dims>(data.get(), stride, numParticles, dimensions);
+    }
+
+    /**
+     * @brief Get a read-only view of the count particles starting from the begin-th one.
+     */
+    SwarmView<T, Dims>
+    view(const unsigned int &begin, const unsigned int &count) const {
+        return SwarmView<T, Dims>(data.get() + begin, stride, count, dimensions);
+    }
+
+    /**
+     * @brief Copy the coordinates of the j-th particle into out, which must hold at least
+     * getDimensions() elements.
+     */
+    void
+    gather(const unsigned int &j, T *out) const {
+            for (unsigned int d = 0; d < getDimensions(); d++) {
+                out[d] = data[d * stride + j];
+            }
+    }
+
+    /**
+     * @brief Copy the coordinates of the j-th particle of other, which must have the same shape,
+     * into the j-th particle of this storage.
+     */
+    void
+    copyParticle(const unsigned int &j, const SwarmStorage &other) {
+            for (unsigned int d = 0; d < getDimensions(); d++) {
+                data[d * stride + j] = other.data[d * stride + j];
+            }
+    }
+
+    /**
+     * @brief Copy the coordinates of the k-th particle of other, which must have the same shape,
+     * into the j-th particle of this storage.
+     */
+    void
+    copyParticle(const unsigned int &j, const SwarmStorage &other, const unsigned int &k) {
+            for (unsigned int d = 0; d < getDimensions(); d++) {
+                data[d * stride + j] = other.data[d * stride + k];
+            }
+    }
+
+    /**
+     * @brief Get the number of particles.
+     */
+    unsigned int
+    getNumParticles() const {
+        return numParticles;
+    }
+
+    /**
+     * @brief Get the number of dimensions.
+     */
+    unsigned int
+    getDimensions() const {
+        return Dims == dynamicDimensions ? dimensions : Dims;
+    }
+
+    /**
+     * @brief Get the distance, in elements, between the beginnings of two consecutive rows.
+     */
+    std::size_t
+    getStride() const {
+        return stride;
+    }
+
+  private:
+    /**
+     * @brief Deleter matching the aligned operator new used by allocate(), which does nothing for
+     * a buffer carved from a SwarmArena.
+     */
+    struct AlignedDeleter {
+        /**
+         * @brief Whether the buffer was allocated by allocate(), rather than carved from an arena.
+         */
+        bool owning = true;
+
+        void
+        operator()(T *ptr) const {
+                if (owning) {
+                    ::operator delete[](ptr, std::align_val_t{alignment});
+            }
+        }
+    };
+
+    /**
+     * @brief Round numParticles_ up so that every row starts on an aligned address.
+     */
+    static std::size_t
+    paddedStride(const unsigned int &numParticles_) {
+        const std::size_t perLine = std::max<std::size_t>(1, alignment / sizeof(T));
+        return (numParticles_ + perLine - 1) / perLine * perLine;
+    }
+
+    /**
+     * @brief Allocate an aligned buffer of the given number of elements.
+     */
+    static std::unique_ptr<T[], AlignedDeleter>
+    allocate(const std::size_t &size) {
+            if (size == 0) {
+                return nullptr;
+        }
+        return std::unique_ptr<T[], AlignedDeleter>(
+            static_cast<T *>(::operator new[](size * sizeof(T), std::align_val_t{alignment})));
+    }
+
+    /**
+     * @brief Number of particles.
+     */
+    unsigned int numParticles = 0;
+    /**
+     * @brief Number of dimensions.
+     */
+    unsigned int dimensions = 0;
+    /**
+     * @brief Distance, in elements, between the beginnings of two consecutive rows.
+     */
+    std::size_t stride = 0;
+    /**
+     * @brief The aligned buffer, of size stride * dimensions.
+     */
+    std::unique_ptr<T[], AlignedDeleter> data;
+};
+
+#endif
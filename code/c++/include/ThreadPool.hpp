@@ -0,0 +1,154 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed-size pool of persistent worker threads.
+ * @details The threads are created once by the constructor and are reused by every call to run(),
+ * so that parallel sections inside the iteration loop do not pay for thread creation. The calling
+ * thread takes part in the work as worker 0, so a pool of numThreads workers spawns
+ * numThreads - 1 threads, and a pool of a single worker runs everything inline.
+ */
+class ThreadPool {
+  public:
+    /**
+     * @brief Type of the tasks: each worker calls the task once, with its own index.
+     */
+    using Task = std::function<void(const unsigned int &)>;
+
+    /**
+     * @brief Construct a pool of numThreads_ workers (at least one).
+     *
+     * @param numThreads_ Number of workers, including the calling thread.
+     */
+    explicit ThreadPool(const unsigned int &numThreads_) : numThreads(std::max(1u, numThreads_)) {
+            for (unsigned int t = 1; t < numThreads; t++) {
+                threads.emplace_back([this, t]() { workerLoop(t); });
+            }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+
+    ThreadPool &
+    operator=(const ThreadPool &) = delete;
+
+    /**
+     * @brief Stop and join all the threads.
+     */
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+            for (auto &thread : threads) {
+                thread.join();
+            }
+    }
+
+    /**
+     * @brief Run task on every worker, with the worker index (from 0 to getNumThreads() - 1) as
+     * argument, and wait until all the workers are done.
+     *
+     * @param task_ Task to run. The calling thread runs it as worker 0.
+     */
+    void
+    run(const Task &task_) {
+            if (numThreads == 1) {
+                task_(0);
+                return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            task    = &task_;
+            pending = numThreads - 1;
+            generation++;
+        }
+        wakeUp.notify_all();
+        task_(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]() { return pending == 0; });
+        task = nullptr;
+    }
+
+    /**
+     * @brief Get the number of workers, including the calling thread.
+     */
+    unsigned int
+    getNumThreads() const {
+        return numThreads;
+    }
+
+  private:
+    /**
+     * @brief Body of the t-th thread: wait for a new task, run it, and signal its completion.
+     */
+    void
+    workerLoop(const unsigned int &t) {
+        unsigned long seen = 0;
+            while (true) {
+                const Task *current;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    wakeUp.wait(lock, [this, seen]() { return stopping || generation != seen; });
+                        if (stopping) {
+                            return;
+                    }
+                    seen    = generation;
+                    current = task;
+                }
+                (*current)(t);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                        if (--pending == 0) {
+                            done.notify_one();
+                    }
+                }
+            }
+    }
+
+    /**
+     * @brief Number of workers, including the calling thread.
+     */
+    const unsigned int numThreads;
+    /**
+     * @brief Threads of the workers from 1 to numThreads - 1.
+     */
+    std::vector<std::thread> threads;
+    /**
+     * @brief Protects all the following members.
+     */
+    std::mutex mutex;
+    /**
+     * @brief Signaled when a new task is available or the pool is stopping.
+     */
+    std::condition_variable wakeUp;
+    /**
+     * @brief Signaled when the last thread finishes the current task.
+     */
+    std::condition_variable done;
+    /**
+     * @brief Task being run.
+     */
+    const Task *task = nullptr;
+    /**
+     * @brief Number of threads that have not finished the current task yet.
+     */
+    unsigned int pending = 0;
+    /**
+     * @brief Incremented for every new task, so that threads can tell it from the previous one.
+     */
+    unsigned long generation = 0;
+    /**
+     * @brief Set by the destructor to make the threads exit.
+     */
+    bool stopping = false;
+};
+
+#endif
@@ -0,0 +1,174 @@
+#ifndef TOPOLOGY_HPP
+#define TOPOLOGY_HPP
+
+#include "Philox.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @brief Neighborhood of every particle, whose best position it follows.
+ */
+enum class Topology {
+    /**
+     * @brief Every particle follows the best position of the whole swarm.
+     */
+    Global,
+    /**
+     * @brief The particles form a ring, and every particle follows the best one among itself and
+     * the given number of particles on each side.
+     */
+    Ring,
+    /**
+     * @brief The particles fill, row after row, a grid about as wide as it is high, whose rows and
+     * columns are wrapped around into rings, and every particle follows the best one among itself
+     * and the particles above, below, on its left and on its right. When the number of particles
+     * is not a multiple of the width, the last row, and the columns that stop before it, wrap
+     * around on their own length.
+     */
+    VonNeumann,
+    /**
+     * @brief Every particle follows the best one among itself and the given number of distinct
+     * informants, other than itself, drawn at random when the swarm is initialized; if there are
+     * fewer other particles, it follows all of them.
+     */
+    RandomK
+};
+
+/**
+ * @brief Get a printable name of the given topology.
+ */
+inline const char *
+topologyName(const Topology &topology) {
+        switch (topology) {
+            case Topology::Ring:
+                return "ring";
+            case Topology::VonNeumann:
+                return "von Neumann";
+            case Topology::RandomK:
+                return "random";
+            default:
+                return "global";
+        }
+}
+
+/**
+ * @brief Precomputed neighborhoods of the particles of a swarm.
+ * @details The indices of the neighbors of every particle, itself included, are stored in one
+ * contiguous table with the same number of entries per particle, sorted so that the best scores
+ * of the neighbors are read in increasing order of address.
+ */
+class Neighborhoods {
+  public:
+    Neighborhoods() = default;
+
+    /**
+     * @brief Build the neighborhoods of numParticles particles in the given topology.
+     *
+     * @param topology Topology of the swarm, other than Topology::Global.
+     * @param numParticles Number of particles.
+     * @param informants Number of neighbors on each side in a ring, or number of random
+     * informants; ignored by the other topologies.
+     * @param random Generator the random informants are drawn from.
+     * @throws std::invalid_argument If the topology is Topology::Global.
+     */
+    Neighborhoods(const Topology     &topology,
+                  const unsigned int &numParticles,
+                  const unsigned int &informants,
+                  const Philox       &random) {
+        // Index of the particle offset positions after j, on the ring of all the particles.
+        const auto wrap = [&](const unsigned int &j, const long long &offset) {
+            const long long n = numParticles;
+            return static_cast<unsigned int>(((j + offset) % n + n) % n);
+        };
+            switch (topology) {
+                case Topology::Ring:
+                    size = 2 * informants + 1;
+                    break;
+                case Topology::VonNeumann:
+                    size = 5;
+                    break;
+                case Topology::RandomK:
+                    size = std::min(informants, numParticles > 0 ? numParticles - 1 : 0) + 1;
+                    break;
+                default:
+                    throw std::invalid_argument("the global topology has no neighborhoods");
+            }
+        // Width of the grid of the von Neumann topology, and of its last row.
+        const unsigned int columns = static_cast<unsigned int>(
+            std::max(1l, std::lround(std::sqrt(static_cast<double>(numParticles)))));
+        const unsigned int lastColumns = numParticles - (numParticles - 1) / columns * columns;
+        neighbors.resize(static_cast<std::size_t>(numParticles) * size);
+            for (unsigned int j = 0; j < numParticles; j++) {
+                unsigned int *row = neighbors.data() + static_cast<std::size_t>(j) * size;
+                row[0]            = j;
+                    for (unsigned int k = 1; k < size; k++) {
+                            if (topology == Topology::Ring) {
+                                row[k] = wrap(j, k <= informants ? -static_cast<long long>(k)
+                                                                  : k - informants);
+                            } else if (topology == Topology::VonNeumann) {
+                                const unsigned int r      = j / columns;
+                                const unsigned int c      = j % columns;
+                                const unsigned int width  = (j - c) + columns <= numParticles
+                                                                ? columns
+                                                                : lastColumns;
+                                const unsigned int height =
+                                    (numParticles - 1) / columns + (c < lastColumns ? 1 : 0);
+                                // Above, below, on the left and on the right.
+                                const unsigned int grid[] = {
+                                    (r + height - 1) % height * columns + c,
+                                    (r + 1) % height * columns + c,
+                                    r * columns + (c + width - 1) % width,
+                                    r * columns + (c + 1) % width};
+                                row[k] = grid[k - 1];
+                            } else {
+                                // Floyd's sampling: the k-th draw picks one of the first
+                                // numParticles - size + k particles other than j, or the last of
+                                // them if it was drawn already, so that the informants are
+                                // distinct.
+                                const unsigned int range    = numParticles - size + k;
+                                const auto         particle = [&](const unsigned int &other) {
+                                    return other < j ? other : other + 1;
+                                };
+                                row[k] = particle(random.word(0, j, k, Philox::topologyStream) %
+                                                  range);
+                                    if (std::find(row + 1, row + k, row[k]) != row + k) {
+                                        row[k] = particle(range - 1);
+                                }
+                            }
+                    }
+                std::sort(row, row + size);
+            }
+    }
+
+    /**
+     * @brief Get the number of neighbors of every particle, itself included.
+     */
+    unsigned int
+    getSize() const {
+        return size;
+    }
+
+    /**
+     * @brief Get the getSize() indices of the neighbors of the j-th particle, in increasing order.
+     */
+    const unsigned int *
+    of(const unsigned int &j) const {
+        return neighbors.data() + static_cast<std::size_t>(j) * size;
+    }
+
+  private:
+    /**
+     * @brief Number of neighbors of every particle, itself included.
+     */
+    unsigned int size = 0;
+    /**
+     * @brief Indices of the neighbors, size entries per particle.
+     */
+    std::vector<unsigned int> neighbors;
+};
+
+#endif
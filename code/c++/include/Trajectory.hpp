@@ -0,0 +1,468 @@
+#ifndef TRAJECTORY_HPP
+#define TRAJECTORY_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief How the values of a trajectory file are stored.
+ */
+enum class TrajectoryEncoding : std::uint32_t {
+    /**
+     * @brief 32-bit floats.
+     */
+    Float32 = 0,
+    /**
+     * @brief Raw values of 32-bit fixed-point numbers, with TrajectoryHeader::fractionBits
+     * fractional bits.
+     */
+    Fixed32 = 1
+};
+
+/**
+ * @brief Flag of TrajectoryHeader::flags: the positions and the velocities of every record are
+ * stored as differences from the previous record, and the values of a particle are recovered by a
+ * cumulative sum over the records.
+ */
+constexpr std::uint32_t trajectoryDelta = 1;
+
+/**
+ * @brief Header at the beginning of a trajectory file.
+ * @details A trajectory file is this header followed by fixed-size records, one per recorded
+ * iteration, all in little-endian byte order. A record holds, as 4-byte values, the number of
+ * iterations performed (unsigned), the best score, the dimensions coordinates of the best
+ * position, and then the positions and the velocities of the particles, each stored as the
+ * numParticles coordinates along the first dimension, then along the second one, and so on. The
+ * number of records follows from the size of the file, so that a file cut short by a crash or by a
+ * stopping criterion can still be read, e.g. by numpy.memmap. The C optimizer writes the same
+ * format.
+ */
+struct TrajectoryHeader {
+    /**
+     * @brief "PSOTRAJ", terminated by a null character.
+     */
+    char magic[8];
+    /**
+     * @brief Version of the format, currently 1.
+     */
+    std::uint32_t version;
+    /**
+     * @brief Size of the header in bytes, i.e. offset of the first record.
+     */
+    std::uint32_t headerSize;
+    /**
+     * @brief Number of dimensions of the problem.
+     */
+    std::uint32_t dimensions;
+    /**
+     * @brief Number of particles.
+     */
+    std::uint32_t numParticles;
+    /**
+     * @brief Maximum number of iterations of the run.
+     */
+    std::uint32_t maxIterations;
+    /**
+     * @brief Number of iterations between two records; the final state is always recorded.
+     */
+    std::uint32_t interval;
+    /**
+     * @brief How the values are stored, see TrajectoryEncoding.
+     */
+    std::uint32_t encoding;
+    /**
+     * @brief Number of fractional bits of the values, with the Fixed32 encoding.
+     */
+    std::uint32_t fractionBits;
+    /**
+     * @brief Combination of flags, i.e. trajectoryDelta or 0.
+     */
+    std::uint32_t flags;
+    /**
+     * @brief Size of a record in bytes.
+     */
+    std::uint32_t recordSize;
+    /**
+     * @brief Lower bound of the search space.
+     */
+    double lowerBound;
+    /**
+     * @brief Upper bound of the search space.
+     */
+    double upperBound;
+    /**
+     * @brief Name of the function to minimize, null-terminated, e.g. "f1".
+     */
+    char function[16];
+};
+
+static_assert(sizeof(TrajectoryHeader) == 80, "the header of a trajectory file has no padding");
+
+/**
+ * @brief Encoding of the values of Scalar in a trajectory file.
+ * @details The generic version stores them as 32-bit floats. The fixed-point types specialize it
+ * to store their raw values, so that the trajectory is exact.
+ */
+template <typename Scalar>
+struct TrajectoryTraits {
+    /**
+     * @brief Type of the stored values, on 4 bytes.
+     */
+    using Value = float;
+
+    /**
+     * @brief Encoding written in the header.
+     */
+    static constexpr TrajectoryEncoding encoding = TrajectoryEncoding::Float32;
+
+    /**
+     * @brief Number of fractional bits written in the header.
+     */
+    static constexpr std::uint32_t fractionBits = 0;
+
+    /**
+     * @brief Convert x to its stored value.
+     */
+    static Value
+    encode(const Scalar &x) {
+        return static_cast<float>(static_cast<double>(x));
+    }
+};
+
+/**
+ * @brief Writer of trajectory files, see TrajectoryHeader.
+ * @details record() only converts the state into a buffer, on the calling thread; full buffers are
+ * written to the file by a background thread, while the next ones are filled, so that the run
+ * does not wait for the disk unless the disk is slower than the run. The file is complete once
+ * close() has been called, or the writer destroyed; only close() reports a failed write.
+ * @tparam Scalar Arithmetic type of the optimizer.
+ */
+template <typename Scalar>
+class TrajectoryWriter {
+  public:
+    /**
+     * @brief Type of the stored values.
+     */
+    using Value = typename TrajectoryTraits<Scalar>::Value;
+
+    static_assert(sizeof(Value) == 4, "the values of a trajectory file are stored on 4 bytes");
+
+    /**
+     * @brief Create the file path, write its header and start the background thread.
+     *
+     * @param path_ Path of the file, overwritten if it exists.
+     * @param dimensions_ Number of dimensions of the problem.
+     * @param numParticles_ Number of particles.
+     * @param maxIterations Maximum number of iterations of the run.
+     * @param lowerBound Lower bound of the search space.
+     * @param upperBound Upper bound of the search space.
+     * @param function Name of the function to minimize, truncated to 15 characters.
+     * @param interval_ Number of iterations between two records (at least 1).
+     * @param delta_ Whether to store the positions and velocities as differences from the
+     * previous record.
+     * @param bufferSize Size of each of the two buffers in bytes; a buffer holds at least one
+     * record.
+     * @throw std::runtime_error If the file cannot be created or its header written.
+     */
+    TrajectoryWriter(const std::string  &path_,
+                     const unsigned int &dimensions_,
+                     const unsigned int &numParticles_,
+                     const unsigned int &maxIterations,
+                     const double       &lowerBound,
+                     const double       &upperBound,
+                     const std::string  &function,
+                     const unsigned int &interval_   = 1,
+                     const bool         &delta_      = false,
+                     const std::size_t  &bufferSize = 1 << 20) :
+        path(path_),
+        dimensions(dimensions_),
+        numParticles(numParticles_),
+        interval(std::max(1u, interval_)),
+        delta(delta_),
+        recordValues(2 + dimensions_ + 2 * static_cast<std::size_t>(dimensions_) * numParticles_),
+        capacity(std::max<std::size_t>(1, bufferSize / (recordValues * sizeof(Value))) *
+                 recordValues),
+        previous(delta_ ? 2 * static_cast<std::size_t>(dimensions_) * numParticles_ : 0,
+                 Value{0}) {
+        file = std::fopen(path.c_str(), "wb");
+            if (file == nullptr) {
+                throw std::runtime_error("cannot create the trajectory file " + path);
+        }
+        TrajectoryHeader header{};
+        std::memcpy(header.magic, "PSOTRAJ", 8);
+        header.version       = 1;
+        header.headerSize    = sizeof(TrajectoryHeader);
+        header.dimensions    = dimensions;
+        header.numParticles  = numParticles;
+        header.maxIterations = maxIterations;
+        header.interval      = interval;
+        header.encoding      = static_cast<std::uint32_t>(TrajectoryTraits<Scalar>::encoding);
+        header.fractionBits  = TrajectoryTraits<Scalar>::fractionBits;
+        header.flags         = delta ? trajectoryDelta : 0;
+        header.recordSize    = static_cast<std::uint32_t>(recordValues * sizeof(Value));
+        header.lowerBound    = lowerBound;
+        header.upperBound    = upperBound;
+        std::strncpy(header.function, function.c_str(), sizeof(header.function) - 1);
+            if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+                std::fclose(file);
+                throw std::runtime_error("cannot write the trajectory file " + path);
+        }
+
+        filling.reserve(capacity);
+        writing.reserve(capacity);
+        writer = std::thread([this]() { writerLoop(); });
+    }
+
+    TrajectoryWriter(const TrajectoryWriter &) = delete;
+
+    TrajectoryWriter &
+    operator=(const TrajectoryWriter &) = delete;
+
+    /**
+     * @brief Close the file, see close(), ignoring a failed write.
+     */
+    ~TrajectoryWriter() {
+            try {
+                close();
+            } catch (const std::runtime_error &) {
+            }
+    }
+
+    /**
+     * @brief Whether the state after the given number of iterations is to be recorded, according
+     * to the interval.
+     */
+    bool
+    wants(const unsigned int &iteration) const {
+        return iteration % interval == 0;
+    }
+
+    /**
+     * @brief Append the state after the given number of iterations to the file.
+     *
+     * @param iteration Number of iterations performed.
+     * @param bestScore Best score found so far.
+     * @param bestPosition Best position found so far, as dimensions coordinates.
+     * @param positions Positions of the particles: positions.row(d) points to their coordinates
+     * along the d-th dimension.
+     * @param velocities Velocities of the particles, as positions.
+     */
+    template <typename Storage>
+    void
+    record(const unsigned int &iteration,
+           const Scalar       &bestScore,
+           const Scalar       *bestPosition,
+           const Storage      &positions,
+           const Storage      &velocities) {
+            if (filling.size() + recordValues > capacity) {
+                submit();
+        }
+        Value encoded;
+        static_assert(sizeof(iteration) == sizeof(encoded), "the iteration is stored on 4 bytes");
+        std::memcpy(&encoded, &iteration, sizeof(encoded));
+        filling.push_back(encoded);
+        filling.push_back(TrajectoryTraits<Scalar>::encode(bestScore));
+            for (unsigned int d = 0; d < dimensions; d++) {
+                filling.push_back(TrajectoryTraits<Scalar>::encode(bestPosition[d]));
+            }
+        Value *last = previous.data();
+            for (const Storage *storage : {&positions, &velocities}) {
+                    for (unsigned int d = 0; d < dimensions; d++) {
+                        const Scalar *x = storage->row(d);
+                            for (unsigned int j = 0; j < numParticles; j++) {
+                                const Value value = TrajectoryTraits<Scalar>::encode(x[j]);
+                                    if (delta) {
+                                        filling.push_back(difference(value, *last));
+                                        // The reader sums the differences in the same type.
+                                        *last = add(*last, filling.back());
+                                        last++;
+                                    } else {
+                                        filling.push_back(value);
+                                    }
+                            }
+                    }
+            }
+    }
+
+    /**
+     * @brief Write the buffered records, stop the background thread and close the file.
+     * @details Does nothing if the file is already closed.
+     * @throw std::runtime_error If a record could not be written or the file could not be closed.
+     */
+    void
+    close() {
+            if (file == nullptr) {
+                return;
+        }
+        submit();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        changed.notify_all();
+        writer.join();
+        const bool closed = std::fclose(file) == 0;
+        file              = nullptr;
+            if (failed || !closed) {
+                throw std::runtime_error("cannot write the trajectory file " + path);
+        }
+    }
+
+    /**
+     * @brief Get the number of iterations between two records.
+     */
+    unsigned int
+    getInterval() const {
+        return interval;
+    }
+
+  private:
+    /**
+     * @brief Get a - b, wrapping around for integer values.
+     */
+    static Value
+    difference(const Value &a, const Value &b) {
+            if constexpr (std::is_integral_v<Value>) {
+                return static_cast<Value>(static_cast<std::uint32_t>(a) -
+                                          static_cast<std::uint32_t>(b));
+            } else {
+                return a - b;
+            }
+    }
+
+    /**
+     * @brief Get a + b, wrapping around for integer values.
+     */
+    static Value
+    add(const Value &a, const Value &b) {
+            if constexpr (std::is_integral_v<Value>) {
+                return static_cast<Value>(static_cast<std::uint32_t>(a) +
+                                          static_cast<std::uint32_t>(b));
+            } else {
+                return a + b;
+            }
+    }
+
+    /**
+     * @brief Hand the buffer being filled to the background thread, once it is done with the
+     * previous one, and start filling the other one.
+     */
+    void
+    submit() {
+            if (filling.empty()) {
+                return;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this]() { return !pending; });
+        std::swap(filling, writing);
+        pending = true;
+        lock.unlock();
+        changed.notify_all();
+        filling.clear();
+    }
+
+    /**
+     * @brief Body of the background thread: write every submitted buffer to the file.
+     */
+    void
+    writerLoop() {
+            while (true) {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [this]() { return pending || stopping; });
+                    if (!pending) {
+                        return;
+                }
+                lock.unlock();
+                const bool written =
+                    std::fwrite(writing.data(), sizeof(Value), writing.size(), file) ==
+                    writing.size();
+                lock.lock();
+                failed  = failed || !written;
+                pending = false;
+                lock.unlock();
+                changed.notify_all();
+            }
+    }
+
+    /**
+     * @brief Path of the file.
+     */
+    const std::string path;
+    /**
+     * @brief Number of dimensions of the problem.
+     */
+    const unsigned int dimensions;
+    /**
+     * @brief Number of particles.
+     */
+    const unsigned int numParticles;
+    /**
+     * @brief Number of iterations between two records.
+     */
+    const unsigned int interval;
+    /**
+     * @brief Whether the positions and velocities are stored as differences.
+     */
+    const bool delta;
+    /**
+     * @brief Number of values of a record.
+     */
+    const std::size_t recordValues;
+    /**
+     * @brief Number of values of a buffer, a multiple of recordValues.
+     */
+    const std::size_t capacity;
+    /**
+     * @brief Positions and velocities of the previous record, as recovered by the reader, if
+     * delta.
+     */
+    std::vector<Value> previous;
+    /**
+     * @brief Buffer filled by record().
+     */
+    std::vector<Value> filling;
+    /**
+     * @brief Buffer written by the background thread while pending.
+     */
+    std::vector<Value> writing;
+    /**
+     * @brief File being written, or nullptr once closed.
+     */
+    std::FILE *file = nullptr;
+    /**
+     * @brief Background thread.
+     */
+    std::thread writer;
+    /**
+     * @brief Protects pending, stopping and failed.
+     */
+    std::mutex mutex;
+    /**
+     * @brief Signaled when pending or stopping change.
+     */
+    std::condition_variable changed;
+    /**
+     * @brief Whether writing holds a buffer that is not written yet.
+     */
+    bool pending = false;
+    /**
+     * @brief Whether close() asked the background thread to stop.
+     */
+    bool stopping = false;
+    /**
+     * @brief Whether the background thread failed to write a buffer; the first failure is kept
+     * until close() reports it.
+     */
+    bool failed = false;
+};
+
+#endif
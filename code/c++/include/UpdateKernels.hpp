@@ -0,0 +1,299 @@
+#ifndef UPDATE_KERNELS_HPP
+#define UPDATE_KERNELS_HPP
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#    define PSO_X86_KERNELS
+#    include <immintrin.h>
+#endif
+
+// Keep the compiler from fusing multiplications and additions into FMA instructions inside the
+// kernels: AVX-512 (and -march=native) enable FMA, which would round differently from the other
+// kernels.
+#if defined(__GNUC__) && !defined(__clang__)
+#    define PSO_NO_FP_CONTRACT __attribute__((optimize("fp-contract=off")))
+#else
+#    define PSO_NO_FP_CONTRACT
+#endif
+
+/**
+ * @brief Instruction sets for which the velocity and position update is specialized.
+ */
+enum class SimdLevel { Scalar, SSE2, AVX2, AVX512 };
+
+/**
+ * @brief Get a printable name of the given instruction set.
+ */
+inline const char *
+simdLevelName(const SimdLevel &level) {
+        switch (level) {
+            case SimdLevel::SSE2:
+                return "SSE2";
+            case SimdLevel::AVX2:
+                return "AVX2";
+            case SimdLevel::AVX512:
+                return "AVX-512";
+            default:
+                return "scalar";
+        }
+}
+
+/**
+ * @brief Detect the widest instruction set supported by the CPU the program is running on.
+ * @details The CPU is only queried by the first call, later calls return the cached result.
+ */
+inline SimdLevel
+detectSimdLevel() {
+    static const SimdLevel detected = []() {
+#ifdef PSO_X86_KERNELS
+        __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) {
+                return SimdLevel::AVX512;
+        }
+            if (__builtin_cpu_supports("avx2")) {
+                return SimdLevel::AVX2;
+        }
+            if (__builtin_cpu_supports("sse2")) {
+                return SimdLevel::SSE2;
+        }
+#endif
+        return SimdLevel::Scalar;
+    }();
+    return detected;
+}
+
+/**
+ * @brief Update the velocities and positions of n particles along one dimension.
+ * @details For every particle j computes
+ * v[j] = w v[j] + c rc[j] (p[j] - x[j]) + s rs[j] (g - x[j]), and then x[j] += v[j].
+ * The vectorized kernels evaluate the expression with the same operations in the same order, so
+ * that all the kernels give bit-identical results.
+ *
+ * @param n Number of particles.
+ * @param w Inertia weight.
+ * @param c Cognitive weight coefficient.
+ * @param s Social weight coefficient.
+ * @param g Coordinate of the global best position along this dimension.
+ * @param x Coordinates of the positions, updated in place.
+ * @param v Components of the velocities, updated in place.
+ * @param p Coordinates of the personal best positions.
+ * @param rc Random factors of the cognitive component, one per particle.
+ * @param rs Random factors of the social component, one per particle.
+ */
+template <typename Scalar>
+PSO_NO_FP_CONTRACT inline void
+updateParticlesScalar(const unsigned int &n,
+                      const Scalar       &w,
+                      const Scalar       &c,
+                      const Scalar       &s,
+                      const Scalar       &g,
+                      Scalar *__restrict x,
+                      Scalar *__restrict v,
+                      const Scalar *__restrict p,
+                      const Scalar *__restrict rc,
+                      const Scalar *__restrict rs) {
+#ifdef __clang__
+#    pragma clang fp contract(off)
+#endif
+        for (unsigned int j = 0; j < n; j++) {
+            v[j] = w * v[j] + c * rc[j] * (p[j] - x[j]) + s * rs[j] * (g - x[j]);
+            x[j] += v[j];
+        }
+}
+
+/**
+ * @brief Version of updateParticlesScalar() where every particle follows its own best position
+ * g[j], the best one of its neighborhood, instead of a global one.
+ * @details All the arrays are contiguous, so the compiler vectorizes the loop for the types that
+ * allow it.
+ */
+template <typename Scalar>
+PSO_NO_FP_CONTRACT inline void
+updateParticlesNeighborhood(const unsigned int &n,
+                            const Scalar       &w,
+                            const Scalar       &c,
+                            const Scalar       &s,
+                            const Scalar *__restrict g,
+                            Scalar *__restrict x,
+                            Scalar *__restrict v,
+                            const Scalar *__restrict p,
+                            const Scalar *__restrict rc,
+                            const Scalar *__restrict rs) {
+#ifdef __clang__
+#    pragma clang fp contract(off)
+#endif
+        for (unsigned int j = 0; j < n; j++) {
+            v[j] = w * v[j] + c * rc[j] * (p[j] - x[j]) + s * rs[j] * (g[j] - x[j]);
+            x[j] += v[j];
+        }
+}
+
+#ifdef PSO_X86_KERNELS
+/**
+ * @brief SSE2 version of updateParticlesScalar(), processing 2 particles per instruction.
+ */
+__attribute__((target("sse2"))) PSO_NO_FP_CONTRACT inline void
+updateParticlesSSE2(const unsigned int &n,
+                    const double       &w,
+                    const double       &c,
+                    const double       &s,
+                    const double       &g,
+                    double *__restrict x,
+                    double *__restrict v,
+                    const double *__restrict p,
+                    const double *__restrict rc,
+                    const double *__restrict rs) {
+    const __m128d vw = _mm_set1_pd(w);
+    const __m128d vc = _mm_set1_pd(c);
+    const __m128d vs = _mm_set1_pd(s);
+    const __m128d vg = _mm_set1_pd(g);
+    unsigned int  j  = 0;
+        for (; j + 2 <= n; j += 2) {
+            const __m128d xj        = _mm_loadu_pd(x + j);
+            const __m128d cognitive = _mm_mul_pd(_mm_mul_pd(vc, _mm_loadu_pd(rc + j)),
+                                                 _mm_sub_pd(_mm_loadu_pd(p + j), xj));
+            const __m128d social =
+                _mm_mul_pd(_mm_mul_pd(vs, _mm_loadu_pd(rs + j)), _mm_sub_pd(vg, xj));
+            const __m128d vj =
+                _mm_add_pd(_mm_add_pd(_mm_mul_pd(vw, _mm_loadu_pd(v + j)), cognitive), social);
+            _mm_storeu_pd(v + j, vj);
+            _mm_storeu_pd(x + j, _mm_add_pd(xj, vj));
+        }
+    updateParticlesScalar<double>(n - j, w, c, s, g, x + j, v + j, p + j, rc + j, rs + j);
+}
+
+/**
+ * @brief AVX2 version of updateParticlesScalar(), processing 4 particles per instruction.
+ */
+__attribute__((target("avx2"))) PSO_NO_FP_CONTRACT inline void
+updateParticlesAVX2(const unsigned int &n,
+                    const double       &w,
+                    const double       &c,
+                    const double       &s,
+                    const double       &g,
+                    double *__restrict x,
+                    double *__restrict v,
+                    const double *__restrict p,
+                    const double *__restrict rc,
+                    const double *__restrict rs) {
+    const __m256d vw = _mm256_set1_pd(w);
+    const __m256d vc = _mm256_set1_pd(c);
+    const __m256d vs = _mm256_set1_pd(s);
+    const __m256d vg = _mm256_set1_pd(g);
+    unsigned int  j  = 0;
+        for (; j + 4 <= n; j += 4) {
+            const __m256d xj        = _mm256_loadu_pd(x + j);
+            const __m256d cognitive = _mm256_mul_pd(_mm256_mul_pd(vc, _mm256_loadu_pd(rc + j)),
+                                                    _mm256_sub_pd(_mm256_loadu_pd(p + j), xj));
+            const __m256d social =
+                _mm256_mul_pd(_mm256_mul_pd(vs, _mm256_loadu_pd(rs + j)), _mm256_sub_pd(vg, xj));
+            const __m256d vj = _mm256_add_pd(
+                _mm256_add_pd(_mm256_mul_pd(vw, _mm256_loadu_pd(v + j)), cognitive), social);
+            _mm256_storeu_pd(v + j, vj);
+            _mm256_storeu_pd(x + j, _mm256_add_pd(xj, vj));
+        }
+    updateParticlesScalar<double>(n - j, w, c, s, g, x + j, v + j, p + j, rc + j, rs + j);
+}
+
+/**
+ * @brief AVX-512 version of updateParticlesScalar(), processing 8 particles per instruction.
+ * @details The remainder is handled with masked loads and stores instead of a scalar loop.
+ */
+__attribute__((target("avx512f"))) PSO_NO_FP_CONTRACT inline void
+updateParticlesAVX512(const unsigned int &n,
+                      const double       &w,
+                      const double       &c,
+                      const double       &s,
+                      const double       &g,
+                      double *__restrict x,
+                      double *__restrict v,
+                      const double *__restrict p,
+                      const double *__restrict rc,
+                      const double *__restrict rs) {
+    const __m512d vw = _mm512_set1_pd(w);
+    const __m512d vc = _mm512_set1_pd(c);
+    const __m512d vs = _mm512_set1_pd(s);
+    const __m512d vg = _mm512_set1_pd(g);
+        for (unsigned int j = 0; j < n; j += 8) {
+            const __mmask8 m = (n - j >= 8) ? 0xFF : static_cast<__mmask8>((1u << (n - j)) - 1);
+            const __m512d  xj = _mm512_maskz_loadu_pd(m, x + j);
+            const __m512d  cognitive =
+                _mm512_mul_pd(_mm512_mul_pd(vc, _mm512_maskz_loadu_pd(m, rc + j)),
+                              _mm512_sub_pd(_mm512_maskz_loadu_pd(m, p + j), xj));
+            const __m512d social =
+                _mm512_mul_pd(_mm512_mul_pd(vs, _mm512_maskz_loadu_pd(m, rs + j)),
+                              _mm512_sub_pd(vg, xj));
+            const __m512d vj = _mm512_add_pd(
+                _mm512_add_pd(_mm512_mul_pd(vw, _mm512_maskz_loadu_pd(m, v + j)), cognitive),
+                social);
+            _mm512_mask_storeu_pd(v + j, m, vj);
+            _mm512_mask_storeu_pd(x + j, m, _mm512_add_pd(xj, vj));
+        }
+}
+#endif
+
+/**
+ * @brief Velocity and position update kernel for the given Scalar type.
+ * @details The generic version only provides the scalar kernel; specializations provide
+ * vectorized kernels and pick one according to the requested instruction set.
+ */
+template <typename Scalar>
+struct UpdateKernel {
+    /**
+     * @brief Signature shared by all the kernels, see updateParticlesScalar().
+     */
+    using Function = void (*)(const unsigned int &,
+                              const Scalar &,
+                              const Scalar &,
+                              const Scalar &,
+                              const Scalar &,
+                              Scalar *,
+                              Scalar *,
+                              const Scalar *,
+                              const Scalar *,
+                              const Scalar *);
+
+    /**
+     * @brief Get the kernel for the given instruction set, or for the widest one available below
+     * it.
+     */
+    static Function
+    select(const SimdLevel &) {
+        return &updateParticlesScalar<Scalar>;
+    }
+};
+
+/**
+ * @brief Velocity and position update kernels for double.
+ */
+template <>
+struct UpdateKernel<double> {
+    using Function = void (*)(const unsigned int &,
+                              const double &,
+                              const double &,
+                              const double &,
+                              const double &,
+                              double *,
+                              double *,
+                              const double *,
+                              const double *,
+                              const double *);
+
+    static Function
+    select(const SimdLevel &level) {
+#ifdef PSO_X86_KERNELS
+            switch (level) {
+                case SimdLevel::AVX512:
+                    return &updateParticlesAVX512;
+                case SimdLevel::AVX2:
+                    return &updateParticlesAVX2;
+                case SimdLevel::SSE2:
+                    return &updateParticlesSSE2;
+                default:
+                    break;
+            }
+#endif
+        return &updateParticlesScalar<double>;
+    }
+};
+
+#endif
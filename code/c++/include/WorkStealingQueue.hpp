@@ -0,0 +1,101 @@
+#ifndef WORK_STEALING_QUEUE_HPP
+#define WORK_STEALING_QUEUE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief Bounded queue of work items, filled by one worker and emptied by every worker, without a
+ * lock.
+ * @details The owner puts the items it is done with back at the end, and takes items from the
+ * front, so that it cycles through its items in round-robin order. Other workers that run out of
+ * work steal from the front too: an item is taken by a compare-and-swap on the position of the
+ * front, which only fails if another worker took an item in the meantime. Only the owner appends
+ * items, so the end is a plain counter that it publishes once the item is stored. The queue never
+ * holds more than capacity items and never allocates after construction.
+ */
+class WorkStealingQueue {
+  public:
+    /**
+     * @brief Construct an empty queue that can hold up to capacity_ items.
+     */
+    explicit WorkStealingQueue(const unsigned int &capacity_ = 0) :
+        capacity(capacity_), items(std::make_unique<std::atomic<unsigned int>[]>(capacity_)) {}
+
+    /**
+     * @brief Append an item at the end of the queue. Must only be called by the owner, or before
+     * the other workers start.
+     * @return false if the queue is full.
+     */
+    bool
+    push(const unsigned int &item) {
+        const std::uint64_t back = bottom.load(std::memory_order_relaxed);
+            // Taking an item releases its slot, so that it is not overwritten while being read.
+            if (back - top.load(std::memory_order_acquire) >= capacity) {
+                return false;
+        }
+        items[back % capacity].store(item, std::memory_order_relaxed);
+        bottom.store(back + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Take the item at the front of the queue. Meant to be called by the owner.
+     * @return false if the queue is empty.
+     */
+    bool
+    pop(unsigned int &item) {
+        return take(item);
+    }
+
+    /**
+     * @brief Take the item at the front of the queue, i.e. the one the owner would take next.
+     * Meant to be called by the other workers.
+     * @return false if the queue is empty.
+     */
+    bool
+    steal(unsigned int &item) {
+        return take(item);
+    }
+
+  private:
+    /**
+     * @brief Take the item at the front of the queue, if any.
+     */
+    bool
+    take(unsigned int &item) {
+        std::uint64_t front = top.load(std::memory_order_acquire);
+            // A failed compare-and-swap reloads front, and the item read from a slot that was
+            // taken meanwhile is discarded.
+            while (front < bottom.load(std::memory_order_acquire)) {
+                item = items[front % capacity].load(std::memory_order_relaxed);
+                    if (top.compare_exchange_weak(front,
+                                                  front + 1,
+                                                  std::memory_order_acq_rel,
+                                                  std::memory_order_acquire)) {
+                        return true;
+                }
+            }
+        return false;
+    }
+
+    /**
+     * @brief Maximum number of items.
+     */
+    unsigned int capacity;
+    /**
+     * @brief Circular buffer of the items.
+     */
+    std::unique_ptr<std::atomic<unsigned int>[]> items;
+    /**
+     * @brief Number of items ever taken, i.e. position of the front of the queue.
+     */
+    alignas(64) std::atomic<std::uint64_t> top{0};
+    /**
+     * @brief Number of items ever appended, i.e. position of the end of the queue.
+     */
+    alignas(64) std::atomic<std::uint64_t> bottom{0};
+};
+
+#endif
@@ -10,6 +10,15 @@
 
 // #define DEBUG
 
+// Boundary policy, as in pso_fp.h: 0 none, 1 clamp, 2 reflect, 3 wrap, 4 reinitialize, 5 absorb
+#ifndef BOUNDARY
+#define BOUNDARY 0
+#endif
+// Largest absolute velocity along a dimension, 0 if unbounded
+#ifndef V_MAX
+#define V_MAX 0.0
+#endif
+
 
 struct psoSwarm {
     double best_pos[2];
@@ -38,6 +47,40 @@ double cost_func_2(double x, double y) {
     return z;
 }
 
+// Bring the coordinate x of a particle back into [b_lo, b_up] according to BOUNDARY, v being its
+// velocity. Only min, max and selections are used, so that it has no branch.
+void enforce_bounds(double *x, double *v, double b_lo, double b_up) {
+    double width = b_up - b_lo;
+    double xi = *x;
+    int out = (xi < b_lo) | (xi > b_up);
+    double clamped = xi < b_lo ? b_lo : (xi > b_up ? b_up : xi);
+    // Reflections and wraps move the coordinate by the width of the domain at most
+    double mirrored = xi > b_up ? b_up + b_up - xi : (xi < b_lo ? b_lo + b_lo - xi : xi);
+    double wrapped = xi + (xi < b_lo ? width : 0.0) - (xi > b_up ? width : 0.0);
+    switch(BOUNDARY) {
+    case 1:
+        *x = clamped;
+        break;
+    case 2:
+        *x = mirrored < b_lo ? b_lo : (mirrored > b_up ? b_up : mirrored);
+        *v = out ? -*v : *v;
+        break;
+    case 3:
+        *x = wrapped < b_lo ? b_lo : (wrapped > b_up ? b_up : wrapped);
+        break;
+    case 4: {
+        // The coordinate is drawn even if it is kept, so that the selection has no branch
+        double fresh = ((double)rand() / RAND_MAX) * width + b_lo;
+        *x = out ? fresh : xi;
+        break;
+    }
+    case 5:
+        *x = clamped;
+        *v = out ? 0.0 : *v;
+        break;
+    }
+}
+
 
 int main(int argc, char *argv[]) {
 
@@ -135,10 +178,16 @@ int main(int argc, char *argv[]) {
                 particles[i].vel[j] =   W * particles[i].vel[j] + 
                                         PHI_P * rp * (particles[i].best_pos[j] - particles[i].pos[j]) +
                                         PHI_G * rg * (swarm.best_pos[j] - particles[i].pos[j]);
+                // Clamp it: -v_max <= vi,d <= v_max
+                if(V_MAX > 0)
+                    particles[i].vel[j] = particles[i].vel[j] < -V_MAX ? -V_MAX :
+                                          (particles[i].vel[j] > V_MAX ? V_MAX : particles[i].vel[j]);
             }
-            // Update the particle's position: xi ← xi + vi
-            for(int j = 0; j < 2; ++j)
+            // Update the particle's position: xi ← xi + vi, and bring it back into the domain
+            for(int j = 0; j < 2; ++j) {
                 particles[i].pos[j] += particles[i].vel[j];
+                enforce_bounds(&particles[i].pos[j], &particles[i].vel[j], b_lo, b_up);
+            }
             // if f(xi) < f(pi) then
             double new_score = cost_func_2(particles[i].pos[0], particles[i].pos[1]);
             if(new_score < particles[i].best_score) {
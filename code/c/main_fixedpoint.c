@@ -5,32 +5,48 @@
 #include <float.h>
 #include <limits.h>
 #include <stdint.h>
+#include <pthread.h>
+
+#include "pso_fp.h"
 
 #define W 0.75
 #define PHI_P 1.0
 #define PHI_G 1.0
 
-// Run with parameters 10 100 -5.0 5.0, otherwise pass them as arguments:
+// Without arguments, run with parameters 100 100 -5.0 5.0 FUNCTION DIMENSIONS, otherwise pass
+// them as arguments:
 #define DEBUG
 
 // Generate output during iterations:
 // #define VERBOSE
 #define VERBOSE_INTERVAL 10
 
-// Generate output for visualization:
+// Generate output for visualization: the trajectory of the swarm is written to OUTPUT_FILE in the
+// binary format of the C++ version (see TrajectoryHeader in code/c++/include/Trajectory.hpp), by
+// a background thread, every OUTPUT_INTERVAL iterations. OUTPUT_DELTA stores the positions and
+// velocities as differences from the previous record.
 #define OUTPUT
+#define OUTPUT_FILE "trajectory.bin"
 #define OUTPUT_INTERVAL 1
-
-// Choose the cost function:
-#define FUNCTION cost_func_1
-
-///// FIXED POINT //////
-// We're using s15.16 fixed point numbers:
-// 1 bit for the sign
-// 15 bits for the integer part
-// 16 bits for the fractional part
-#define FRAC_BITS 16
-
+// #define OUTPUT_DELTA
+#define OUTPUT_BUFFER_SIZE (1 << 20)
+
+// Default cost function and number of dimensions, when they are not passed as arguments (see
+// pso_fp_functions in pso_fp.h for the available functions):
+#define FUNCTION "f1"
+#define DIMENSIONS 2
+
+// Seed of the random numbers
+#define SEED 42
+
+// Boundary policy (see BOUNDARY_NONE and the others in pso_fp.h) and largest absolute velocity
+// along a dimension, 0 if unbounded, e.g. -DBOUNDARY=BOUNDARY_REFLECT -DV_MAX=2.0
+#ifndef BOUNDARY
+#define BOUNDARY BOUNDARY_NONE
+#endif
+#ifndef V_MAX
+#define V_MAX 0.0
+#endif
 
 // Die with an error message
 void die(const char *msg) {
@@ -38,137 +54,257 @@ void die(const char *msg) {
     exit(1);
 }
 
-// Convert a double to a fixed point number
-int32_t fp_from_double(double a) {
-    return (int32_t)(a * (1 << FRAC_BITS));
-}
+// Header of the trajectory file, 80 bytes in little-endian byte order
+struct trajHeader {
+    char magic[8];          // "PSOTRAJ"
+    uint32_t version;       // 1
+    uint32_t header_size;   // sizeof(struct trajHeader)
+    uint32_t dimensions;
+    uint32_t n_particles;
+    uint32_t n_iterations;
+    uint32_t interval;      // OUTPUT_INTERVAL
+    uint32_t encoding;      // 1: raw fixed point values
+    uint32_t frac_bits;     // FRAC_BITS
+    uint32_t flags;         // 1 if OUTPUT_DELTA
+    uint32_t record_size;   // bytes per record
+    double b_lo;
+    double b_up;
+    char function[16];      // name of the cost function
+};
 
-// Convert a fixed point number to a double
-double fp_to_double(int32_t a) {
-    return ((double)a / (1 << FRAC_BITS));
+// Trajectory writer: the records are stored into one of two buffers while a background thread
+// writes the other one to the file
+struct trajWriter {
+    FILE *fp;
+    int32_t *buffers[2];
+    size_t fill[2];             // number of values in each buffer
+    size_t capacity;            // number of values a buffer holds, a multiple of a record
+    int current;                // buffer being filled
+    int pending;                // buffer being written, or -1
+    int stopping;
+    int failed;                 // set by the background thread when a write fails
+    int32_t *prev;              // positions and velocities of the previous record (OUTPUT_DELTA)
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t changed;
+};
+
+// Body of the background thread: write every submitted buffer to the file
+void *traj_writer_loop(void *arg) {
+    struct trajWriter *tw = (struct trajWriter *) arg;
+    pthread_mutex_lock(&tw->mutex);
+    while(1) {
+        while(tw->pending < 0 && !tw->stopping)
+            pthread_cond_wait(&tw->changed, &tw->mutex);
+        if(tw->pending < 0)
+            break;
+        int b = tw->pending;
+        pthread_mutex_unlock(&tw->mutex);
+        int written = fwrite(tw->buffers[b], sizeof(int32_t), tw->fill[b], tw->fp) == tw->fill[b];
+        pthread_mutex_lock(&tw->mutex);
+        if(!written)
+            tw->failed = 1;
+        tw->pending = -1;
+        pthread_cond_broadcast(&tw->changed);
+    }
+    pthread_mutex_unlock(&tw->mutex);
+    return NULL;
 }
 
-// Multiplication requires a shift to the right by FRAC_BITS
-int32_t fp_mul(int32_t a, int32_t b) {
-    return (int32_t)(((long long)a * (long long)b) >> FRAC_BITS);
+// Hand the buffer being filled to the background thread, once it is done with the other one
+void traj_submit(struct trajWriter *tw) {
+    if(tw->fill[tw->current] == 0)
+        return;
+    pthread_mutex_lock(&tw->mutex);
+    while(tw->pending >= 0)
+        pthread_cond_wait(&tw->changed, &tw->mutex);
+    tw->pending = tw->current;
+    pthread_cond_broadcast(&tw->changed);
+    pthread_mutex_unlock(&tw->mutex);
+    tw->current ^= 1;
+    tw->fill[tw->current] = 0;
 }
 
-// Division requires a shift to the left by FRAC_BITS
-int32_t fp_div(int32_t a, int32_t b) {
-    return (int32_t)((((long long)a) << FRAC_BITS) / (long long)b);
+// Create the output file, write its header and start the background thread
+void init_output(struct trajWriter *tw, const struct pso_fp *pso, int n_iterations, double b_lo, double b_up) {
+    size_t record_values = 2 + pso->dims + 2 * (size_t)pso->dims * pso->n_particles;
+    struct trajHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "PSOTRAJ", 8);
+    header.version = 1;
+    header.header_size = sizeof(header);
+    header.dimensions = pso->dims;
+    header.n_particles = pso->n_particles;
+    header.n_iterations = n_iterations;
+    header.interval = OUTPUT_INTERVAL;
+    header.encoding = 1;
+    header.frac_bits = FRAC_BITS;
+    #ifdef OUTPUT_DELTA
+    header.flags = 1;
+    #endif
+    header.record_size = record_values * sizeof(int32_t);
+    header.b_lo = b_lo;
+    header.b_up = b_up;
+    strncpy(header.function, pso->function->name, sizeof(header.function) - 1);
+
+    tw->fp = fopen(OUTPUT_FILE, "wb");
+    if(tw->fp == NULL)
+        die("Error opening file " OUTPUT_FILE "\n");
+    if(fwrite(&header, sizeof(header), 1, tw->fp) != 1)
+        die("Error writing file " OUTPUT_FILE "\n");
+
+    tw->capacity = OUTPUT_BUFFER_SIZE / header.record_size;
+    if(tw->capacity == 0)
+        tw->capacity = 1;
+    tw->capacity *= record_values;
+    tw->buffers[0] = (int32_t *) malloc(2 * tw->capacity * sizeof(int32_t));
+    tw->prev = (int32_t *) calloc(2 * (size_t)pso->dims * pso->n_particles, sizeof(int32_t));
+    if(tw->buffers[0] == NULL || tw->prev == NULL)
+        die("Error allocating memory");
+    tw->buffers[1] = tw->buffers[0] + tw->capacity;
+    tw->fill[0] = tw->fill[1] = 0;
+    tw->current = 0;
+    tw->pending = -1;
+    tw->stopping = 0;
+    tw->failed = 0;
+    pthread_mutex_init(&tw->mutex, NULL);
+    pthread_cond_init(&tw->changed, NULL);
+    if(pthread_create(&tw->thread, NULL, traj_writer_loop, tw) != 0)
+        die("Error starting the output thread");
 }
 
-// Generate a random fixed point number between v_lo and v_up
-int32_t fp_rnd(int32_t v_lo, int32_t v_up) {
-    // Generate a random number between 0 and 1
-    double random_double = (double)rand() / (double)RAND_MAX;
-    // Scale the random number to fit within the desired range [v_lo, v_up)
-    int32_t random_fixed_point = fp_from_double(random_double) * ((v_up - v_lo) >> FRAC_BITS) + v_lo;
-    return random_fixed_point;
+// Store a position or velocity coordinate into the record, as a difference if OUTPUT_DELTA
+void traj_put(int32_t *out, int32_t *prev, int32_t value) {
+    #ifdef OUTPUT_DELTA
+    *out = (int32_t)((uint32_t)value - (uint32_t)*prev);
+    *prev = value;
+    #else
+    *out = value;
+    #endif
 }
 
-// Cost function 1 (given)
-int32_t cost_func_1(int32_t x, int32_t y) {
-    int32_t z;
-    z = fp_mul(x,x) + fp_mul(y,y);
-    return z;
+// Append the state of the swarm to the output file
+void write_state(struct trajWriter *tw, const struct pso_fp *pso) {
+    size_t values = (size_t)pso->dims * pso->n_particles;
+    size_t record_values = 2 + pso->dims + 2 * values;
+    if(tw->fill[tw->current] + record_values > tw->capacity)
+        traj_submit(tw);
+    int32_t *out = tw->buffers[tw->current] + tw->fill[tw->current];
+    uint32_t iteration = pso->iter;
+    memcpy(out, &iteration, sizeof(iteration));
+    out[1] = pso->swarm_best_score;
+    memcpy(out + 2, pso->swarm_best_pos, pso->dims * sizeof(int32_t));
+    out += 2 + pso->dims;
+    // Positions dimension after dimension, then velocities, as they are stored in the swarm
+    for(size_t k = 0; k < values; ++k)
+        traj_put(out + k, tw->prev + k, pso->pos[k]);
+    for(size_t k = 0; k < values; ++k)
+        traj_put(out + values + k, tw->prev + values + k, pso->vel[k]);
+    tw->fill[tw->current] += record_values;
 }
 
-// Cost function 2 (given)
-int32_t cost_func_2(int32_t x, int32_t y) {
-    int32_t z;
-    z = fp_mul(17039, (fp_mul(x,x) + fp_mul(y,y))) - fp_mul(31457, fp_mul(x,y));
-    return z;
+// Write the buffered records, stop the background thread and close the output file; exit with an
+// error if a record could not be written
+void close_output(struct trajWriter *tw) {
+    traj_submit(tw);
+    pthread_mutex_lock(&tw->mutex);
+    tw->stopping = 1;
+    pthread_cond_broadcast(&tw->changed);
+    pthread_mutex_unlock(&tw->mutex);
+    pthread_join(tw->thread, NULL);
+    pthread_mutex_destroy(&tw->mutex);
+    pthread_cond_destroy(&tw->changed);
+    int closed = fclose(tw->fp) == 0;
+    free(tw->buffers[0]);
+    free(tw->prev);
+    if(tw->failed || !closed)
+        die("Error writing file " OUTPUT_FILE "\n");
 }
 
-// Struct for the swarm
-struct psoSwarm {
-    int32_t best_pos[2];
-    int32_t best_score;
-};
 
-// Struct for the particles
-struct psoParticle {
-    int32_t pos[2];
-    int32_t vel[2];
-    int32_t best_pos[2];
-    int32_t best_score;
+// Options of the per-iteration callback
+struct progress {
+    int n_iterations;
+    #ifdef OUTPUT
+    struct trajWriter *tw;
+    #endif
 };
 
-// Initialize the output file
-FILE *init_output() {
-    FILE *fp = fopen("output.txt", "w");
-    if(fp == NULL)
-        die("Error opening file output.txt\n");
-    return fp;
-}
+// Called after every iteration: print the progress and write the trajectory
+void on_iteration(const struct pso_fp *pso, void *user) {
+    struct progress *progress = (struct progress *) user;
+    (void) progress;
 
-// Write the state of the swarm to the output file
-void write_state(FILE *fp, int iter, struct psoSwarm swarm, struct psoParticle *particles, int n_particles) {
-    for(int i = 0; i < n_particles; ++i) {
-        fprintf(fp, "%d\t%d\t%6.4f\t%6.4f\t%6.4f\t%6.4f\n",
-            iter,
-            i,
-            fp_to_double(particles[i].pos[0]),
-            fp_to_double(particles[i].pos[1]),
-            fp_to_double(particles[i].vel[0]),
-            fp_to_double(particles[i].vel[1])
-        );
-    }
-    fprintf(fp, "%d\t%d\t%f\t%f\t%f\t%f\n",
-        iter,
-        -1,
-        fp_to_double(swarm.best_pos[0]),
-        fp_to_double(swarm.best_pos[1]),
-        0.0,
-        0.0
-    );
-    fprintf(fp, "%d\t%d\t%f\t%f\t%f\t%f\n",
-        iter,
-        -2,
-        fp_to_double(swarm.best_score),
-        0.0, 0.0, 0.0
-    );
-    return;
-}
+    #ifdef VERBOSE
+    if((pso->iter - 1) % VERBOSE_INTERVAL == 0)
+        printf("Iteration %d: %10.6f\n", pso->iter - 1, fp_to_double(pso->swarm_best_score));
+    #endif
 
+    // Print output for visualization
+    #ifdef OUTPUT
+    if((pso->iter % OUTPUT_INTERVAL == 0) || (pso->iter == progress->n_iterations))
+        write_state(progress->tw, pso);
+    #endif
+}
 
 int main(int argc, char *argv[]) {
 
-    // Set seed for random number generator (for reproducibility)
-    srand(42);
-
     /////////////////////////////////////////////////
     // Set Parameters
     /////////////////////////////////////////////////
 
-    #ifdef DEBUG
     int n_particles = 100;
     int n_iterations = 100;
     double b_lo = -5.0;
     double b_up = 5.0;
+    const char *function = FUNCTION;
+    int dims = DIMENSIONS;
+    #ifdef DEBUG
+    if(argc != 1 && (argc < 5 || argc > 7)) {
     #else
-    if(argc != 5) {
+    if(argc < 5 || argc > 7) {
+    #endif
         printf("Usage:\n");
-        printf("%s <n_particles> <n_iterations> <domain_lower_bound> <domain_upper_bound>\n", argv[0]);
+        printf("%s <n_particles> <n_iterations> <domain_lower_bound> <domain_upper_bound> [<function> [<dimensions>]]\n", argv[0]);
+        return 1;
+    }
+    if(argc >= 5) {
+        n_particles = atoi(argv[1]);
+        n_iterations = atoi(argv[2]);
+        b_lo = atof(argv[3]);
+        b_up = atof(argv[4]);
+    }
+    if(argc >= 6)
+        function = argv[5];
+    if(argc >= 7)
+        dims = atoi(argv[6]);
+
+    struct pso_fp_params params;
+    params.n_particles = n_particles;
+    params.dims = dims;
+    params.b_lo = b_lo;
+    params.b_up = b_up;
+    params.w = W;
+    params.phi_p = PHI_P;
+    params.phi_g = PHI_G;
+    params.seed = SEED;
+    params.function = pso_fp_find_function(function);
+    params.boundary = BOUNDARY;
+    params.v_max = V_MAX;
+    if(params.function == NULL) {
+        printf("Unknown function %s, choose one of:", function);
+        for(const struct pso_fp_function *f = pso_fp_functions; f->name != NULL; ++f)
+            printf(" %s", f->name);
+        printf("\n");
         return 1;
     }
-
-    int n_particles = atoi(argv[1]);
-    int n_iterations = atoi(argv[2]);
-    double b_lo = atof(argv[3]);
-    double b_up = atof(argv[4]);
-    #endif
 
     // Convert the parameters to fixed point
     int32_t fp_n_particles = fp_from_double(n_particles);
     int32_t fp_n_iterations = fp_from_double(n_iterations);
     int32_t fp_b_lo = fp_from_double(b_lo);
     int32_t fp_b_up = fp_from_double(b_up);
-
-    int32_t fp_w = fp_from_double(W);
-    int32_t fp_phi_p = fp_from_double(PHI_P);
-    int32_t fp_phi_g = fp_from_double(PHI_G);
+    int32_t fp_v_max = fp_from_double(params.v_max);
 
     // Output the parameters
     printf("+-----------------------------------------+\n");
@@ -179,60 +315,31 @@ int main(int argc, char *argv[]) {
     printf("|  n_iterations: %10.d | %10.f  |\n", fp_n_iterations, fp_to_double(fp_n_iterations));
     printf("|  b_lo:         %10.d |%11.2f  |\n", fp_b_lo, fp_to_double(fp_b_lo));
     printf("|  b_up:         %10.d |%11.2f  |\n", fp_b_up, fp_to_double(fp_b_up));
+    printf("|  v_max:        %10.d |%11.2f  |\n", fp_v_max, fp_to_double(fp_v_max));
+    printf("|  boundary:     %10d |             |\n", params.boundary);
+    printf("|  function:     %10s | %10d  |\n", params.function->name, dims);
     printf("+-----------------------------------------+\n\n");
 
     /////////////////////////////////////////////////
-    // Setup swarm and particles
+    // Setup the swarm and initialize the particles
     /////////////////////////////////////////////////
 
-    // Create the particles
-    struct psoParticle *particles;
-    particles = (struct psoParticle *) calloc(n_particles, sizeof(struct psoParticle));
-    if(particles == NULL) {
-        printf("Error allocating memory\n");
-        return 1;
-    }
-
-    // Create the swarm
-    struct psoSwarm swarm;
-    for(int i = 0; i < 2; ++i) {
-        swarm.best_pos[i] = b_lo;
-    }
-    swarm.best_score = INT_MAX;
+    struct pso_fp pso;
+    int status = pso_fp_init(&pso, &params);
+    if(status == PSO_FP_EINVAL)
+        die("Invalid parameters");
+    if(status == PSO_FP_ENOMEM)
+        die("Error allocating memory");
 
-
-    /////////////////////////////////////////////////
-    // Initialize the particles 
-    /////////////////////////////////////////////////
-
-    int32_t fp_vel_lo = fp_b_lo - fp_b_up;  // velocity lower bound
-    int32_t fp_vel_up = - fp_vel_lo;        // velocity upper bound
-
-    for(int i = 0; i < n_particles; ++i) {
-        // Initialize the particle's position with a uniformly distributed random vector
-        particles[i].pos[0] = fp_rnd(fp_b_lo, fp_b_up);
-        particles[i].pos[1] = fp_rnd(fp_b_lo, fp_b_up);
-        // Initialize the particle's best known position to its initial position
-        particles[i].best_pos[0] = particles[i].pos[0];
-        particles[i].best_pos[1] = particles[i].pos[1];
-        // Calculate the particle's current score (which is also the best known score for now)
-        particles[i].best_score = FUNCTION(particles[i].pos[0], particles[i].pos[1]);
-        if(particles[i].best_score < swarm.best_score) {
-            // Update the swarm's best known position
-            swarm.best_pos[0] = particles[i].best_pos[0];
-            swarm.best_pos[1] = particles[i].best_pos[1];
-            swarm.best_score = particles[i].best_score;
-        }
-        // Initialize the particle's velocity: vi ~ U(-|bup-blo|, |bup-blo|)
-        particles[i].vel[0] = fp_rnd(fp_vel_lo, fp_vel_up);
-        particles[i].vel[1] = fp_rnd(fp_vel_lo, fp_vel_up);
-    }
+    struct progress progress;
+    progress.n_iterations = n_iterations;
 
     // Print output for visualization
     #ifdef OUTPUT
-    FILE *fp = init_output();
-    fprintf(fp, "-1\t%d\t%d\t%d\t%f\t%f\n", FUNCTION == cost_func_1 ? 1 : 2, n_particles, n_iterations, b_lo, b_up);
-    write_state(fp, 0, swarm, particles, n_particles);
+    struct trajWriter tw;
+    init_output(&tw, &pso, n_iterations, b_lo, b_up);
+    write_state(&tw, &pso);
+    progress.tw = &tw;
     #endif
 
     #ifdef VERBOSE
@@ -243,70 +350,31 @@ int main(int argc, char *argv[]) {
     // Run the Optimization Routine
     /////////////////////////////////////////////////
 
-    for(int iter= 0; iter < n_iterations; ++iter) {
-        for(int i = 0; i < n_particles; ++i) {
-            // Pick random numbers: rp, rg ~ U(0,1)
-            int32_t rp = fp_from_double( ((double)rand() / RAND_MAX) );
-            int32_t rg = fp_from_double( ((double)rand() / RAND_MAX) );
-            // Update the particle's velocity: vi,d ← w vi,d + φp rp (pi,d-xi,d) + φg rg (gd-xi,d)
-            particles[i].vel[0] =   fp_mul( fp_w, particles[i].vel[0] ) + 
-                                    fp_mul( fp_mul(fp_phi_p, rp), (particles[i].best_pos[0] - particles[i].pos[0]) ) +
-                                    fp_mul( fp_mul(fp_phi_g, rg), (swarm.best_pos[0] - particles[i].pos[0]) );
-            // Pick random numbers: rp, rg ~ U(0,1)
-            rp = fp_from_double( ((double)rand() / RAND_MAX) );
-            rg = fp_from_double( ((double)rand() / RAND_MAX) );
-            // Update the particle's velocity: vi,d ← w vi,d + φp rp (pi,d-xi,d) + φg rg (gd-xi,d)
-            particles[i].vel[1] =   fp_mul( fp_w, particles[i].vel[1] ) + 
-                                    fp_mul( fp_mul(fp_phi_p, rp), (particles[i].best_pos[1] - particles[i].pos[1]) ) +
-                                    fp_mul( fp_mul(fp_phi_g, rg), (swarm.best_pos[1] - particles[i].pos[1]) );
-            // Update the particle's position: xi ← xi + vi
-            particles[i].pos[0] += particles[i].vel[0];
-            particles[i].pos[1] += particles[i].vel[1];
-            // if f(xi) < f(pi) then
-            int32_t new_score = FUNCTION(particles[i].pos[0], particles[i].pos[1]);
-            if(new_score < particles[i].best_score) {
-                // Update the particle's best known position: pi ← xi
-                particles[i].best_pos[0] = particles[i].pos[0];
-                particles[i].best_pos[1] = particles[i].pos[1];
-                particles[i].best_score = new_score;
-                // if f(pi) < f(g) then
-                if(new_score < swarm.best_score) {
-                    // Update the swarm's best known position: g ← pi
-                    swarm.best_pos[0] = particles[i].best_pos[0];
-                    swarm.best_pos[1] = particles[i].best_pos[1];
-                    swarm.best_score = new_score;
-                }
-            }
-        }
-
-        #ifdef VERBOSE
-        if(iter % VERBOSE_INTERVAL == 0)
-            printf("Iteration %d: %10.6f\n", iter, fp_to_double(swarm.best_score));
-        #endif
-
-        // Print output for visualization
-        #ifdef OUTPUT
-        if( (iter != 0) && (iter % OUTPUT_INTERVAL == 0) )
-            write_state(fp, iter, swarm, particles, n_particles);
-        #endif
-    }
+    if(status == PSO_FP_OK)
+        status = pso_fp_run(&pso, n_iterations, on_iteration, &progress);
+
+    #ifdef OUTPUT
+    close_output(&tw);
+    #endif
 
+    if(status == PSO_FP_OVERFLOW) {
+        printf("%llu fixed point overflows in iteration %d\n", (unsigned long long)fp_overflows, pso.iter > 0 ? pso.iter - 1 : 0);
+        die("Stopped by an overflow");
+    }
 
     /////////////////////////////////////////////////
     // Print Results
     /////////////////////////////////////////////////
 
     fprintf(stdout, "\n             Fixed Point: | Double:\n");
-    fprintf(stdout, " Best score:   %10d | %10.6f\n", swarm.best_score, fp_to_double(swarm.best_score));
+    fprintf(stdout, " Best score:   %10d | %10.6f\n", pso.swarm_best_score, fp_to_double(pso.swarm_best_score));
     fprintf(stdout, " Best position:\n");
-    fprintf(stdout, "               %10d | %10.6f\n", swarm.best_pos[0], fp_to_double(swarm.best_pos[0]));
-    fprintf(stdout, "               %10d | %10.6f\n", swarm.best_pos[1], fp_to_double(swarm.best_pos[1]));
+    for(int d = 0; d < dims; ++d)
+        fprintf(stdout, "               %10d | %10.6f\n", pso.swarm_best_pos[d], fp_to_double(pso.swarm_best_pos[d]));
+    fprintf(stdout, " Overflows:    %10llu\n", (unsigned long long)fp_overflows);
     fprintf(stdout, "\n");
 
-    free(particles);
-    #ifdef OUTPUT
-    fclose(fp);
-    #endif
+    pso_fp_free(&pso);
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,292 @@
+#include "pso_fp.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+uint64_t fp_overflows = 0;
+
+// Encrypt the counter ctr with Philox4x32-10 under the key (key0, key1)
+static void philox4x32(uint32_t ctr[4], uint32_t key0, uint32_t key1) {
+    for(int r = 0; r < 10; ++r) {
+        uint64_t p0 = (uint64_t)0xD2511F53 * ctr[0];
+        uint64_t p1 = (uint64_t)0xCD9E8D57 * ctr[2];
+        uint32_t c1 = ctr[1];
+        uint32_t c3 = ctr[3];
+        ctr[0] = (uint32_t)(p1 >> 32) ^ c1 ^ key0;
+        ctr[1] = (uint32_t)p1;
+        ctr[2] = (uint32_t)(p0 >> 32) ^ c3 ^ key1;
+        ctr[3] = (uint32_t)p0;
+        key0 += 0x9E3779B9;
+        key1 += 0xBB67AE85;
+    }
+}
+
+// Convert 32 random bits to a fixed point number uniformly distributed in [0, 1)
+static int32_t fp_from_bits(uint32_t bits) {
+    return (int32_t)(bits >> (32 - FRAC_BITS));
+}
+
+// Generate two random fixed point numbers in [0, 1) for each particle along a dimension
+static void fp_rnd_fill(const struct pso_fp *pso, uint32_t iter, uint32_t dim, uint32_t stream) {
+    for(int i = 0; i < pso->n_particles; ++i) {
+        uint32_t ctr[4] = {(uint32_t)i, dim, iter, stream};
+        philox4x32(ctr, pso->key0, pso->key1);
+        pso->rnd_a[i] = fp_from_bits(ctr[0]);
+        pso->rnd_b[i] = fp_from_bits(ctr[2]);
+    }
+}
+
+// Scale a random fixed point number r in [0, 1) to [v_lo, v_up)
+static int32_t fp_rnd(int32_t r, int32_t v_lo, int32_t v_up) {
+    return fp_add(v_lo, fp_mul(r, fp_sub(v_up, v_lo)));
+}
+
+// Smallest and largest of two exact results
+static inline int64_t fp_min64(int64_t a, int64_t b) {
+    return a < b ? a : b;
+}
+
+static inline int64_t fp_max64(int64_t a, int64_t b) {
+    return a > b ? a : b;
+}
+
+// Bring back into the domain the coordinates x of the particles along the dimension d, whose
+// velocities are v, according to the boundary policy. The policy is selected once, and every loop
+// only uses min, max and selections, so that it has no branch and is vectorized by the compiler.
+// Reflections and wraps move a coordinate by at most the width of the domain, which is exact as
+// long as the velocities are at most that wide; coordinates farther away are then clamped.
+static void enforce_bounds(const struct pso_fp *pso, int d, int32_t *x, int32_t *v) {
+    int n = pso->n_particles;
+    int64_t lo = pso->b_lo;
+    int64_t hi = pso->b_up;
+    int64_t width = hi - lo;
+    switch(pso->boundary) {
+    case BOUNDARY_CLAMP:
+        for(int i = 0; i < n; ++i)
+            x[i] = (int32_t)fp_min64(fp_max64(x[i], lo), hi);
+        break;
+    case BOUNDARY_ABSORB:
+        for(int i = 0; i < n; ++i) {
+            int64_t clamped = fp_min64(fp_max64(x[i], lo), hi);
+            v[i] = clamped == x[i] ? v[i] : 0;
+            x[i] = (int32_t)clamped;
+        }
+        break;
+    case BOUNDARY_REFLECT:
+        for(int i = 0; i < n; ++i) {
+            int64_t xi = fp_min64(fp_max64(x[i], lo - width), hi + width);
+            // Mirroring on a bound only moves the coordinates beyond it
+            int64_t from_up = fp_min64(xi, hi + hi - xi);
+            int64_t from_lo = fp_max64(from_up, lo + lo - from_up);
+            x[i] = (int32_t)fp_min64(fp_max64(from_lo, lo), hi);
+            v[i] = (xi < lo) | (xi > hi) ? (int32_t)fp_min64(-(int64_t)v[i], INT32_MAX) : v[i];
+        }
+        break;
+    case BOUNDARY_WRAP:
+        for(int i = 0; i < n; ++i) {
+            int64_t xi = fp_min64(fp_max64(x[i], lo - width), hi + width);
+            int64_t wrapped = xi + (xi < lo ? width : 0) - (xi > hi ? width : 0);
+            x[i] = (int32_t)fp_min64(fp_max64(wrapped, lo), hi);
+        }
+        break;
+    case BOUNDARY_REINIT:
+        // The coordinates are drawn for all the particles, and only kept for those outside
+        fp_rnd_fill(pso, pso->iter, d, STREAM_BOUNDARY);
+        for(int i = 0; i < n; ++i) {
+            int32_t fresh = fp_rnd(pso->rnd_a[i], pso->b_lo, pso->b_up);
+            x[i] = (x[i] < pso->b_lo) | (x[i] > pso->b_up) ? fresh : x[i];
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+// Cost function 1 (given): sum of the squares of the coordinates
+static void cost_func_1(const int32_t *pos, int n_particles, int dims, int32_t *scores) {
+    memset(scores, 0, n_particles * sizeof(int32_t));
+    for(int d = 0; d < dims; ++d) {
+        const int32_t *x = pos + (size_t)d * n_particles;
+        for(int i = 0; i < n_particles; ++i)
+            scores[i] = fp_add(scores[i], fp_mul(x[i], x[i]));
+    }
+}
+
+// Cost function 2 (given), in 2 dimensions
+static void cost_func_2(const int32_t *pos, int n_particles, int dims, int32_t *scores) {
+    const int32_t *x = pos;
+    const int32_t *y = pos + n_particles;
+    for(int i = 0; i < n_particles; ++i)
+        scores[i] = fp_sub(fp_mul(fp_from_double(0.26), fp_add(fp_mul(x[i], x[i]), fp_mul(y[i], y[i]))),
+                           fp_mul(fp_from_double(0.48), fp_mul(x[i], y[i])));
+}
+
+// Rosenbrock function: sum of 100 (x[d+1] - x[d]^2)^2 + (1 - x[d])^2
+static void cost_rosenbrock(const int32_t *pos, int n_particles, int dims, int32_t *scores) {
+    const int32_t one = fp_from_double(1.0);
+    const int32_t hundred = fp_from_double(100.0);
+    memset(scores, 0, n_particles * sizeof(int32_t));
+    for(int d = 0; d + 1 < dims; ++d) {
+        const int32_t *x = pos + (size_t)d * n_particles;
+        const int32_t *x1 = x + n_particles;
+        for(int i = 0; i < n_particles; ++i) {
+            int32_t a = fp_sub(x1[i], fp_mul(x[i], x[i]));
+            int32_t b = fp_sub(one, x[i]);
+            scores[i] = fp_add(scores[i], fp_add(fp_mul(hundred, fp_mul(a, a)), fp_mul(b, b)));
+        }
+    }
+}
+
+const struct pso_fp_function pso_fp_functions[] = {
+    {"f1", cost_func_1, 0},
+    {"f2", cost_func_2, 2},
+    {"rosenbrock", cost_rosenbrock, 0},
+    {NULL, NULL, 0},
+};
+
+const struct pso_fp_function *pso_fp_find_function(const char *name) {
+    for(const struct pso_fp_function *f = pso_fp_functions; f->name != NULL; ++f)
+        if(strcmp(f->name, name) == 0)
+            return f;
+    return NULL;
+}
+
+// Status of an optimization after fp_overflows was updated
+static int pso_fp_status(void) {
+    #if OVERFLOW_POLICY == OVERFLOW_TRAP
+    if(fp_overflows > 0)
+        return PSO_FP_OVERFLOW;
+    #endif
+    return PSO_FP_OK;
+}
+
+// Update the personal bests with the current scores, and the best of the swarm with them.
+// Visiting the particles in order keeps the first one on ties.
+static void update_bests(struct pso_fp *pso) {
+    int n = pso->n_particles;
+    for(int i = 0; i < n; ++i) {
+        if(pso->score[i] >= pso->best_score[i])
+            continue;
+        pso->best_score[i] = pso->score[i];
+        for(int d = 0; d < pso->dims; ++d)
+            pso->best_pos[(size_t)d * n + i] = pso->pos[(size_t)d * n + i];
+        if(pso->score[i] < pso->swarm_best_score) {
+            pso->swarm_best_score = pso->score[i];
+            for(int d = 0; d < pso->dims; ++d)
+                pso->swarm_best_pos[d] = pso->pos[(size_t)d * n + i];
+        }
+    }
+}
+
+int pso_fp_init(struct pso_fp *pso, const struct pso_fp_params *params) {
+    int n = params->n_particles;
+    int dims = params->dims;
+    if(n <= 0 || dims <= 0 || params->function == NULL || params->b_lo >= params->b_up)
+        return PSO_FP_EINVAL;
+    if(params->boundary < BOUNDARY_NONE || params->boundary > BOUNDARY_ABSORB || params->v_max < 0)
+        return PSO_FP_EINVAL;
+    if(params->function->dims != 0 && params->function->dims != dims)
+        return PSO_FP_EINVAL;
+    // Three buffers of n * dims coordinates, four of n values and the best position of the swarm
+    size_t values = (3 * (size_t)dims + 4) * (size_t)n + (size_t)dims;
+    if(values > SIZE_MAX / sizeof(int32_t))
+        return PSO_FP_ENOMEM;
+    int32_t *memory = (int32_t *) malloc(values * sizeof(int32_t));
+    if(memory == NULL)
+        return PSO_FP_ENOMEM;
+
+    pso->n_particles = n;
+    pso->dims = dims;
+    pso->iter = 0;
+    pso->b_lo = fp_from_double(params->b_lo);
+    pso->b_up = fp_from_double(params->b_up);
+    pso->w = fp_from_double(params->w);
+    pso->phi_p = fp_from_double(params->phi_p);
+    pso->phi_g = fp_from_double(params->phi_g);
+    pso->key0 = (uint32_t)params->seed;
+    pso->key1 = (uint32_t)(params->seed >> 32);
+    pso->function = params->function;
+    pso->boundary = params->boundary;
+    pso->v_max = fp_from_double(params->v_max);
+    pso->pos = memory;
+    pso->vel = pso->pos + (size_t)n * dims;
+    pso->best_pos = pso->vel + (size_t)n * dims;
+    pso->score = pso->best_pos + (size_t)n * dims;
+    pso->best_score = pso->score + n;
+    pso->rnd_a = pso->best_score + n;
+    pso->rnd_b = pso->rnd_a + n;
+    pso->swarm_best_pos = pso->rnd_b + n;
+    for(int d = 0; d < dims; ++d)
+        pso->swarm_best_pos[d] = pso->b_lo;
+    pso->swarm_best_score = INT32_MAX;
+
+    int32_t vel_lo = fp_sub(pso->b_lo, pso->b_up);  // velocity lower bound
+    int32_t vel_up = fp_sub(0, vel_lo);             // velocity upper bound
+    for(int d = 0; d < dims; ++d) {
+        // Pick random numbers for the positions (rnd_a) and the velocities (rnd_b)
+        fp_rnd_fill(pso, 0, d, STREAM_INIT);
+        int32_t *x = pso->pos + (size_t)d * n;
+        int32_t *v = pso->vel + (size_t)d * n;
+        for(int i = 0; i < n; ++i) {
+            // Initialize the particle's position with a uniformly distributed random vector
+            x[i] = fp_rnd(pso->rnd_a[i], pso->b_lo, pso->b_up);
+            // Initialize the particle's velocity: vi ~ U(-|bup-blo|, |bup-blo|)
+            v[i] = fp_rnd(pso->rnd_b[i], vel_lo, vel_up);
+        }
+    }
+    // The personal bests are the initial positions and scores
+    memcpy(pso->best_pos, pso->pos, (size_t)n * dims * sizeof(int32_t));
+    pso->function->cost(pso->pos, n, dims, pso->score);
+    for(int i = 0; i < n; ++i)
+        pso->best_score[i] = INT32_MAX;
+    update_bests(pso);
+    return pso_fp_status();
+}
+
+int pso_fp_step(struct pso_fp *pso) {
+    int n = pso->n_particles;
+    // Velocities are clamped to [vel_lo, vel_up], the whole range of int32_t without v_max
+    int32_t vel_up = pso->v_max > 0 ? pso->v_max : INT32_MAX;
+    int32_t vel_lo = pso->v_max > 0 ? -pso->v_max : INT32_MIN;
+    for(int d = 0; d < pso->dims; ++d) {
+        // Pick random numbers for all the particles: rp (rnd_a), rg (rnd_b) ~ U(0,1)
+        fp_rnd_fill(pso, pso->iter, d, STREAM_UPDATE);
+        int32_t *x = pso->pos + (size_t)d * n;
+        int32_t *v = pso->vel + (size_t)d * n;
+        const int32_t *p = pso->best_pos + (size_t)d * n;
+        int32_t g = pso->swarm_best_pos[d];
+        for(int i = 0; i < n; ++i) {
+            // Update the particle's velocity: vi,d ← w vi,d + φp rp (pi,d-xi,d) + φg rg (gd-xi,d)
+            int32_t vi = fp_add( fp_add( fp_mul( pso->w, v[i] ),
+                         fp_mul( fp_mul(pso->phi_p, pso->rnd_a[i]), fp_sub(p[i], x[i]) ) ),
+                         fp_mul( fp_mul(pso->phi_g, pso->rnd_b[i]), fp_sub(g, x[i]) ) );
+            // Clamp it: -v_max <= vi,d <= v_max
+            v[i] = vi < vel_lo ? vel_lo : (vi > vel_up ? vel_up : vi);
+            // Update the particle's position: xi ← xi + vi
+            x[i] = fp_add(x[i], v[i]);
+        }
+        // Bring the particles that left the domain back into it
+        enforce_bounds(pso, d, x, v);
+    }
+    // if f(xi) < f(pi) then pi ← xi, and if f(pi) < f(g) then g ← pi
+    pso->function->cost(pso->pos, n, pso->dims, pso->score);
+    update_bests(pso);
+    ++pso->iter;
+    return pso_fp_status();
+}
+
+int pso_fp_run(struct pso_fp *pso, int n_iterations, pso_fp_callback callback, void *user) {
+    for(int k = 0; k < n_iterations; ++k) {
+        int status = pso_fp_step(pso);
+        if(callback != NULL)
+            callback(pso, user);
+        if(status != PSO_FP_OK)
+            return status;
+    }
+    return PSO_FP_OK;
+}
+
+void pso_fp_free(struct pso_fp *pso) {
+    free(pso->pos);
+    pso->pos = NULL;
+}
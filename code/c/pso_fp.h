@@ -0,0 +1,196 @@
+#ifndef PSO_FP_H
+#define PSO_FP_H
+
+// Fixed point Particle Swarm Optimization library: the optimizer of main_fixedpoint.c, for any
+// number of particles and dimensions and any cost function, chosen at runtime. It only uses
+// integer operations and a single allocation per swarm, and does no I/O, so that it can be
+// cross-compiled for targets without a floating point unit nor an operating system.
+
+#include <stdint.h>
+
+///// FIXED POINT //////
+// We're using s15.16 fixed point numbers by default:
+// 1 bit for the sign
+// 15 bits for the integer part
+// 16 bits for the fractional part
+// Another split of the 32 bits can be chosen with -DFRAC_BITS=<n>, e.g. 24 for s7.24 numbers
+// when the positions and the scores stay below 128, or 8 for s23.8 numbers when they get large.
+#ifndef FRAC_BITS
+#define FRAC_BITS 16
+#endif
+
+///// OVERFLOW //////
+// What the fixed point operations do when their exact result does not fit in 32 bits:
+// OVERFLOW_WRAP keeps its low 32 bits, OVERFLOW_SATURATE clamps it to the closest representable
+// number, OVERFLOW_TRAP keeps its low 32 bits but stops the optimization at the end of the
+// iteration in which the first overflow happened. Overflows are counted in fp_overflows.
+// Another policy can be chosen with -DOVERFLOW_POLICY=<n>.
+#define OVERFLOW_WRAP 0
+#define OVERFLOW_SATURATE 1
+#define OVERFLOW_TRAP 2
+#ifndef OVERFLOW_POLICY
+#define OVERFLOW_POLICY OVERFLOW_SATURATE
+#endif
+
+///// RANDOM NUMBERS //////
+// Counter-based generator (Philox4x32-10), as in the C++ version: the random numbers of a
+// particle along a dimension at an iteration only depend on the seed and on
+// (particle, dimension, iteration, stream), and are generated with integer operations only.
+#define STREAM_INIT 0
+#define STREAM_UPDATE 1
+#define STREAM_BOUNDARY 3
+
+///// BOUNDARIES //////
+// What happens to the coordinates of the particles that leave the domain, as in the C++ version
+// (see BoundaryPolicy in code/c++/include/Boundary.hpp): BOUNDARY_CLAMP moves them back to the
+// closest bound, BOUNDARY_REFLECT mirrors them on the bound they crossed and reverses their
+// velocity, BOUNDARY_WRAP makes them re-enter from the opposite bound, BOUNDARY_REINIT draws them
+// again uniformly in the domain, and BOUNDARY_ABSORB moves them back to the closest bound and
+// zeroes their velocity. The policies are applied by branch-free loops of min, max and
+// selections, computed exactly on 64 bits.
+#define BOUNDARY_NONE 0
+#define BOUNDARY_CLAMP 1
+#define BOUNDARY_REFLECT 2
+#define BOUNDARY_WRAP 3
+#define BOUNDARY_REINIT 4
+#define BOUNDARY_ABSORB 5
+
+///// STATUS //////
+// Returned by the functions of the library
+#define PSO_FP_OK 0
+#define PSO_FP_OVERFLOW 1       // an operation overflowed and OVERFLOW_POLICY is OVERFLOW_TRAP
+#define PSO_FP_ENOMEM (-1)      // the swarm could not be allocated
+#define PSO_FP_EINVAL (-2)      // invalid parameters
+
+// Number of fixed point operations that overflowed
+extern uint64_t fp_overflows;
+
+// Convert a double to a fixed point number
+static inline int32_t fp_from_double(double a) {
+    return (int32_t)(a * (1 << FRAC_BITS));
+}
+
+// Convert a fixed point number to a double
+static inline double fp_to_double(int32_t a) {
+    return ((double)a / (1 << FRAC_BITS));
+}
+
+// Convert the exact result of an operation to a fixed point number, applying OVERFLOW_POLICY
+static inline int32_t fp_narrow(int64_t a) {
+    #if OVERFLOW_POLICY != OVERFLOW_WRAP
+    if(a > INT32_MAX || a < INT32_MIN) {
+        ++fp_overflows;
+        #if OVERFLOW_POLICY == OVERFLOW_SATURATE
+        return a > 0 ? INT32_MAX : INT32_MIN;
+        #endif
+    }
+    #endif
+    return (int32_t)a;
+}
+
+// Addition and subtraction are the integer ones
+static inline int32_t fp_add(int32_t a, int32_t b) {
+    return fp_narrow((int64_t)a + (int64_t)b);
+}
+
+static inline int32_t fp_sub(int32_t a, int32_t b) {
+    return fp_narrow((int64_t)a - (int64_t)b);
+}
+
+// Multiplication requires a shift to the right by FRAC_BITS
+static inline int32_t fp_mul(int32_t a, int32_t b) {
+    return fp_narrow(((int64_t)a * (int64_t)b) >> FRAC_BITS);
+}
+
+// Division requires a shift to the left by FRAC_BITS
+static inline int32_t fp_div(int32_t a, int32_t b) {
+    return fp_narrow((((int64_t)a) << FRAC_BITS) / (int64_t)b);
+}
+
+///// COST FUNCTIONS //////
+// A cost function evaluates all the particles at once: pos holds their coordinates dimension
+// after dimension (the d-th coordinate of the i-th particle is pos[d * n_particles + i]), and
+// the score of the i-th particle is written to scores[i].
+typedef void (*pso_fp_cost)(const int32_t *pos, int n_particles, int dims, int32_t *scores);
+
+// Entry of the table of the cost functions
+struct pso_fp_function {
+    const char *name;           // name the function is selected by, at most 15 characters
+    pso_fp_cost cost;
+    int dims;                   // number of dimensions the function is defined for, 0 if any
+};
+
+// Table of the available cost functions, terminated by an entry whose name is NULL:
+// "f1" (sum of the squares), "f2" (0.26 (x^2 + y^2) - 0.48 x y, 2-D only) and "rosenbrock"
+extern const struct pso_fp_function pso_fp_functions[];
+
+// Find the cost function with the given name in pso_fp_functions, or return NULL
+const struct pso_fp_function *pso_fp_find_function(const char *name);
+
+///// OPTIMIZER //////
+// Parameters of an optimization
+struct pso_fp_params {
+    int n_particles;
+    int dims;
+    double b_lo;                // lower bound of the domain, along every dimension
+    double b_up;                // upper bound of the domain, along every dimension
+    double w;                   // inertia weight
+    double phi_p;               // cognitive coefficient
+    double phi_g;               // social coefficient
+    uint64_t seed;
+    const struct pso_fp_function *function;
+    int boundary;               // boundary policy, BOUNDARY_NONE (0) lets the particles leave
+    double v_max;               // largest absolute velocity along a dimension, 0 if unbounded
+};
+
+// State of an optimization. The coordinates of the particles are stored in flat buffers,
+// dimension after dimension, as the cost functions read them.
+struct pso_fp {
+    int n_particles;
+    int dims;
+    int iter;                   // number of iterations performed so far
+    int32_t b_lo;
+    int32_t b_up;
+    int32_t w;
+    int32_t phi_p;
+    int32_t phi_g;
+    uint32_t key0;              // low half of the seed
+    uint32_t key1;              // high half of the seed
+    const struct pso_fp_function *function;
+    int boundary;
+    int32_t v_max;              // 0 if unbounded
+    int32_t *pos;               // positions, n_particles * dims
+    int32_t *vel;               // velocities, n_particles * dims
+    int32_t *best_pos;          // personal best positions, n_particles * dims
+    int32_t *score;             // scores of the positions, n_particles
+    int32_t *best_score;        // personal best scores, n_particles
+    int32_t *rnd_a;             // random numbers of the dimension being updated, n_particles
+    int32_t *rnd_b;
+    int32_t *swarm_best_pos;    // best position of the swarm, dims
+    int32_t swarm_best_score;
+};
+
+// Called by pso_fp_run() after every iteration, with the user pointer given to it
+typedef void (*pso_fp_callback)(const struct pso_fp *pso, void *user);
+
+// Allocate the swarm described by params and initialize its particles uniformly in the domain,
+// with velocities up to the width of the domain. Returns PSO_FP_OK, PSO_FP_OVERFLOW if the
+// initialization overflowed (the swarm is still usable), PSO_FP_EINVAL if the parameters are
+// invalid or PSO_FP_ENOMEM; unless it returned one of the last two, the swarm must be released
+// with pso_fp_free().
+int pso_fp_init(struct pso_fp *pso, const struct pso_fp_params *params);
+
+// Perform one synchronous iteration: update the velocities (clamped to v_max) and positions
+// (brought back into the domain according to the boundary policy) of all the particles, evaluate
+// them with one call of the cost function, then update the best positions.
+// Returns PSO_FP_OVERFLOW if an operation overflowed so far and OVERFLOW_POLICY is OVERFLOW_TRAP.
+int pso_fp_step(struct pso_fp *pso);
+
+// Perform n_iterations iterations, calling callback (if not NULL) after every one of them.
+// Stops after the iteration in which an overflow trapped, and returns its status.
+int pso_fp_run(struct pso_fp *pso, int n_iterations, pso_fp_callback callback, void *user);
+
+// Release the memory of the swarm
+void pso_fp_free(struct pso_fp *pso);
+
+#endif
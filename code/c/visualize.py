@@ -1,3 +1,6 @@
+import os
+import sys
+
 import numpy as np
 import matplotlib.pyplot as plt
 from matplotlib.animation import FuncAnimation
@@ -12,23 +15,101 @@ def cost_func_2(x, y):
     return 0.26*(x**2 + y**2) - 0.48*x*y
 
 
-info = np.loadtxt('output.txt')
-x = np.linspace(info[0,4], info[0,5], 100)
-y = np.linspace(info[0,4], info[0,5], 100)
+def cost_func_rosenbrock(x, y):
+    return 100*(y - x**2)**2 + (1 - x)**2
+
+
+# Header of a trajectory file, see TrajectoryHeader in code/c++/include/Trajectory.hpp
+HEADER_DTYPE = np.dtype([
+    ('magic', 'S8'),
+    ('version', '<u4'),
+    ('header_size', '<u4'),
+    ('dimensions', '<u4'),
+    ('n_particles', '<u4'),
+    ('n_iterations', '<u4'),
+    ('interval', '<u4'),
+    ('encoding', '<u4'),
+    ('frac_bits', '<u4'),
+    ('flags', '<u4'),
+    ('record_size', '<u4'),
+    ('b_lo', '<f8'),
+    ('b_up', '<f8'),
+    ('function', 'S16'),
+])
+
+ENCODING_FLOAT32 = 0
+ENCODING_FIXED32 = 1
+FLAG_DELTA = 1
+
+
+def read_trajectory(path):
+    """Map the records of a trajectory file without copying them.
+
+    Returns the header and a structured array with one element per recorded iteration, whose fields
+    are 'iteration', 'best_score', 'best_position' (dimensions values), 'positions' and
+    'velocities' (dimensions x n_particles values each). The values are raw: see to_float().
+    """
+    header = np.fromfile(path, dtype=HEADER_DTYPE, count=1)[0]
+    if header['magic'] != b'PSOTRAJ':
+        raise ValueError(path + ' is not a trajectory file')
+    value = '<i4' if header['encoding'] == ENCODING_FIXED32 else '<f4'
+    d, n = int(header['dimensions']), int(header['n_particles'])
+    record_dtype = np.dtype([
+        ('iteration', '<u4'),
+        ('best_score', value),
+        ('best_position', value, (d,)),
+        ('positions', value, (d, n)),
+        ('velocities', value, (d, n)),
+    ])
+    assert record_dtype.itemsize == header['record_size']
+    # The last record may be incomplete if the run was interrupted
+    n_records = (os.path.getsize(path) - header['header_size']) // record_dtype.itemsize
+    records = np.memmap(path, dtype=record_dtype, mode='r', offset=int(header['header_size']), shape=(n_records,))
+    return header, records
+
+
+def to_float(header, values):
+    """Convert raw values to floats."""
+    if header['encoding'] == ENCODING_FIXED32:
+        return values / float(1 << int(header['frac_bits']))
+    return np.asarray(values, dtype=np.float64)
+
+
+def undelta(header, values):
+    """Recover the positions or velocities of delta-encoded records, by summing the differences."""
+    if header['flags'] & FLAG_DELTA:
+        # Same type as the writer, so that the sums are the same as the ones it did
+        return np.cumsum(values, axis=0, dtype=values.dtype)
+    return values
+
+
+COST_FUNCS = {'f1': cost_func_1, 'f2': cost_func_2, 'rosenbrock': cost_func_rosenbrock}
+
+path = sys.argv[1] if len(sys.argv) > 1 else 'trajectory.bin'
+header, records = read_trajectory(path)
+# The frames are converted when drawn, so that only the delta-encoded files are read whole
+positions = undelta(header, records['positions'])
+velocities = undelta(header, records['velocities'])
+function = header['function'].decode()
+
+x = np.linspace(header['b_lo'], header['b_up'], 100)
+y = np.linspace(header['b_lo'], header['b_up'], 100)
 
 X, Y = np.meshgrid(x, y)
-func_name = eval('cost_func_' + str(int(info[0,1])))
-Z = func_name(X, Y)
+Z = COST_FUNCS[function](X, Y)
 
 fig, ax = plt.subplots(figsize=(9, 7))
 contour = ax.contour(X, Y, Z, levels=80, cmap='gnuplot')
 
 arrow_scale = 0.001
 
-init_particles = info[info[:, 0] == 0]
-scatter = ax.scatter(init_particles[:-2, 2], init_particles[:-2, 3], label='Particles')
-scatter_swarm = ax.scatter(init_particles[-2, 2], init_particles[-2, 3], c='r', label='Swarm Best Position')
-quiver = ax.quiver(init_particles[:-2, 2], init_particles[:-2, 3], init_particles[:-2, 4], init_particles[:-2, 5], angles='xy', width=0.002, headwidth=3, headlength=4)
+# Only the first two dimensions are drawn
+init_positions = to_float(header, positions[0, :2])
+init_velocities = to_float(header, velocities[0, :2])
+init_best = to_float(header, records['best_position'][0, :2])
+scatter = ax.scatter(init_positions[0], init_positions[1], label='Particles')
+scatter_swarm = ax.scatter(init_best[0], init_best[1], c='r', label='Swarm Best Position')
+quiver = ax.quiver(init_positions[0], init_positions[1], init_velocities[0], init_velocities[1], angles='xy', width=0.002, headwidth=3, headlength=4)
 
 iter_text = plt.text(0, -4.7, '', ha='center', fontsize=10, zorder=101)
 iter_rect = patches.Rectangle((-1, -4.9), 2, 0.6, ec="gray", fc="white", alpha=0.8, zorder=100)
@@ -40,26 +121,28 @@ ax.add_patch(score_rect)
 
 
 def update(i):
-    particles = info[info[:, 0] == i]
-    positions = particles[:-2, 2:4]
+    particles = to_float(header, positions[i, :2]).T
+    particle_velocities = to_float(header, velocities[i, :2])
+    best_position = to_float(header, records['best_position'][i, :2])
+    best_score = to_float(header, records['best_score'][i])
     # Update scatter plot data
-    scatter.set_offsets(positions)
-    scatter_swarm.set_offsets(particles[-2, 2:4])
+    scatter.set_offsets(particles)
+    scatter_swarm.set_offsets(best_position)
     # Update quiver plot data
-    quiver.set_offsets(positions)
-    quiver.set_UVC(arrow_scale * particles[:-2, 4], arrow_scale * particles[:-2, 5])
+    quiver.set_offsets(particles)
+    quiver.set_UVC(arrow_scale * particle_velocities[0], arrow_scale * particle_velocities[1])
 
-    iter_text.set_text('Iteration: ' + str(int(i)))
-    score_text.set_text(f'Best Score:\n{particles[-1, 2]}\nat ({particles[-2, 2]}, {particles[-2, 3]})')
+    iter_text.set_text('Iteration: ' + str(int(records['iteration'][i])))
+    score_text.set_text(f'Best Score:\n{best_score}\nat ({best_position[0]}, {best_position[1]})')
 
     return scatter, scatter_swarm, quiver, iter_text, score_text
 
-ani = FuncAnimation(fig, update, frames=int(info[0,3]), interval=100, blit=True)
+ani = FuncAnimation(fig, update, frames=len(records), interval=100, blit=True)
 
-plt.title(f'Particle Swarm Optimization: cost function {int(info[0, 1])}\nParticles: {int(info[0, 2])}  -  Iterations: {int(info[0,3])}')
+plt.title(f'Particle Swarm Optimization: cost function {function}\nParticles: {header["n_particles"]}  -  Iterations: {header["n_iterations"]}')
 plt.xlabel('x')
 plt.ylabel('y')
 plt.legend(loc='upper left')
 plt.colorbar(contour)
 plt.show()
-# ani.save('animation.gif', writer='pillow', fps=10)
\ No newline at end of file
+# ani.save('animation.gif', writer='pillow', fps=10)